@@ -4,9 +4,16 @@
 #include "GridMapModel.h"
 
 #include "GridPathFinding.h"
+#include "GridPathFindingNavMesh.h"
 #include "GridPathFindingSettings.h"
 #include "HGTypes.h"
 #include "WaitGroupManager.h"
+#include "Async/ParallelFor.h"
+#include "Misc/CoreDelegates.h"
+#include "PathFinding/GridAStar.h"
+#include "PathFinding/GridBidirectionalAStar.h"
+#include "PathFinding/GridPathTelemetry.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
 
 UGridMapModel::UGridMapModel()
 {
@@ -28,36 +35,35 @@ void UGridMapModel::BeginDestroy()
 		}
 		BuildTilesDataTask.Reset();
 	}
+	FCoreDelegates::OnEndFrame.Remove(NavSnapshotEndFrameHandle);
+	NavSnapshotEndFrameHandle.Reset();
+	FCoreDelegates::OnEndFrame.Remove(LandmarksEndFrameHandle);
+	LandmarksEndFrameHandle.Reset();
+
 	UObject::BeginDestroy();
 }
 
-void UGridMapModel::BuildTilesData(const FGridMapConfig& InMapConfig,
-                                   const TMap<FHCubeCoord, FSerializableTile>& InTilesData)
+void UGridMapModel::AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector)
 {
-	IsBuilding = true;
-	MapConfig = InMapConfig;
-	
-	// 初始化缓存的边界值
-	CachedRowStart = -FMath::FloorToInt(MapConfig.MapSize.X / 2.f);
-	CachedRowEnd = FMath::CeilToInt(MapConfig.MapSize.X / 2.f);
-	CachedColumnStart = -FMath::FloorToInt(MapConfig.MapSize.Y / 2.f);
-	CachedColumnEnd = FMath::CeilToInt(MapConfig.MapSize.Y / 2.f);
-	
-	SixDirections.DirVectors.Empty();
-	if (MapConfig.MapType == EGridMapType::RECTANGLE_SIX_DIRECTION || MapConfig.MapType == EGridMapType::HEX_STANDARD)
+	// 按FTileEnvData的反射信息上报； StandingActors保存的是弱引用， 不需要上报
+	// RefLink为空且没有自定义AddStructReferencedObjects时结构体中没有强引用， 不必在每次GC时遍历整张地图
+	const UScriptStruct* EnvDataStruct = FTileEnvData::StaticStruct();
+	if (EnvDataStruct->RefLink != nullptr || (EnvDataStruct->StructFlags & STRUCT_AddStructReferencedObjects) != 0)
 	{
-		auto SimulateCoord = FHCubeCoord(0, 0, 0);
-		auto SimulateCoordPosition = StableCoordToWorld(SimulateCoord);
-		for (int32 i = 0; i < 6; ++i)
+		UGridMapModel* This = CastChecked<UGridMapModel>(InThis);
+		This->TileEnvDataMap.ForEach([InThis, EnvDataStruct, &Collector](const FHCubeCoord& Coord, FTileEnvData& EnvData)
 		{
-			const auto& Direction = SixDirections.Directions[i];
-			auto DirectionPosition = StableCoordToWorld(SimulateCoord + Direction);
-			SixDirections.DirVectors.Add(DirectionPosition - SimulateCoordPosition);
-		}
+			Collector.AddPropertyReferencesWithStructARO(EnvDataStruct, &EnvData, InThis);
+		});
 	}
 
-	// 构造寻路缓存数据
-	BuildPathFindingCache();
+	Super::AddReferencedObjects(InThis, Collector);
+}
+
+void UGridMapModel::BuildTilesData(const FGridMapConfig& InMapConfig,
+                                   const TMap<FHCubeCoord, FSerializableTile>& InTilesData)
+{
+	PrepareTilesDataBuild(InMapConfig);
 
 	// Todo: 这里存在严重的异步问题, 启动游戏时, 有时会导致地图无法加载
 	// 终止上一个可能正在运行的异步任务
@@ -86,18 +92,24 @@ void UGridMapModel::BuildTilesData(const FGridMapConfig& InMapConfig,
 
 	// 创建临时数组，用于异步填充
 	auto TempTilesPtr = MakeShared<TArray<FTileInfo>>();
-	auto TempEnvDataPtr = MakeShared<TMap<FHCubeCoord, FTileEnvData>>();
+	auto TempEnvDataPtr = MakeShared<TGridTileMap<FTileEnvData>>();
 	TempTilesPtr->Reserve(GetMaxValidIndex());
-	TempEnvDataPtr->Reserve(GetMaxValidIndex());
+	if (HasDenseTileIndex())
+	{
+		TempEnvDataPtr->Reserve(GetMaxValidIndex() + 1);
+	}
 
 	// TempEnvDataPtr填充格子大小的Coord数量
 	StableForEachMapGrid([this, TempEnvDataPtr, TempTilesPtr](const FHCubeCoord& Coord, int32 Row, int32 Column)
 	{
 		TempTilesPtr->Add(FTileInfo(Coord));
-		TempEnvDataPtr->Add(Coord, FTileEnvData());
+		TempEnvDataPtr->Add(GetDenseTileIndex(Coord), Coord, FTileEnvData());
 	});
 
 	auto GSettings = GetDefault<UGridPathFindingSettings>();
+	PathCache.SetMaxEntries(GSettings->PathCacheMaxEntries);
+	PathCache.Reset();
+
 	TempEnvTypes.Empty();
 	for (const auto& EnvType : GSettings->EnvironmentTypes)
 	{
@@ -127,6 +139,7 @@ void UGridMapModel::BuildTilesData(const FGridMapConfig& InMapConfig,
 			TileEnvDataMap = MoveTemp(*TempEnvDataPtr);
 			UE_LOG(LogGridPathFinding, Log, TEXT("BuildTilesData completed successfully with %d tiles, EnvData Num: %d"),
 			       Tiles.Num(), TileEnvDataMap.Num());
+			FinishTilesDataBuild();
 
 			// 打印各个Tile的Cost
 			// for (const auto& Tile : Tiles)
@@ -141,6 +154,11 @@ void UGridMapModel::BuildTilesData(const FGridMapConfig& InMapConfig,
 
 		// 触发地图数据更新完成事件
 		IsBuilding = false;
+		if (GetDefault<UGridPathFindingSettings>()->bPublishNavSnapshots)
+		{
+			// 构建期间PublishNavSnapshot不做处理， 构建完成后立即发布， 不等到帧结束
+			PublishNavSnapshot();
+		}
 		TempEnvTypes.Empty();
 		OnTilesDataBuildComplete.Broadcast();
 	};
@@ -153,13 +171,201 @@ void UGridMapModel::BuildTilesData(const FGridMapConfig& InMapConfig,
 	BuildTilesDataTask->StartBackgroundTask();
 }
 
+void UGridMapModel::FinishTilesDataBuild()
+{
+	TileStore.Initialize(Tiles);
+	++TopologyVersion;
+	HierarchicalPathFinder.Initialize(*this);
+	const UGridPathFindingSettings* Settings = GetDefault<UGridPathFindingSettings>();
+	for (const int32 Identifier : Settings->CostLayerIdentifiers)
+	{
+		CostLayers.BuildLayer(*this, Identifier);
+	}
+	if (Settings->bEnableConnectivityCheck)
+	{
+		Connectivity.Build(*this);
+	}
+	if (Settings->LandmarkMemoryBudgetKB > 0)
+	{
+		Landmarks.Build(*this, Settings->LandmarkMemoryBudgetKB, Settings->MaxLandmarkCount, Settings->LandmarkIdentifier);
+		if (Landmarks.IsBuilt() && !LandmarksEndFrameHandle.IsValid())
+		{
+			LandmarksEndFrameHandle = FCoreDelegates::OnEndFrame.AddUObject(this, &UGridMapModel::FlushLandmarkRepairs);
+		}
+	}
+	SightBlockingEnvTypes.Reset();
+	for (const auto& EnvType : Settings->EnvironmentTypes)
+	{
+		const UGridEnvironmentType* LoadedEnvType = EnvType.LoadSynchronous();
+		if (LoadedEnvType && LoadedEnvType->bBlocksSight)
+		{
+			SightBlockingEnvTypes.Add(LoadedEnvType->TypeID);
+		}
+	}
+	FieldOfView.SetMaxCacheEntries(Settings->FieldOfViewCacheMaxEntries);
+	FieldOfView.Build(*this);
+	if (Settings->bPublishNavSnapshots && !NavSnapshotEndFrameHandle.IsValid())
+	{
+		NavSnapshotEndFrameHandle = FCoreDelegates::OnEndFrame.AddUObject(this, &UGridMapModel::PublishNavSnapshot);
+	}
+}
+
+void UGridMapModel::BuildBlankTilesData(const FGridMapConfig& InMapConfig)
+{
+	if (BuildTilesDataTask.IsValid() && !BuildTilesDataTask->IsDone())
+	{
+		UE_LOG(LogGridPathFinding, Warning, TEXT("[BuildBlankTilesData] 异步构建任务进行中, 忽略"));
+		return;
+	}
+
+	PrepareTilesDataBuild(InMapConfig);
+
+	{
+		FScopeLock Lock(&TilesLock);
+		Tiles.Empty(GetMaxValidIndex() + 1);
+		TileEnvDataMap.Reset();
+		if (HasDenseTileIndex())
+		{
+			TileEnvDataMap.Reserve(GetMaxValidIndex() + 1);
+		}
+		StableForEachMapGrid([this](const FHCubeCoord& Coord, int32 Row, int32 Column)
+		{
+			Tiles.Add(FTileInfo(Coord));
+			TileEnvDataMap.Add(GetDenseTileIndex(Coord), Coord, FTileEnvData());
+		});
+
+		auto GSettings = GetDefault<UGridPathFindingSettings>();
+		PathCache.SetMaxEntries(GSettings->PathCacheMaxEntries);
+		PathCache.Reset();
+
+		FinishTilesDataBuild();
+	}
+
+	IsBuilding = false;
+	if (GetDefault<UGridPathFindingSettings>()->bPublishNavSnapshots)
+	{
+		PublishNavSnapshot();
+	}
+	OnTilesDataBuildComplete.Broadcast();
+}
+
+void UGridMapModel::SetMapConfig(const FGridMapConfig& InMapConfig)
+{
+	MapConfig = InMapConfig;
+	UpdateTileIndexMapping();
+
+	// 格子Index随配置变化， 按新的Index重新放置以坐标记录的数据
+	const auto GetIndex = [this](const FHCubeCoord& Coord) { return GetDenseTileIndex(Coord); };
+	StandingActors.Rebuild(GetIndex);
+	TileEnvDataMap.Rebuild(GetIndex);
+	Coord2TokenIDsMap.Rebuild(GetIndex);
+}
+
+void UGridMapModel::PrepareTilesDataBuild(const FGridMapConfig& InMapConfig)
+{
+	IsBuilding = true;
+	MapConfig = InMapConfig;
+	UpdateTileIndexMapping();
+
+	// 地图配置变化后格子Index随之变化， 按新的Index重新放置以坐标记录的数据
+	const auto GetIndex = [this](const FHCubeCoord& Coord) { return GetDenseTileIndex(Coord); };
+	StandingActors.Rebuild(GetIndex);
+	Coord2TokenIDsMap.Rebuild(GetIndex);
+
+	// 构造寻路缓存数据
+	BuildPathFindingCache();
+	HierarchicalPathFinder.Reset();
+	Connectivity.Reset();
+	Landmarks.Reset();
+	CostLayers.Reset();
+	FieldOfView.Reset();
+	TileStore.Reset();
+	NavSnapshotDirtyTiles.Reset();
+	{
+		FScopeLock Lock(&NavSnapshotLock);
+		NavSnapshot.Reset();
+	}
+}
+
+void UGridMapModel::UpdateTileIndexMapping()
+{
+	// 初始化缓存的边界值
+	CachedRowStart = -FMath::FloorToInt(MapConfig.MapSize.X / 2.f);
+	CachedRowEnd = FMath::CeilToInt(MapConfig.MapSize.X / 2.f);
+	CachedColumnStart = -FMath::FloorToInt(MapConfig.MapSize.Y / 2.f);
+	CachedColumnEnd = FMath::CeilToInt(MapConfig.MapSize.Y / 2.f);
+
+	PathTopology = EGridPathTopology::Generic;
+	if (MapConfig.DrawMode == EGridMapDrawMode::BaseOnRowColumn)
+	{
+		switch (MapConfig.MapType)
+		{
+		case EGridMapType::HEX_STANDARD:
+		case EGridMapType::RECTANGLE_SIX_DIRECTION:
+			PathTopology = MapConfig.TileOrientation == ETileOrientationFlag::FLAT ? EGridPathTopology::HexFlat : EGridPathTopology::HexPointy;
+			break;
+		default:
+			break;
+		}
+	}
+	else if (MapConfig.DrawMode == EGridMapDrawMode::BaseOnRadius &&
+		(MapConfig.MapType == EGridMapType::HEX_STANDARD || MapConfig.MapType == EGridMapType::RECTANGLE_SIX_DIRECTION))
+	{
+		PathTopology = EGridPathTopology::HexRadius;
+	}
+	else if (MapConfig.DrawMode == EGridMapDrawMode::BaseOnVolume &&
+		(MapConfig.MapType == EGridMapType::HEX_STANDARD || MapConfig.MapType == EGridMapType::RECTANGLE_SIX_DIRECTION))
+	{
+		PathTopology = EGridPathTopology::HexVolume;
+	}
+	
+	SixDirections.DirVectors.Empty();
+	if (MapConfig.MapType == EGridMapType::RECTANGLE_SIX_DIRECTION || MapConfig.MapType == EGridMapType::HEX_STANDARD)
+	{
+		auto SimulateCoord = FHCubeCoord(0, 0, 0);
+		auto SimulateCoordPosition = StableCoordToWorld(SimulateCoord);
+		for (int32 i = 0; i < 6; ++i)
+		{
+			const auto& Direction = SixDirections.Directions[i];
+			auto DirectionPosition = StableCoordToWorld(SimulateCoord + Direction);
+			SixDirections.DirVectors.Add(DirectionPosition - SimulateCoordPosition);
+		}
+	}
+
+	// 框选地图的格子由PlaceVolumes与SubtractVolumes决定， 按页分配连续的Index
+	// BuildVolumeTileIndex通过StableWorldToCoord求Volume的坐标范围， RECTANGLE_SIX_DIRECTION地图需要上面的SixDirections.DirVectors
+	PagedTileIndex.Reset();
+	if (PathTopology == EGridPathTopology::HexVolume)
+	{
+		BuildVolumeTileIndex();
+	}
+
+	// 半径地图的Index到坐标需要开平方， 预先按Index顺序记录坐标
+	RadiusIndexToAxial.Reset();
+	if (MapConfig.DrawMode == EGridMapDrawMode::BaseOnRadius)
+	{
+		const int32 Radius = MapConfig.MapRadius;
+		RadiusIndexToAxial.Reserve(FGridHexRadiusTopology::GetTileCount(Radius));
+		for (int32 Q = -Radius; Q <= Radius; ++Q)
+		{
+			for (int32 R = FMath::Max(-Radius, -Q - Radius); R <= FMath::Min(Radius, -Q + Radius); ++R)
+			{
+				RadiusIndexToAxial.Add(FIntPoint(Q, R));
+			}
+		}
+	}
+}
+
 void UGridMapModel::UpdateTileEnv(const FSerializableTile& InTileData, bool bNotify)
 {
-	FTileEnvData OldTileEnv = TileEnvDataMap[InTileData.Coord];
-	TileEnvDataMap[InTileData.Coord] = InTileData.TileEnvData;
+	FTileEnvData* TileEnv = TileEnvDataMap.Find(GetDenseTileIndex(InTileData.Coord), InTileData.Coord);
+	check(TileEnv);
+	FTileEnvData OldTileEnv = *TileEnv;
+	*TileEnv = InTileData.TileEnvData;
+	MarkTileNavDataDirty(StableGetFullMapGridIterIndex(InTileData.Coord));
 	if (bNotify)
 	{
-		OnTileEnvModify.Broadcast(InTileData.Coord, OldTileEnv, TileEnvDataMap[InTileData.Coord]);
+		OnTileEnvModify.Broadcast(InTileData.Coord, OldTileEnv, *TileEnv);
 	}
 }
 
@@ -176,6 +382,8 @@ void UGridMapModel::UpdateTileHeight(const FHCubeCoord& InCoord, float NewHeight
 	auto& TileInfo = Tiles[Index];
 	auto OldHeight = TileInfo.Height;
 	TileInfo.Height = NewHeight;
+	TileStore.SetHeight(Index, NewHeight);
+	MarkTileNavDataDirty(Index);
 	if (bNotify)
 	{
 		OnTileHeightModify.Broadcast(InCoord, OldHeight, TileInfo.Height);
@@ -184,10 +392,10 @@ void UGridMapModel::UpdateTileHeight(const FHCubeCoord& InCoord, float NewHeight
 
 TArray<TObjectPtr<ATokenActor>> UGridMapModel::GetTokensInCoord(const FHCubeCoord& InCoord)
 {
-	if (Coord2TokenIDsMap.Contains(InCoord))
+	if (const TArray<int32>* TokenIDs = Coord2TokenIDsMap.Find(GetDenseTileIndex(InCoord), InCoord))
 	{
 		TArray<TObjectPtr<ATokenActor>> Tokens;
-		for (int32 TokenID : Coord2TokenIDsMap[InCoord])
+		for (int32 TokenID : *TokenIDs)
 		{
 			if (TokenMap.Contains(TokenID))
 			{
@@ -202,9 +410,9 @@ TArray<TObjectPtr<ATokenActor>> UGridMapModel::GetTokensInCoord(const FHCubeCoor
 
 ATokenActor* UGridMapModel::GetTokenByIndex(const FHCubeCoord& InCoord, int32 InTokenIndex, bool bErrorIfNotExist)
 {
-	if (Coord2TokenIDsMap.Contains(InCoord))
+	if (const TArray<int32>* TokenIDs = Coord2TokenIDsMap.Find(GetDenseTileIndex(InCoord), InCoord))
 	{
-		const auto& Tokens = Coord2TokenIDsMap[InCoord];
+		const auto& Tokens = *TokenIDs;
 		if (InTokenIndex >= 0 && InTokenIndex < Tokens.Num())
 		{
 			return TokenMap[Tokens[InTokenIndex]];
@@ -232,13 +440,9 @@ void UGridMapModel::AppendToken(const FHCubeCoord& InCoord, ATokenActor* InToken
 		return;
 	}
 
-	if (!Coord2TokenIDsMap.Contains(InCoord))
-	{
-		Coord2TokenIDsMap.Add(InCoord, TArray<int32>());
-	}
-
 	TokenMap.Add(InTokenActor->GetTokenID(), InTokenActor);
-	Coord2TokenIDsMap[InCoord].Add(InTokenActor->GetTokenID());
+	Coord2TokenIDsMap.FindOrAdd(GetDenseTileIndex(InCoord), InCoord).Add(InTokenActor->GetTokenID());
+	MarkTileSightDirty(StableGetFullMapGridIterIndex(InCoord));
 
 	if (CallGameplayInit)
 	{
@@ -257,18 +461,20 @@ void UGridMapModel::RemoveAndDestroyToken(const FHCubeCoord& InCoord, ATokenActo
 	InTokenActor->OnRemoveFromMap.Broadcast(InTokenActor);
 	TokenMap.Remove(InTokenActor->GetTokenID());
 
-	if (Coord2TokenIDsMap.Contains(InCoord))
+	const int32 DenseIndex = GetDenseTileIndex(InCoord);
+	if (TArray<int32>* TokenIDs = Coord2TokenIDsMap.Find(DenseIndex, InCoord))
 	{
-		int32 RemovedNum = Coord2TokenIDsMap[InCoord].Remove(InTokenActor->GetTokenID());
+		int32 RemovedNum = TokenIDs->Remove(InTokenActor->GetTokenID());
 
 		if (RemovedNum > 0)
 		{
 			InTokenActor->Destroy();
 			// 如果移除后该坐标下没有Token了，则清理该坐标的记录
-			if (Coord2TokenIDsMap[InCoord].Num() == 0)
+			if (TokenIDs->Num() == 0)
 			{
-				Coord2TokenIDsMap.Remove(InCoord);
+				Coord2TokenIDsMap.Remove(DenseIndex, InCoord);
 			}
+			MarkTileSightDirty(StableGetFullMapGridIterIndex(InCoord));
 			return;
 		}
 		
@@ -287,7 +493,11 @@ void UGridMapModel::RemoveAndDestroyAllTokens()
 		Pair.Value->Destroy();
 	}
 	TokenMap.Empty();
-	Coord2TokenIDsMap.Empty();
+	Coord2TokenIDsMap.Reset();
+	if (FieldOfView.IsBuilt())
+	{
+		FieldOfView.Build(*this);
+	}
 	UE_LOG(LogGridPathFinding, Log, TEXT("已清除地图上所有的Token"));
 }
 
@@ -306,9 +516,11 @@ void UGridMapModel::UpdateStandingActor(const FHCubeCoord& OldCoord, const FHCub
 {
 	if (OldCoord != FHCubeCoord::Invalid)
 	{
-		check(StandingActors.Contains(OldCoord));
-		check(StandingActors[OldCoord] == InActor);
-		StandingActors.Remove(OldCoord);
+		const int32 OldIndex = GetDenseTileIndex(OldCoord);
+		check(StandingActors.Contains(OldIndex, OldCoord));
+		check(*StandingActors.Find(OldIndex, OldCoord) == InActor);
+		StandingActors.Remove(OldIndex, OldCoord);
+		MarkTileNavDataDirty(StableGetFullMapGridIterIndex(OldCoord));
 	}
 
 	if (NewCoord == FHCubeCoord::Invalid)
@@ -316,17 +528,20 @@ void UGridMapModel::UpdateStandingActor(const FHCubeCoord& OldCoord, const FHCub
 		return;
 	}
 
-	StandingActors.Add(NewCoord, InActor);
+	StandingActors.Add(GetDenseTileIndex(NewCoord), NewCoord, InActor);
+	MarkTileNavDataDirty(StableGetFullMapGridIterIndex(NewCoord));
 }
 
 void UGridMapModel::RemoveStandingActor(AActor* InActor)
 {
 	auto Coord = StableWorldToCoord(InActor->GetActorLocation());
-	if (StandingActors.Contains(Coord))
+	const int32 DenseIndex = GetDenseTileIndex(Coord);
+	if (const TWeakObjectPtr<AActor>* StandingActor = StandingActors.Find(DenseIndex, Coord))
 	{
-		if (StandingActors[Coord] == InActor)
+		if (*StandingActor == InActor)
 		{
-			StandingActors.Remove(Coord);
+			StandingActors.Remove(DenseIndex, Coord);
+			MarkTileNavDataDirty(StableGetFullMapGridIterIndex(Coord));
 		}
 		else
 		{
@@ -346,9 +561,9 @@ void UGridMapModel::IntervalDeserializeTokens(const FHCubeCoord& InCoord,
 	// 清空当前的
 	if (Clear)
 	{
-		if (Coord2TokenIDsMap.Contains(InCoord))
+		if (TArray<int32>* ExistingTokenIDs = Coord2TokenIDsMap.Find(GetDenseTileIndex(InCoord), InCoord))
 		{
-			auto& ExistingTokens = Coord2TokenIDsMap[InCoord];
+			auto& ExistingTokens = *ExistingTokenIDs;
 			for (auto TokenActorID : ExistingTokens)
 			{
 				if (TokenMap.Contains(TokenActorID))
@@ -357,7 +572,7 @@ void UGridMapModel::IntervalDeserializeTokens(const FHCubeCoord& InCoord,
 					TokenMap.Remove(TokenActorID);
 				}
 			}
-			Coord2TokenIDsMap[InCoord].Empty();
+			ExistingTokens.Empty();
 		}
 	}
 
@@ -399,136 +614,803 @@ void UGridMapModel::IntervalDeserializeTokens(const FHCubeCoord& InCoord,
 		}
 	}
 
-	TArray<int32> TokenIDs;
-	for (auto TokenActor : TokenActors)
+	TArray<int32> TokenIDs;
+	for (auto TokenActor : TokenActors)
+	{
+		TokenMap.Add(TokenActor->GetTokenID(), TokenActor);
+		TokenIDs.Add(TokenActor->GetTokenID());
+	}
+	
+	Coord2TokenIDsMap.Add(GetDenseTileIndex(InCoord), InCoord, TokenIDs);
+}
+
+void UGridMapModel::BlockTileOnce(const FVector& InLocation)
+{
+	auto Coord = StableWorldToCoord(InLocation);
+	BlockTileOnce(Coord);
+}
+
+void UGridMapModel::BlockTileOnce(const FHCubeCoord& InCoord)
+{
+	auto Index = StableGetFullMapGridIterIndex(InCoord);
+
+	if (!Tiles.IsValidIndex(Index))
+	{
+		UE_LOG(LogGridPathFinding, Error, TEXT("[UpdateTileInfo] Invalid tile index: %d for coord %s"),
+			   Index, *InCoord.ToString());
+		return;
+	}
+
+
+	auto& TileInfo = Tiles[Index];
+	TileInfo.AddBlockOnce();
+	TileStore.AddBlock(Index);
+	MarkTileNavDataDirty(Index);
+}
+
+void UGridMapModel::UnBlockTileOnce(const FVector& InLocation)
+{
+	auto Coord = StableWorldToCoord(InLocation);
+	UnBlockTileOnce(Coord);
+}
+
+void UGridMapModel::UnBlockTileOnce(const FHCubeCoord& InCoord, bool bWarning)
+{
+	auto Index = StableGetFullMapGridIterIndex(InCoord);
+
+	if (!Tiles.IsValidIndex(Index))
+	{
+		if (bWarning)
+		{
+			UE_LOG(LogGridPathFinding, Error, TEXT("[UpdateTileInfo] Invalid tile index: %d for coord %s"),
+			       Index, *InCoord.ToString());
+		}
+		return;
+	}
+
+
+	auto& TileInfo = Tiles[Index];
+	TileInfo.RemoveBlockOnce();
+	TileStore.RemoveBlock(Index);
+	MarkTileNavDataDirty(Index);
+}
+
+void UGridMapModel::SetTileCustomData(const FHCubeCoord& InCoord, const FName& Key, const FString& Value)
+{
+	auto Index = StableGetFullMapGridIterIndex(InCoord);
+	if (!TileStore.IsValidIndex(Index))
+	{
+		return;
+	}
+
+	TileStore.FindOrAddCustomData(Index).Add(Key, Value);
+}
+
+const FString& UGridMapModel::GetTileCustomData(const FHCubeCoord& InCoord, const FName& Key)
+{
+	auto Index = StableGetFullMapGridIterIndex(InCoord);
+	const TMap<FName, FString>* CustomDataMap = TileStore.IsValidIndex(Index) ? TileStore.FindCustomData(Index) : nullptr;
+	if (CustomDataMap)
+	{
+		if (const FString* Value = CustomDataMap->Find(Key))
+		{
+			return *Value;
+		}
+	}
+
+	static FString EmptyString;
+	return EmptyString;
+}
+
+int32 UGridMapModel::GetTileHeight(int32 TileIndex)
+{
+	if (TileStore.IsValidIndex(TileIndex))
+	{
+		return TileStore.GetHeight(TileIndex);
+	}
+
+	UE_LOG(LogGridPathFinding, Error, TEXT("[GetTileHeight] Invalid tile index: %d"), TileIndex);
+	return 0;
+}
+
+bool UGridMapModel::CanTravelTo(int32 FromIndex, int32 ToIndex)
+{
+	// 如果该格子上有StandingActor，如果希望阻塞格子， 那么在UpdateStandingActor时可以通过重写增加Tile的BlockCount
+	// 只读取打包的阻挡位， 不访问完整的FTileInfo
+	return !TileStore.IsBlocked(ToIndex); // 如果BlockCount大于0，表示该格子被阻塞
+}
+
+int32 UGridMapModel::GetTileHeight(const FHCubeCoord& InCoord)
+{
+	auto Index = StableGetFullMapGridIterIndex(InCoord);
+	return GetTileHeight(Index);
+}
+
+double UGridMapModel::GetTraversalCost(int Identifier, int32 FromIndex, int32 ToIndex)
+{
+	// 子类重写
+	return 1.f;
+}
+
+bool UGridMapModel::SupportsParallelPathQueries() const
+{
+	// 基类的实现只读取TileStore， 但无法确认子类的重写是否线程安全
+	return false;
+}
+
+void UGridMapModel::FillTileEdgeCosts(int32 Identifier, int32 TileIndex, TArrayView<float> OutEdgeCosts)
+{
+	for (int32 Direction = 0; Direction < OutEdgeCosts.Num(); ++Direction)
+	{
+		const int32 NeighbourIndex = GetNeighborIndex(TileIndex, Direction);
+		if (NeighbourIndex == INDEX_NONE || !CanTravelTo(TileIndex, NeighbourIndex))
+		{
+			OutEdgeCosts[Direction] = MAX_flt;
+			continue;
+		}
+
+		OutEdgeCosts[Direction] = static_cast<float>(1.f + GetTraversalCost(Identifier, TileIndex, NeighbourIndex));
+	}
+}
+
+void UGridMapModel::BuildCostLayer(int32 Identifier)
+{
+	if (IsBuilding)
+	{
+		UE_LOG(LogGridPathFinding, Warning, TEXT("[BuildCostLayer] 地图数据构建中, 忽略身份标识%d"), Identifier);
+		return;
+	}
+
+	CostLayers.BuildLayer(*this, Identifier);
+	++TopologyVersion;
+}
+
+void UGridMapModel::FindPathsBatch(TArrayView<FGridPathRequest> Requests)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UGridMapModel::FindPathsBatch);
+
+	if (IsBuilding)
+	{
+		UE_LOG(LogGridPathFinding, Warning, TEXT("[FindPathsBatch] 地图数据构建中, 忽略%d个寻路请求"), Requests.Num());
+		for (FGridPathRequest& Request : Requests)
+		{
+			Request.Result = SearchFail;
+			Request.PathIndices.Reset();
+			Request.PathCost = 0.f;
+		}
+		return;
+	}
+
+	// 每个工作线程使用自己的FGridSearchWorkspace, 地图数据在此期间只读
+	const EParallelForFlags ParallelForFlags = SupportsParallelPathQueries() ? EParallelForFlags::Unbalanced : EParallelForFlags::ForceSingleThread;
+	ParallelFor(Requests.Num(), [this, Requests](int32 RequestIndex)
+	{
+		FGridPathRequest& Request = Requests[RequestIndex];
+
+		const EGridPathSearchMode SearchMode = ResolveGridPathSearchMode(Request.SearchMode);
+
+		FGridPathFilter Filter(*this);
+		Filter.Identifier = Request.Identifier;
+		Filter.SearchMode = SearchMode;
+		Filter.StartIdx = Request.StartIndex;
+		Filter.EndIdx = Request.EndIndex;
+
+		const FGridPathCacheKey CacheKey(Request.StartIndex, Request.EndIndex, Request.Identifier, SearchMode);
+		if (PathCache.Find(CacheKey, TopologyVersion, Request.Result, Request.PathIndices, Request.PathCost))
+		{
+			return;
+		}
+
+		Request.Result = SearchPathIndices(Filter, Request.StartIndex, Request.EndIndex, Request.PathIndices, Request.PathCost);
+		PathCache.Add(CacheKey, TopologyVersion, Request.Result, Request.PathIndices, Request.PathCost);
+	}, ParallelForFlags);
+}
+
+EGraphAStarResult UGridMapModel::FindPathIndices(int32 StartIndex, int32 EndIndex, int32 Identifier, TArray<int32>& OutPathIndices,
+                                                float& OutPathCost, EGridPathSearchMode SearchMode)
+{
+	OutPathIndices.Reset();
+	OutPathCost = 0.f;
+
+	if (IsBuilding)
+	{
+		UE_LOG(LogGridPathFinding, Warning, TEXT("[FindPathIndices] 地图数据构建中, 忽略寻路请求"));
+		return SearchFail;
+	}
+
+	SearchMode = ResolveGridPathSearchMode(SearchMode);
+
+	EGraphAStarResult Result;
+	const FGridPathCacheKey CacheKey(StartIndex, EndIndex, Identifier, SearchMode);
+	if (PathCache.Find(CacheKey, TopologyVersion, Result, OutPathIndices, OutPathCost))
+	{
+		return Result;
+	}
+
+	FGridPathFilter Filter(*this);
+	Filter.Identifier = Identifier;
+	Filter.SearchMode = SearchMode;
+	Filter.StartIdx = StartIndex;
+	Filter.EndIdx = EndIndex;
+
+	Result = SearchPathIndices(Filter, StartIndex, EndIndex, OutPathIndices, OutPathCost);
+	PathCache.Add(CacheKey, TopologyVersion, Result, OutPathIndices, OutPathCost);
+	return Result;
+}
+
+EGraphAStarResult UGridMapModel::SearchPathIndices(const FGridPathFilter& Filter, int32 StartIndex, int32 EndIndex,
+                                                   TArray<int32>& OutPathIndices, float& OutPathCost, FGridPathQueryStats* OutStats)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UGridMapModel::SearchPathIndices);
+
+#if GRID_PATH_TELEMETRY
+	if (FGridPathTelemetry::IsEnabled())
+	{
+		FGridPathQueryStats Stats;
+		Stats.Identifier = Filter.Identifier;
+		const uint64 StartCycles = FPlatformTime::Cycles64();
+		Stats.Result = SearchPathIndicesInternal(Filter, StartIndex, EndIndex, OutPathIndices, OutPathCost, &Stats);
+		Stats.Microseconds = FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles) * 1000.0;
+		FGridPathTelemetry::RecordQuery(Stats);
+		if (OutStats)
+		{
+			*OutStats = Stats;
+		}
+		return Stats.Result;
+	}
+#endif
+
+	if (OutStats)
+	{
+		*OutStats = FGridPathQueryStats();
+		OutStats->Identifier = Filter.Identifier;
+		OutStats->Result = SearchPathIndicesInternal(Filter, StartIndex, EndIndex, OutPathIndices, OutPathCost, OutStats);
+		return OutStats->Result;
+	}
+
+	return SearchPathIndicesInternal(Filter, StartIndex, EndIndex, OutPathIndices, OutPathCost, nullptr);
+}
+
+EGraphAStarResult UGridMapModel::SearchPathIndicesInternal(const FGridPathFilter& Filter, int32 StartIndex, int32 EndIndex,
+                                                           TArray<int32>& OutPathIndices, float& OutPathCost, FGridPathQueryStats* OutStats)
+{
+	auto GSettings = GetDefault<UGridPathFindingSettings>();
+
+	if (GSettings->bEnableConnectivityCheck && Connectivity.IsBuilt() && !Connectivity.AreConnected(*this, StartIndex, EndIndex))
+	{
+		// 不在同一连通区域， 不需要搜索
+		OutPathIndices.Reset();
+		OutPathCost = 0.f;
+		if (OutStats)
+		{
+			OutStats->bRejectedByConnectivity = true;
+		}
+		return GoalUnreachable;
+	}
+
+	if (GSettings->bEnableHierarchicalPathFinding &&
+		HierarchicalPathFinder.ShouldUse(StartIndex, EndIndex, GSettings->HierarchicalPathFindingMinDistance))
+	{
+		if (HierarchicalPathFinder.TryFindPath(Filter, StartIndex, EndIndex, OutPathIndices, OutPathCost))
+		{
+			if (OutStats)
+			{
+				OutStats->bHierarchical = true;
+			}
+			return SearchSuccess;
+		}
+		// 抽象图上不可达时， 仍由完整的A*给出结果(包括部分路径)
+	}
+
+	// 每次查询只判断一次拓扑， 之后进入完全内联的模板实例
+	auto Search = [&Filter, StartIndex, EndIndex, &OutPathIndices, &OutPathCost, OutStats](const auto& TopologyFilter)
+	{
+		if (Filter.SearchMode == EGridPathSearchMode::Bidirectional)
+		{
+			FGridBidirectionalAStar Pathfinder;
+			const EGraphAStarResult Result = Pathfinder.FindPath(StartIndex, EndIndex, TopologyFilter, OutPathIndices);
+			OutPathCost = Result == SearchSuccess ? Pathfinder.GetPathCost() : 0.f;
+			if (OutStats)
+			{
+				OutStats->NumExpandedNodes = Pathfinder.GetNumExpandedNodes();
+				OutStats->PeakOpenNodes = Pathfinder.GetPeakOpenNodes();
+			}
+			return Result;
+		}
+
+		FGridAStar Pathfinder;
+		const EGraphAStarResult Result = Pathfinder.FindPath(StartIndex, EndIndex, TopologyFilter, OutPathIndices);
+		OutPathCost = Result == SearchSuccess ? Pathfinder.GetPathCost() : 0.f;
+		if (OutStats)
+		{
+			OutStats->NumExpandedNodes = Pathfinder.GetNumExpandedNodes();
+			OutStats->PeakOpenNodes = Pathfinder.GetPeakOpenNodes();
+		}
+		return Result;
+	};
+
+	switch (PathTopology)
+	{
+	case EGridPathTopology::HexFlat:
+		return Search(TGridPathFilter<FGridHexFlatTopology>(Filter));
+	case EGridPathTopology::HexPointy:
+		return Search(TGridPathFilter<FGridHexPointyTopology>(Filter));
+	case EGridPathTopology::HexRadius:
+		return Search(TGridPathFilter<FGridHexRadiusTopology>(Filter));
+	case EGridPathTopology::HexVolume:
+		return Search(TGridPathFilter<FGridHexVolumeTopology>(Filter));
+	default:
+		return Search(Filter);
+	}
+}
+
+void UGridMapModel::BuildFlowField(int32 GoalIndex, int32 Identifier, FGridFlowField& OutFlowField)
+{
+	OutFlowField.Identifier = Identifier;
+
+	if (IsBuilding)
+	{
+		// 保留终点并标记为过期， 构建完成后由RebuildStaleFlowFields重建
+		UE_LOG(LogGridPathFinding, Warning, TEXT("[BuildFlowField] 地图数据构建中, 流场标记为过期"));
+		OutFlowField.GoalIndex = GoalIndex;
+		OutFlowField.TopologyVersion = TopologyVersion - 1;
+		OutFlowField.Distances.Reset();
+		OutFlowField.Directions.Reset();
+		return;
+	}
+
+	OutFlowField.TopologyVersion = TopologyVersion;
+
+	FGridPathFilter Filter(*this);
+	Filter.Identifier = Identifier;
+	OutFlowField.Build(Filter, GoalIndex);
+}
+
+int32 UGridMapModel::RebuildStaleFlowFields(TArrayView<FGridFlowField> FlowFields)
+{
+	TArray<int32> StaleIndices;
+	for (int32 Index = 0; Index < FlowFields.Num(); ++Index)
+	{
+		if (FlowFields[Index].GoalIndex != INDEX_NONE && FlowFields[Index].TopologyVersion != TopologyVersion)
+		{
+			StaleIndices.Add(Index);
+		}
+	}
+
+	const EParallelForFlags ParallelForFlags = SupportsParallelPathQueries() ? EParallelForFlags::Unbalanced : EParallelForFlags::ForceSingleThread;
+	ParallelFor(StaleIndices.Num(), [this, FlowFields, &StaleIndices](int32 Index)
+	{
+		FGridFlowField& FlowField = FlowFields[StaleIndices[Index]];
+		BuildFlowField(FlowField.GoalIndex, FlowField.Identifier, FlowField);
+	}, ParallelForFlags);
+
+	return StaleIndices.Num();
+}
+
+/**
+ * FindPathToNearestGoal使用的Filter， 所有终点都由IsGoal判断， 启发值为到各个终点的最小距离
+ */
+struct FGridNearestGoalPathFilter : public FGridPathFilter
+{
+	FGridNearestGoalPathFilter(const FGridPathFilter& InFilter, const TBitArray<>& InGoalMask, TConstArrayView<int32> InGoals, bool bInUseHeuristic)
+		: FGridPathFilter(InFilter), GoalMask(InGoalMask), Goals(InGoals), bUseHeuristic(bInUseHeuristic)
+	{
+	}
+
+	FORCEINLINE bool IsGoal(const int32 NodeIndex) const
+	{
+		return GoalMask[NodeIndex];
+	}
+
+	FORCEINLINE FVector::FReal GetHeuristicCost(const int32 StartNodeRef, const int32 EndNodeRef) const
+	{
+		if (!bUseHeuristic)
+		{
+			return 0.0;
+		}
+
+		// 对每个终点都不高估， 第一个出堆的终点即为最近的终点
+		FVector::FReal MinHeuristic = TNumericLimits<FVector::FReal>::Max();
+		for (const int32 GoalIndex : Goals)
+		{
+			MinHeuristic = FMath::Min(MinHeuristic, FGridPathFilter::GetHeuristicCost(StartNodeRef, GoalIndex));
+		}
+		return MinHeuristic;
+	}
+
+	bool WantsPartialSolution() const
+	{
+		return false;
+	}
+
+	const TBitArray<>& GoalMask;
+	TConstArrayView<int32> Goals;
+	bool bUseHeuristic;
+};
+
+EGraphAStarResult UGridMapModel::FindPathToNearestGoal(int32 StartIndex, TConstArrayView<int32> GoalIndices, int32 Identifier,
+                                                      int32& OutGoalIndex, TArray<int32>& OutPathIndices, float& OutPathCost)
+{
+	OutGoalIndex = INDEX_NONE;
+	OutPathIndices.Reset();
+	OutPathCost = 0.f;
+
+	if (IsBuilding)
+	{
+		UE_LOG(LogGridPathFinding, Warning, TEXT("[FindPathToNearestGoal] 地图数据构建中, 忽略查询"));
+		return SearchFail;
+	}
+
+	FGridPathFilter Filter(*this);
+	Filter.Identifier = Identifier;
+
+	const int32 NodeCount = Filter.GetNodeCount();
+	if (StartIndex < 0 || StartIndex >= NodeCount)
+	{
+		return SearchFail;
+	}
+
+	// 不在同一连通区域的终点直接排除， 重复的终点通过位标记去除
+	const bool bCheckConnectivity = GetDefault<UGridPathFindingSettings>()->bEnableConnectivityCheck && Connectivity.IsBuilt();
+	TBitArray<> GoalMask(false, NodeCount);
+	TArray<int32, TInlineAllocator<MaxGoalsForHeuristic>> Goals;
+	for (const int32 GoalIndex : GoalIndices)
+	{
+		if (GoalIndex >= 0 && GoalIndex < NodeCount && !GoalMask[GoalIndex] &&
+			(!bCheckConnectivity || Connectivity.AreConnected(*this, StartIndex, GoalIndex)))
+		{
+			GoalMask[GoalIndex] = true;
+			Goals.Add(GoalIndex);
+		}
+	}
+
+	if (Goals.Num() == 0)
+	{
+		return GoalIndices.Num() > 0 ? GoalUnreachable : SearchFail;
+	}
+
+	const FGridNearestGoalPathFilter NearestGoalFilter(Filter, GoalMask, Goals, Goals.Num() <= MaxGoalsForHeuristic);
+	FGridAStar Pathfinder;
+	const EGraphAStarResult Result = Pathfinder.FindPath(StartIndex, Goals[0], NearestGoalFilter, OutPathIndices);
+	if (Result != SearchSuccess)
+	{
+		return Result;
+	}
+
+	OutGoalIndex = Pathfinder.GetReachedGoalIndex();
+	OutPathCost = Pathfinder.GetPathCost();
+	return SearchSuccess;
+}
+
+void UGridMapModel::FindReachableArea(int32 StartIndex, int32 Identifier, float MaxCost, FGridReachableArea& OutArea)
+{
+	OutArea.Reset();
+	OutArea.Identifier = Identifier;
+	OutArea.MaxCost = MaxCost;
+
+	if (IsBuilding)
+	{
+		UE_LOG(LogGridPathFinding, Warning, TEXT("[FindReachableArea] 地图数据构建中, 忽略查询"));
+		return;
+	}
+
+	FGridPathFilter Filter(*this);
+	Filter.Identifier = Identifier;
+
+	const int32 NodeCount = Filter.GetNodeCount();
+	if (StartIndex < 0 || StartIndex >= NodeCount || MaxCost < 0.f)
+	{
+		return;
+	}
+
+	OutArea.StartIndex = StartIndex;
+
+	// 每一步的Cost至少为1， 可达范围不会超过MaxCost步， 也不会超过到地图边界的距离
+	int32 MaxSteps = GetMaxDistanceToBoundary(StableGetCoordByIndex(StartIndex));
+	if (MaxCost < MaxSteps)
+	{
+		MaxSteps = FMath::FloorToInt(MaxCost);
+	}
+	const int64 EstimatedNum = FMath::Min<int64>(NodeCount, 3ll * MaxSteps * (static_cast<int64>(MaxSteps) + 1) + 1);
+	OutArea.TileIndices.Reserve(EstimatedNum);
+	OutArea.Costs.Reserve(EstimatedNum);
+	OutArea.PredecessorIndices.Reserve(EstimatedNum);
+	OutArea.EntryIndices.Reserve(EstimatedNum);
+
+	FGridSearchWorkspace& Workspace = FGridSearchWorkspace::GetThreadLocal();
+	const FGridSearchWorkspace::FOpenNodePredicate Predicate;
+	Workspace.BeginSearch(NodeCount);
+	Workspace.Visit(StartIndex, 0.f, INDEX_NONE);
+	Workspace.OpenHeap.HeapPush({0.f, StartIndex}, Predicate);
+
+	while (Workspace.OpenHeap.Num() > 0)
+	{
+		FGridSearchWorkspace::FOpenNode Current;
+		Workspace.OpenHeap.HeapPop(Current, Predicate, EAllowShrinking::No);
+
+		const int32 CurrentIndex = Current.NodeIndex;
+		if (Workspace.IsClosed(CurrentIndex))
+		{
+			continue;
+		}
+
+		Workspace.Close(CurrentIndex);
+		const float CurrentG = Workspace.GScores[CurrentIndex];
+		OutArea.Add(CurrentIndex, CurrentG, Workspace.ParentIndices[CurrentIndex]);
+
+		for (int32 Direction = 0; Direction < Filter.GetNeighbourCount(); ++Direction)
+		{
+			const int32 NeighbourIndex = Filter.GetNeighbour(CurrentIndex, Direction);
+			if (NeighbourIndex == INDEX_NONE || Workspace.IsClosed(NeighbourIndex))
+			{
+				continue;
+			}
+
+			FVector::FReal EdgeCost;
+			if (!Filter.TryGetEdgeCost(CurrentIndex, Direction, NeighbourIndex, EdgeCost))
+			{
+				continue;
+			}
+
+			const float NewG = CurrentG + static_cast<float>(EdgeCost);
+			if (NewG > MaxCost || (Workspace.IsVisited(NeighbourIndex) && NewG >= Workspace.GScores[NeighbourIndex]))
+			{
+				continue;
+			}
+
+			Workspace.Visit(NeighbourIndex, NewG, CurrentIndex);
+			Workspace.OpenHeap.HeapPush({NewG, NeighbourIndex}, Predicate);
+		}
+	}
+}
+
+void UGridMapModel::FlushLandmarkRepairs()
+{
+	if (!IsBuilding)
 	{
-		TokenMap.Add(TokenActor->GetTokenID(), TokenActor);
-		TokenIDs.Add(TokenActor->GetTokenID());
+		Landmarks.FlushPendingRepairs(*this);
 	}
-	
-	Coord2TokenIDsMap.Add(InCoord, TokenIDs);
 }
 
-void UGridMapModel::BlockTileOnce(const FVector& InLocation)
+void UGridMapModel::MarkTileNavDataDirty(int32 TileIndex)
 {
-	auto Coord = StableWorldToCoord(InLocation);
-	BlockTileOnce(Coord);
+	// 缓存的寻路结果整体失效， 分层寻路只重建受影响的Chunk
+	++TopologyVersion;
+	HierarchicalPathFinder.MarkTileDirty(TileIndex);
+	CostLayers.UpdateTile(*this, TileIndex);
+	if (Connectivity.IsBuilt())
+	{
+		Connectivity.UpdateTile(*this, TileIndex);
+	}
+	Landmarks.UpdateTile(TileIndex);
+	if (NavSnapshot.IsValid())
+	{
+		NavSnapshotDirtyTiles.Add(TileIndex);
+	}
+	MarkTileSightDirty(TileIndex);
+
+	OnTileNavDataDirty.Broadcast(TileIndex);
 }
 
-void UGridMapModel::BlockTileOnce(const FHCubeCoord& InCoord)
+bool UGridMapModel::IsTileBlockingSight(int32 TileIndex)
 {
-	auto Index = StableGetFullMapGridIterIndex(InCoord);
+	if (!Tiles.IsValidIndex(TileIndex))
+	{
+		return true;
+	}
 
-	if (!Tiles.IsValidIndex(Index))
+	const FHCubeCoord& Coord = Tiles[TileIndex].CubeCoord;
+	const int32 DenseIndex = GetDenseTileIndex(Coord);
+	const FTileEnvData* EnvData = TileEnvDataMap.Find(DenseIndex, Coord);
+	if (EnvData && SightBlockingEnvTypes.Contains(EnvData->EnvironmentType))
 	{
-		UE_LOG(LogGridPathFinding, Error, TEXT("[UpdateTileInfo] Invalid tile index: %d for coord %s"),
-			   Index, *InCoord.ToString());
-		return;
+		return true;
 	}
 
+	if (const TArray<int32>* TokenIDs = Coord2TokenIDsMap.Find(DenseIndex, Coord))
+	{
+		for (const int32 TokenID : *TokenIDs)
+		{
+			const TObjectPtr<ATokenActor>* Token = TokenMap.Find(TokenID);
+			if (Token && *Token && (*Token)->bBlocksSight)
+			{
+				return true;
+			}
+		}
+	}
 
-	auto& TileInfo = Tiles[Index];
-	TileInfo.AddBlockOnce();
+	return false;
 }
 
-void UGridMapModel::UnBlockTileOnce(const FVector& InLocation)
+void UGridMapModel::MarkTileSightDirty(int32 TileIndex)
 {
-	auto Coord = StableWorldToCoord(InLocation);
-	UnBlockTileOnce(Coord);
+	if (FieldOfView.IsBuilt())
+	{
+		FieldOfView.UpdateTile(*this, TileIndex);
+	}
 }
 
-void UGridMapModel::UnBlockTileOnce(const FHCubeCoord& InCoord, bool bWarning)
+void UGridMapModel::ComputeVisibleTiles(int32 SourceIndex, int32 Radius, TArray<int32>& OutVisibleTiles)
 {
-	auto Index = StableGetFullMapGridIterIndex(InCoord);
+	FieldOfView.ComputeVisibleTiles(*this, SourceIndex, Radius, OutVisibleTiles);
+}
 
-	if (!Tiles.IsValidIndex(Index))
+void UGridMapModel::ComputeVisibleTilesBatch(TArrayView<FGridVisibilityRequest> Requests)
+{
+	if (IsBuilding)
 	{
-		if (bWarning)
-		{
-			UE_LOG(LogGridPathFinding, Error, TEXT("[UpdateTileInfo] Invalid tile index: %d for coord %s"),
-			       Index, *InCoord.ToString());
-		}
+		UE_LOG(LogGridPathFinding, Warning, TEXT("[ComputeVisibleTilesBatch] 地图数据构建中, 忽略%d个请求"), Requests.Num());
 		return;
 	}
 
+	FieldOfView.ComputeVisibleTilesBatch(*this, Requests);
+}
 
-	auto& TileInfo = Tiles[Index];
-	TileInfo.RemoveBlockOnce();
+bool UGridMapModel::HasLineOfSight(int32 FromIndex, int32 ToIndex) const
+{
+	return FieldOfView.HasLineOfSight(*this, FromIndex, ToIndex);
 }
 
-void UGridMapModel::SetTileCustomData(const FHCubeCoord& InCoord, const FName& Key, const FString& Value)
+TArray<FHCubeCoord> UGridMapModel::GetVisibleCoords(const FHCubeCoord& SourceCoord, int32 Radius)
 {
-	auto Index = StableGetFullMapGridIterIndex(InCoord);
-	if (!Tiles.IsValidIndex(Index))
+	TArray<FHCubeCoord> Result;
+	if (!IsCoordInMapArea(SourceCoord))
 	{
-		return;
+		return Result;
 	}
 
-	auto& TileInfo = Tiles[Index];
-	if (!TileInfo.CustomDataMap.Contains(Key))
+	TArray<int32> VisibleTiles;
+	ComputeVisibleTiles(StableGetFullMapGridIterIndex(SourceCoord), Radius, VisibleTiles);
+	Result.Reserve(VisibleTiles.Num());
+	for (const int32 TileIndex : VisibleTiles)
 	{
-		TileInfo.CustomDataMap.Add(Key, Value);
+		Result.Add(StableGetCoordByIndex(TileIndex));
 	}
-	else
+	return Result;
+}
+
+bool UGridMapModel::HasLineOfSightBetween(const FHCubeCoord& FromCoord, const FHCubeCoord& ToCoord) const
+{
+	if (!IsCoordInMapArea(FromCoord) || !IsCoordInMapArea(ToCoord))
 	{
-		TileInfo.CustomDataMap[Key] = Value;
+		return false;
 	}
+
+	return HasLineOfSight(StableGetFullMapGridIterIndex(FromCoord), StableGetFullMapGridIterIndex(ToCoord));
 }
 
-const FString& UGridMapModel::GetTileCustomData(const FHCubeCoord& InCoord, const FName& Key)
+void UGridMapModel::PublishNavSnapshot()
 {
-	auto Index = StableGetFullMapGridIterIndex(InCoord);
-	if (!Tiles.IsValidIndex(Index))
+	check(IsInGameThread());
+
+	if (IsBuilding || Tiles.Num() == 0 || (NavSnapshot.IsValid() && NavSnapshot->TopologyVersion == TopologyVersion))
 	{
-		static FString EmptyString;
-		return EmptyString;
+		return;
 	}
 
-	auto& TileInfo = Tiles[Index];
-	if (TileInfo.CustomDataMap.Contains(Key))
+	// 快照的邻居表和距离只支持六边形
+	if (PathTopology != EGridPathTopology::HexFlat && PathTopology != EGridPathTopology::HexPointy)
 	{
-		return TileInfo.CustomDataMap[Key];
+		// 每帧结束都会调用， 只提示一次
+		static bool bWarnedUnsupportedTopology = false;
+		if (!bWarnedUnsupportedTopology)
+		{
+			bWarnedUnsupportedTopology = true;
+			UE_LOG(LogGridPathFinding, Warning, TEXT("[PublishNavSnapshot] 寻路快照只支持行列排布的六边形地图(PathTopology: %d), 不发布快照, GetNavSnapshot将返回空"),
+			       static_cast<int32>(PathTopology));
+		}
+		return;
 	}
 
-	static FString EmptyString;
-	return EmptyString;
-}
+	const int32 NodeCount = GetMaxValidIndex() + 1;
+	constexpr int32 NumDirections = FGridNavSnapshot::NumDirections;
+	using FPage = FGridNavSnapshot::FPage;
+	TSharedRef<FGridNavSnapshot, ESPMode::ThreadSafe> NewSnapshot = MakeShared<FGridNavSnapshot, ESPMode::ThreadSafe>();
 
-int32 UGridMapModel::GetTileHeight(int32 TileIndex)
-{
-	if (Tiles.IsValidIndex(TileIndex))
+	if (NavSnapshot.IsValid() && NavSnapshot->NodeCount == NodeCount)
 	{
-		return Tiles[TileIndex].Height;
-	}
+		// 写时复制: 共享上一份快照的页， 变化的格子及其相邻格子所在的页第一次写入时才复制
+		*NewSnapshot = *NavSnapshot;
+		TArray<FPage*> WritablePages;
+		WritablePages.SetNumZeroed(NewSnapshot->Pages.Num());
+		auto GetWritablePage = [&NewSnapshot, &WritablePages](int32 TileIndex) -> FPage&
+		{
+			const int32 PageIndex = TileIndex >> FGridNavSnapshot::PageShift;
+			if (!WritablePages[PageIndex])
+			{
+				TSharedRef<FPage, ESPMode::ThreadSafe> PageCopy = MakeShared<FPage, ESPMode::ThreadSafe>(*NewSnapshot->Pages[PageIndex]);
+				WritablePages[PageIndex] = &PageCopy.Get();
+				NewSnapshot->Pages[PageIndex] = PageCopy;
+			}
+			return *WritablePages[PageIndex];
+		};
+		auto RefillEdgeCosts = [this, &GetWritablePage](int32 TileIndex)
+		{
+			FPage& Page = GetWritablePage(TileIndex);
+			const int32 LocalIndex = TileIndex & FGridNavSnapshot::PageMask;
+			FillTileEdgeCosts(INDEX_NONE, TileIndex, TArrayView<float>(Page.EdgeCosts.GetData() + LocalIndex * NumDirections, NumDirections));
+		};
 
-	UE_LOG(LogGridPathFinding, Error, TEXT("[GetTileHeight] Invalid tile index: %d"), TileIndex);
-	return 0;
-}
+		for (const int32 TileIndex : NavSnapshotDirtyTiles)
+		{
+			if (TileIndex < 0 || TileIndex >= NodeCount)
+			{
+				continue;
+			}
 
-bool UGridMapModel::CanTravelTo(int32 FromIndex, int32 ToIndex)
-{
-	// 如果该格子上有StandingActor，如果希望阻塞格子， 那么在UpdateStandingActor时可以通过重写增加Tile的BlockCount
-	if (Tiles.IsValidIndex(ToIndex))
+			FPage& Page = GetWritablePage(TileIndex);
+			const int32 LocalIndex = TileIndex & FGridNavSnapshot::PageMask;
+			Page.PassableTiles[LocalIndex] = !TileStore.IsBlocked(TileIndex);
+			Page.TileHeights[LocalIndex] = TileStore.GetHeight(TileIndex);
+			RefillEdgeCosts(TileIndex);
+			for (int32 Direction = 0; Direction < NumDirections; ++Direction)
+			{
+				const int32 NeighbourIndex = GetNeighborIndex(TileIndex, Direction);
+				if (NeighbourIndex != INDEX_NONE)
+				{
+					RefillEdgeCosts(NeighbourIndex);
+				}
+			}
+		}
+	}
+	else
 	{
-		if (Tiles[ToIndex].IsBlocking())
+		NewSnapshot->NodeCount = NodeCount;
+		NewSnapshot->TopologyParams.Initialize(MapConfig);
+		NewSnapshot->bFlatOrientation = PathTopology == EGridPathTopology::HexFlat;
+
+		TSharedRef<TArray<int32>, ESPMode::ThreadSafe> NeighborTable = MakeShared<TArray<int32>, ESPMode::ThreadSafe>();
+		NeighborTable->SetNumUninitialized(NodeCount * NumDirections);
+		for (int32 TileIndex = 0; TileIndex < NodeCount; ++TileIndex)
 		{
-			return false; // 如果BlockCount大于0，表示该格子被阻塞
+			for (int32 Direction = 0; Direction < NumDirections; ++Direction)
+			{
+				(*NeighborTable)[TileIndex * NumDirections + Direction] = GetNeighborIndex(TileIndex, Direction);
+			}
 		}
-	}
+		NewSnapshot->NeighborTable = NeighborTable;
 
-	return true;
-}
+		const int32 NumPages = FMath::DivideAndRoundUp(NodeCount, FGridNavSnapshot::PageSize);
+		const float* DefaultLayer = CostLayers.FindLayer(INDEX_NONE);
+		NewSnapshot->Pages.SetNum(NumPages);
+		ParallelFor(NumPages, [this, &NewSnapshot, NodeCount, DefaultLayer](int32 PageIndex)
+		{
+			const int32 FirstIndex = PageIndex << FGridNavSnapshot::PageShift;
+			const int32 PageTileCount = FMath::Min(FGridNavSnapshot::PageSize, NodeCount - FirstIndex);
+			TSharedRef<FPage, ESPMode::ThreadSafe> Page = MakeShared<FPage, ESPMode::ThreadSafe>();
+			Page->PassableTiles.Init(false, PageTileCount);
+			Page->TileHeights.SetNumZeroed(PageTileCount);
+			Page->EdgeCosts.SetNumUninitialized(PageTileCount * NumDirections);
+			for (int32 LocalIndex = 0; LocalIndex < PageTileCount; ++LocalIndex)
+			{
+				const int32 TileIndex = FirstIndex + LocalIndex;
+				if (TileIndex < TileStore.Num())
+				{
+					Page->PassableTiles[LocalIndex] = !TileStore.IsBlocked(TileIndex);
+					Page->TileHeights[LocalIndex] = TileStore.GetHeight(TileIndex);
+				}
+			}
 
-int32 UGridMapModel::GetTileHeight(const FHCubeCoord& InCoord)
-{
-	auto Index = StableGetFullMapGridIterIndex(InCoord);
-	return GetTileHeight(Index);
-}
+			if (DefaultLayer)
+			{
+				FMemory::Memcpy(Page->EdgeCosts.GetData(), DefaultLayer + FirstIndex * NumDirections, PageTileCount * NumDirections * sizeof(float));
+			}
+			else
+			{
+				for (int32 LocalIndex = 0; LocalIndex < PageTileCount; ++LocalIndex)
+				{
+					FillTileEdgeCosts(INDEX_NONE, FirstIndex + LocalIndex, TArrayView<float>(Page->EdgeCosts.GetData() + LocalIndex * NumDirections, NumDirections));
+				}
+			}
+			NewSnapshot->Pages[PageIndex] = Page;
+		}, SupportsParallelPathQueries() ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread);
+	}
 
-double UGridMapModel::GetTraversalCost(int Identifier, int32 FromIndex, int32 ToIndex)
-{
-	// 子类重写
-	return 1.f;
+	NewSnapshot->TopologyVersion = TopologyVersion;
+	NavSnapshotDirtyTiles.Reset();
+
+	FScopeLock Lock(&NavSnapshotLock);
+	NavSnapshot = NewSnapshot;
 }
 
 int32 UGridMapModel::GetMaxDistanceToBoundary(const FHCubeCoord& InCoord) const
@@ -628,7 +1510,7 @@ UGridMapModel::FBuildTilesDataTask::FBuildTilesDataTask(UGridMapModel* InOwner,
                                                         TArray<UGridEnvironmentType*> InEnvironmentTypes,
                                                         const TMap<FHCubeCoord, FSerializableTile>& InTilesData,
                                                         TSharedPtr<TArray<FTileInfo>> OutTiles,
-                                                        TSharedPtr<TMap<FHCubeCoord, FTileEnvData>> OutEnvData):
+                                                        TSharedPtr<TGridTileMap<FTileEnvData>> OutEnvData):
 	Owner(InOwner)
 	, EnvironmentTypes(InEnvironmentTypes)
 	, TilesData(InTilesData)
@@ -664,7 +1546,7 @@ void UGridMapModel::FBuildTilesDataTask::DoWork()
 		const FSerializableTile& TileData = TileDataPair.Value;
 
 		// 添加到临时数组
-		TargetTileEnvDataMapPtr->Add(Coord, TileData.TileEnvData);
+		TargetTileEnvDataMapPtr->Add(Owner->GetDenseTileIndex(Coord), Coord, TileData.TileEnvData);
 		
 		// 如果处理了一批数据，可以在此处添加短暂的休眠，避免阻塞主线程太长时间
 		if (TargetTileEnvDataMapPtr->Num() % 1000 == 0)
@@ -1091,9 +1973,9 @@ bool UGridMapModel::IsCoordInMapArea(const FHCubeCoord& InCoord) const
 			switch (MapConfig.DrawMode)
 			{
 			case EGridMapDrawMode::BaseOnRadius:
+				return FMath::Max3(FMath::Abs(InCoord.QRS.X), FMath::Abs(InCoord.QRS.Y), FMath::Abs(InCoord.QRS.X + InCoord.QRS.Y)) <= MapConfig.MapRadius;
 			case EGridMapDrawMode::BaseOnVolume:
-				UE_LOG(LogGridPathFinding, Error, TEXT("[IsCoordInMapArea]暂不支持的坐标转换: %s"), *UEnum::GetValueAsString(MapConfig.DrawMode));
-				break;
+				return PagedTileIndex.GetIndex(InCoord.QRS.X, InCoord.QRS.Y) != INDEX_NONE;
 			case EGridMapDrawMode::BaseOnRowColumn:
 				{
 					// 使用缓存的边界值
@@ -1125,6 +2007,26 @@ void UGridMapModel::StableForEachMapGrid(
 			{
 			case EGridMapDrawMode::BaseOnRadius:
 				{
+					// 与StableGetFullMapGridIterIndex的顺序相同， Row、Column为偏移坐标
+					const int32 Radius = MapConfig.MapRadius;
+					const bool bFlat = MapConfig.TileOrientation == ETileOrientationFlag::FLAT;
+					for (int32 Q{-Radius}; Q <= Radius; ++Q)
+					{
+						const int32 R1{FMath::Max(-Radius, -Q - Radius)};
+						const int32 R2{FMath::Min(Radius, -Q + Radius)};
+						for (int32 R{R1}; R <= R2; ++R)
+						{
+							FHCubeCoord CCoord{FIntVector(Q, R, -Q - R)};
+							if (bFlat)
+							{
+								TileFunction(CCoord, R + (Q - (Q & 1)) / 2, Q);
+							}
+							else
+							{
+								TileFunction(CCoord, R, Q + (R - (R & 1)) / 2);
+							}
+						}
+					}
 				}
 				break;
 			case EGridMapDrawMode::BaseOnRowColumn:
@@ -1163,7 +2065,23 @@ void UGridMapModel::StableForEachMapGrid(
 				break;
 			case EGridMapDrawMode::BaseOnVolume:
 				{
-					// Todo
+					// 按PagedTileIndex的Index顺序， Row、Column为偏移坐标
+					const bool bFlat = MapConfig.TileOrientation == ETileOrientationFlag::FLAT;
+					for (int32 TileIndex = 0; TileIndex < PagedTileIndex.Num(); ++TileIndex)
+					{
+						const FIntPoint& Axial = PagedTileIndex.GetAxial(TileIndex);
+						const int32 Q = Axial.X;
+						const int32 R = Axial.Y;
+						FHCubeCoord CCoord{FIntVector(Q, R, -Q - R)};
+						if (bFlat)
+						{
+							TileFunction(CCoord, R + (Q - (Q & 1)) / 2, Q);
+						}
+						else
+						{
+							TileFunction(CCoord, R, Q + (R - (R & 1)) / 2);
+						}
+					}
 				}
 				break;
 			}
@@ -1186,8 +2104,7 @@ int32 UGridMapModel::StableGetFullMapGridIterIndex(const FHCubeCoord& InCoord) c
 	switch (MapConfig.DrawMode)
 	{
 	case EGridMapDrawMode::BaseOnRadius:
-		UE_LOG(LogGridPathFinding, Error, TEXT("[HighLightBackground] 暂不支持遍历: %s"), *UEnum::GetValueAsString(MapConfig.DrawMode));
-		break;
+		return FGridHexRadiusTopology::GetIndex(Q, R, MapConfig.MapRadius);
 	case EGridMapDrawMode::BaseOnRowColumn:
 		{
 			// 使用缓存的边界值
@@ -1222,8 +2139,7 @@ int32 UGridMapModel::StableGetFullMapGridIterIndex(const FHCubeCoord& InCoord) c
 		}
 		break;
 	case EGridMapDrawMode::BaseOnVolume:
-		UE_LOG(LogGridPathFinding, Error, TEXT("[HighLightBackground] 暂不支持高亮: %s"), *UEnum::GetValueAsString(MapConfig.DrawMode));
-		break;
+		return PagedTileIndex.GetIndex(Q, R);
 	}
 
 	return INDEX_NONE;
@@ -1236,8 +2152,10 @@ int32 UGridMapModel::StableGetChunkCount() const
 	{
 	case EGridMapDrawMode::BaseOnRadius:
 		{
+			// 在Q、R轴上把 (2 * MapRadius + 1) 的外接菱形按ChunkSize划分， 角落的Chunk可能没有格子
+			const int32 NumChunksPerAxis = FMath::DivideAndRoundUp(2 * MapConfig.MapRadius + 1, GSettings->MapChunkSize.X);
+			return NumChunksPerAxis * NumChunksPerAxis;
 		}
-		break;
 	case EGridMapDrawMode::BaseOnRowColumn:
 		{
 			// 从左上开始， 每ChunkRowSize*ChunkColumnSize的方形区域构成一个Chunk, 根据MapSize计算总共需要划分几个区块
@@ -1251,10 +2169,8 @@ int32 UGridMapModel::StableGetChunkCount() const
 			return NumChunksX * NumChunksY;
 		}
 	case EGridMapDrawMode::BaseOnVolume:
-		{
-			// Todo
-		}
-		break;
+		// 每个页作为一个Chunk， 页的大小固定， 不使用MapChunkSize
+		return PagedTileIndex.GetPageCount();
 	}
 
 	return 0;
@@ -1268,8 +2184,16 @@ int32 UGridMapModel::StableGetCoordChunkIndex(const FHCubeCoord& InCoord) const
 	{
 	case EGridMapDrawMode::BaseOnRadius:
 		{
+			if (!IsCoordInMapArea(InCoord))
+			{
+				break;
+			}
+
+			const int32 NumChunksPerAxis = FMath::DivideAndRoundUp(2 * MapConfig.MapRadius + 1, ChunkSize);
+			const int32 ChunkQ = (InCoord.QRS.X + MapConfig.MapRadius) / ChunkSize;
+			const int32 ChunkR = (InCoord.QRS.Y + MapConfig.MapRadius) / ChunkSize;
+			return ChunkQ * NumChunksPerAxis + ChunkR;
 		}
-		break;
 	case EGridMapDrawMode::BaseOnRowColumn:
 		{
 			// 使用缓存的边界值
@@ -1291,10 +2215,7 @@ int32 UGridMapModel::StableGetCoordChunkIndex(const FHCubeCoord& InCoord) const
 			return ChunkRow * NumChunksY + ChunkCol;
 		}
 	case EGridMapDrawMode::BaseOnVolume:
-		{
-			// Todo
-		}
-		break;
+		return PagedTileIndex.GetTilePage(InCoord.QRS.X, InCoord.QRS.Y);
 	}
 
 	return INDEX_NONE;
@@ -1347,13 +2268,27 @@ FHCubeCoord UGridMapModel::StableGetCoordByIndex(const int32 InIndex) const
         }
         break;
     case EGridMapDrawMode::BaseOnRadius:
-        // TODO: 实现基于半径的索引转换
-        UE_LOG(LogGridPathFinding, Warning, TEXT("StableGetCoordByIndex: BaseOnRadius not implemented yet"));
-        break;
+        {
+            if (InIndex < 0 || InIndex >= FGridHexRadiusTopology::GetTileCount(MapConfig.MapRadius))
+            {
+                UE_LOG(LogGridPathFinding, Warning, TEXT("StableGetCoordByIndex: Index %d out of range"), InIndex);
+                return FHCubeCoord::Invalid;
+            }
+
+            const FIntPoint& Axial = RadiusIndexToAxial[InIndex];
+            return FHCubeCoord{FIntVector(Axial.X, Axial.Y, -Axial.X - Axial.Y)};
+        }
     case EGridMapDrawMode::BaseOnVolume:
-        // TODO: 实现基于体积的索引转换
-        UE_LOG(LogGridPathFinding, Warning, TEXT("StableGetCoordByIndex: BaseOnVolume not implemented yet"));
-        break;
+        {
+            if (!PagedTileIndex.IsValidIndex(InIndex))
+            {
+                UE_LOG(LogGridPathFinding, Warning, TEXT("StableGetCoordByIndex: Index %d out of range"), InIndex);
+                return FHCubeCoord::Invalid;
+            }
+
+            const FIntPoint& Axial = PagedTileIndex.GetAxial(InIndex);
+            return FHCubeCoord{FIntVector(Axial.X, Axial.Y, -Axial.X - Axial.Y)};
+        }
     }
     
     return FHCubeCoord::Invalid;
@@ -1384,7 +2319,7 @@ int32 UGridMapModel::GetDistanceByIndex(const int32 A, const int32 B) const
 	if (A == B) return 0;
 
 	// 边界检查
-	const int32 TotalGridCount = MapConfig.MapSize.X * MapConfig.MapSize.Y;
+	const int32 TotalGridCount = MaxValidIndex + 1;
 	if (A < 0 || A >= TotalGridCount || B < 0 || B >= TotalGridCount)
 	{
 		UE_LOG(LogGridPathFinding, Warning, TEXT("GetDistanceByIndex: Invalid index A=%d B=%d"), A, B);
@@ -1399,50 +2334,13 @@ int32 UGridMapModel::GetDistanceByIndex(const int32 A, const int32 B) const
 				switch (MapConfig.DrawMode)
 				{
 					case EGridMapDrawMode::BaseOnRowColumn:
-						{
-							// 缓存地图参数（这些值在地图生命周期内不变）
-							const int32 MapRows = MapConfig.MapSize.X;
-							const int32 MapColumns = MapConfig.MapSize.Y;
-							const int32 MapRowsHalf = MapRows / 2;
-							const int32 MapColumnsHalf = MapColumns / 2;
-
-							int32 qA, rA, qB, rB;
-
-							if (MapConfig.TileOrientation == ETileOrientationFlag::FLAT)
-							{
-								// FLAT布局的索引到坐标转换
-								const int32 columnA = A / MapRows;
-								const int32 rowA = A % MapRows;
-								qA = columnA - MapColumnsHalf;
-								rA = rowA - (columnA - (columnA & 1)) / 2 - MapRowsHalf;
-
-								const int32 columnB = B / MapRows;
-								const int32 rowB = B % MapRows;
-								qB = columnB - MapColumnsHalf;
-								rB = rowB - (columnB - (columnB & 1)) / 2 - MapRowsHalf;
-							}
-							else // POINTY
-							{
-								// POINTY布局的索引到坐标转换
-								const int32 rowA = A / MapColumns;
-								const int32 columnA = A % MapColumns;
-								qA = columnA - (rowA - (rowA & 1)) / 2 - MapColumnsHalf;
-								rA = rowA - MapRowsHalf;
-
-								const int32 rowB = B / MapColumns;
-								const int32 columnB = B % MapColumns;
-								qB = columnB - (rowB - (rowB & 1)) / 2 - MapColumnsHalf;
-								rB = rowB - MapRowsHalf;
-							}
-
-							// 六边形距离计算
-							return (FMath::Abs(qA - qB) + FMath::Abs(qA + rA - qB - rB) + FMath::Abs(rA - rB)) / 2;
-						}
+						return MapConfig.TileOrientation == ETileOrientationFlag::FLAT
+							       ? FGridHexFlatTopology::GetDistance(A, B, NeighborTopologyParams)
+							       : FGridHexPointyTopology::GetDistance(A, B, NeighborTopologyParams);
 					case EGridMapDrawMode::BaseOnRadius:
+						return FGridHexRadiusTopology::GetDistance(A, B, NeighborTopologyParams);
 					case EGridMapDrawMode::BaseOnVolume:
-						UE_LOG(LogGridPathFinding, Warning, TEXT("GetDistanceByIndex: 暂不支持的绘制模式 %s"),
-						       *UEnum::GetValueAsString(MapConfig.DrawMode));
-						break;
+						return FGridHexVolumeTopology::GetDistance(A, B, NeighborTopologyParams);
 				}
 				break;
 			}
@@ -1531,10 +2429,36 @@ void UGridMapModel::StableGetChunkCoords(const int32 InChunkIndex, TArray<FHCube
 		}
 
 	case EGridMapDrawMode::BaseOnRadius:
+		{
+			const int32 Radius = MapConfig.MapRadius;
+			const int32 NumChunksPerAxis = FMath::DivideAndRoundUp(2 * Radius + 1, ChunkSize);
+			const int32 StartQ = InChunkIndex / NumChunksPerAxis * ChunkSize - Radius;
+			const int32 StartR = InChunkIndex % NumChunksPerAxis * ChunkSize - Radius;
+			const int32 EndQ = FMath::Min(StartQ + ChunkSize, Radius + 1);
+			const int32 EndR = FMath::Min(StartR + ChunkSize, Radius + 1);
+			for (int32 Q = StartQ; Q < EndQ; ++Q)
+			{
+				for (int32 R = StartR; R < EndR; ++R)
+				{
+					if (FMath::Abs(Q + R) <= Radius)
+					{
+						OutCoords.Add(FHCubeCoord(FIntVector(Q, R, -Q - R)));
+					}
+				}
+			}
+			break;
+		}
 	case EGridMapDrawMode::BaseOnVolume:
-		UE_LOG(LogGridPathFinding, Warning, TEXT("StableGetChunkCoords: 暂不支持在 %s 模式下获取区块坐标"),
-		       *UEnum::GetValueAsString(MapConfig.DrawMode));
-		break;
+		{
+			TArray<FIntPoint> AxialCoords;
+			PagedTileIndex.GetPageTiles(InChunkIndex, AxialCoords);
+			OutCoords.Reserve(OutCoords.Num() + AxialCoords.Num());
+			for (const FIntPoint& Axial : AxialCoords)
+			{
+				OutCoords.Add(FHCubeCoord(FIntVector(Axial.X, Axial.Y, -Axial.X - Axial.Y)));
+			}
+			break;
+		}
 	}
 }
 
@@ -1601,11 +2525,6 @@ TArray<FHCubeCoord> UGridMapModel::GetRangeCoords(const FHCubeCoord& Center, int
 	return Result;
 }
 
-int32 UGridMapModel::GetNeighborIndex(int32 NodeIndex, int32 Direction) const
-{
-	return NeighborIndicesCache[NodeIndex][Direction];
-}
-
 float UGridMapModel::GetTileHeightOffset(const FHCubeCoord& InCoord)
 {
 	return 0.f;
@@ -1639,31 +2558,120 @@ FHCubeCoord UGridMapModel::HexCoordRound(const FHFractional& F)
 
 void UGridMapModel::BuildPathFindingCache()
 {
+	TRACE_CPUPROFILER_EVENT_SCOPE(UGridMapModel::BuildPathFindingCache);
+
+	NeighborIndicesCache.Empty();
+	NeighborTopologyParams.Initialize(MapConfig);
+	NeighborTopologyParams.PagedTileIndex = &PagedTileIndex;
+	NeighborTopologyParams.RadiusIndexToAxial = &RadiusIndexToAxial;
+
 	if (MapConfig.DrawMode == EGridMapDrawMode::BaseOnRowColumn)
 	{
 		MaxValidIndex = MapConfig.MapSize.X * MapConfig.MapSize.Y - 1;
 	}
+	else if (PathTopology == EGridPathTopology::HexRadius)
+	{
+		MaxValidIndex = FGridHexRadiusTopology::GetTileCount(MapConfig.MapRadius) - 1;
+	}
+	else if (PathTopology == EGridPathTopology::HexVolume)
+	{
+		MaxValidIndex = PagedTileIndex.Num() - 1;
+	}
 	else
 	{
 		UE_LOG(LogGridPathFinding, Error, TEXT("[Error] 未实现寻路缓存, 会导致寻路错误, 绘制模式 %s"), *UEnum::GetValueAsString(MapConfig.DrawMode));
+		return;
 	}
-	
-	NeighborIndicesCache.Empty();
 
-	// 计算总的网格数量
-	int32 TotalGridCount = MapConfig.MapSize.X * MapConfig.MapSize.Y;
-	NeighborIndicesCache.SetNum(TotalGridCount);
-    
-	// 为每个Index计算其6个邻居
-	for (int32 i = 0; i < TotalGridCount; ++i)
+	if (GetDefault<UGridPathFindingSettings>()->NeighborIndexMode == EGridNeighborIndexMode::Computed)
+	{
+		// 寻路时由GetNeighborIndex实时计算
+		return;
+	}
+
+	// 计算总的网格数量， 所有格子的邻居放在一块连续内存中
+	const int32 TotalGridCount = MaxValidIndex + 1;
+	NeighborIndicesCache.SetNumUninitialized(TotalGridCount * NeighborTableStride);
+	int32* NeighborTable = NeighborIndicesCache.GetData();
+
+	ParallelFor(TotalGridCount, [this, NeighborTable](int32 NodeIndex)
+	{
+		int32* Neighbors = NeighborTable + NodeIndex * NeighborTableStride;
+		for (int32 Direction = 0; Direction < NeighborTableStride; ++Direction)
+		{
+			Neighbors[Direction] = ComputeNeighborIndex(NodeIndex, Direction);
+		}
+	});
+}
+
+int32 UGridMapModel::ComputeNeighborIndexByCoord(int32 NodeIndex, int32 Direction) const
+{
+	return StableGetFullMapGridIterIndex(GetNeighborCoord(StableGetCoordByIndex(NodeIndex), Direction));
+}
+
+// 只比较XY， 格子所在的平面与Volume的高度无关
+static bool IsLocationInMapVolume(const FGripMapVolume& InVolume, const FVector& InLocation)
+{
+	const double DeltaX = InLocation.X - InVolume.Center.X;
+	const double DeltaY = InLocation.Y - InVolume.Center.Y;
+	switch (InVolume.ShapeType)
+	{
+	case EGridMapVolumeShapeType::BOX:
+		return FMath::Abs(DeltaX) <= InVolume.BoxExtent.X && FMath::Abs(DeltaY) <= InVolume.BoxExtent.Y;
+	case EGridMapVolumeShapeType::SPHERE:
+		return DeltaX * DeltaX + DeltaY * DeltaY <= FMath::Square(static_cast<double>(InVolume.SphereRadius));
+	}
+
+	return false;
+}
+
+void UGridMapModel::BuildVolumeTileIndex()
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UGridMapModel::BuildVolumeTileIndex);
+
+	TArray<FIntPoint> AxialCoords;
+	for (const FGripMapVolume& PlaceVolume : MapConfig.PlaceVolumes)
 	{
-		NeighborIndicesCache[i].SetNum(6);
-		FHCubeCoord CurrentCoord = StableGetCoordByIndex(i);
-        
-		for (int32 dir = 0; dir < 6; ++dir)
+		const FVector Extent = PlaceVolume.ShapeType == EGridMapVolumeShapeType::SPHERE
+			                       ? FVector(PlaceVolume.SphereRadius)
+			                       : PlaceVolume.BoxExtent;
+
+		// Q、R是世界坐标的线性函数， 在外接矩形上的极值出现在四个角， 再向外扩一格抵消取整误差
+		int32 MinQ = MAX_int32, MaxQ = MIN_int32, MinR = MAX_int32, MaxR = MIN_int32;
+		for (int32 Corner = 0; Corner < 4; ++Corner)
 		{
-			FHCubeCoord NeighborCoord = GetNeighborCoord(CurrentCoord, dir);
-			NeighborIndicesCache[i][dir] = StableGetFullMapGridIterIndex(NeighborCoord);
+			const FVector CornerLocation = PlaceVolume.Center + FVector((Corner & 1) ? Extent.X : -Extent.X, (Corner & 2) ? Extent.Y : -Extent.Y, 0.);
+			const FHCubeCoord CornerCoord = StableWorldToCoord(CornerLocation);
+			MinQ = FMath::Min(MinQ, CornerCoord.QRS.X);
+			MaxQ = FMath::Max(MaxQ, CornerCoord.QRS.X);
+			MinR = FMath::Min(MinR, CornerCoord.QRS.Y);
+			MaxR = FMath::Max(MaxR, CornerCoord.QRS.Y);
+		}
+
+		for (int32 Q = MinQ - 1; Q <= MaxQ + 1; ++Q)
+		{
+			for (int32 R = MinR - 1; R <= MaxR + 1; ++R)
+			{
+				const FVector TileLocation = StableCoordToWorld(FHCubeCoord{FIntVector(Q, R, -Q - R)});
+				if (!IsLocationInMapVolume(PlaceVolume, TileLocation))
+				{
+					continue;
+				}
+
+				const bool bSubtracted = MapConfig.SubtractVolumes.ContainsByPredicate([&TileLocation](const FGripMapVolume& SubtractVolume)
+				{
+					return IsLocationInMapVolume(SubtractVolume, TileLocation);
+				});
+				if (!bSubtracted)
+				{
+					AxialCoords.Add(FIntPoint(Q, R));
+				}
+			}
 		}
 	}
+
+	// 重叠的Volume会产生重复的坐标， 由PagedTileIndex去重
+	PagedTileIndex.Build(AxialCoords);
+	UE_LOG(LogGridPathFinding, Log, TEXT("[BuildVolumeTileIndex] %d tiles in %d pages, %llu bytes"), PagedTileIndex.Num(),
+	       PagedTileIndex.GetPageCount(), static_cast<uint64>(PagedTileIndex.GetAllocatedSize()));
 }
@@ -77,6 +77,8 @@ void AGridMapRenderer::RenderGridMap()
 		}
 	}
 	// }
+	// 实例已全部清除， 地图配置也可能变化， 记录的实例Index一并清空
+	EnvISMCIndexMap.Reset();
 
 	// 清理高亮
 	ClearAllHighlightMasks();
@@ -114,6 +116,8 @@ void AGridMapRenderer::ClearGridMap()
 		}
 	}
 	// }
+	// 实例已全部清除， 地图配置也可能变化， 记录的实例Index一并清空
+	EnvISMCIndexMap.Reset();
 }
 
 void AGridMapRenderer::RenderTiles()
@@ -129,7 +133,7 @@ void AGridMapRenderer::RenderTiles()
 		for (const auto& Tile : *TilesPtr)
 		{
 			auto Coord = Tile.CubeCoord;
-			auto EnvData = TileEnvDataPtr->Find(Coord);
+			auto EnvData = TileEnvDataPtr->Find(GridModel->GetDenseTileIndex(Coord), Coord);
 
 			// check(EnvType != UGridEnvironmentType::EmptyEnvTypeID);
 			// 打印Coord
@@ -177,7 +181,7 @@ void AGridMapRenderer::ClearAllHighlightMasks()
 	if (HighLightMask)
 	{
 		HighLightMask->ClearInstances();
-		HighlightMaskIndexMap.Empty();
+		HighlightMaskIndexMap.Reset();
 	}
 }
 
@@ -341,7 +345,7 @@ void AGridMapRenderer::OnTileHeightUpdate(const FHCubeCoord& InCoord, float oldH
 		return;
 	}
 	
-	auto Index = EnvISMCIndexMap.Find(InCoord);
+	auto Index = EnvISMCIndexMap.Find(GridModel->GetDenseTileIndex(InCoord), InCoord);
 	if (!Index)
 	{
 		UE_LOG(LogGridPathFinding, Error, TEXT("无对应实例，无法更新高度"));
@@ -472,6 +476,7 @@ void AGridMapRenderer::UpdateTileEnvRenderer(FHCubeCoord Coord, const FTileEnvDa
 {
 	auto OldEnvType = InOldEnvData.EnvironmentType;
 	auto NewEnvType = InNewEnvData.EnvironmentType;
+	const int32 DenseIndex = GridModel->GetDenseTileIndex(Coord);
 	if (OldEnvType != UGridEnvironmentType::EmptyEnvTypeID)
 	{
 		auto OldEnvTypeISM = GetEnvironmentComponent(OldEnvType);
@@ -482,25 +487,25 @@ void AGridMapRenderer::UpdateTileEnvRenderer(FHCubeCoord Coord, const FTileEnvDa
 			// OldEnvTypeISM->RemoveInstance(EnvISMCIndexMap[Coord]);
 			// EnvISMCIndexMap.Remove(Coord);
 
-			auto Idx = EnvISMCIndexMap.Find(Coord);
+			auto Idx = EnvISMCIndexMap.Find(DenseIndex, Coord);
 			check(Idx != nullptr);
 
 			int32 RemoveIdx = *Idx;
-			OldEnvTypeISM->RemoveInstance(EnvISMCIndexMap[Coord]);
-			EnvISMCIndexMap.Remove(Coord);
+			OldEnvTypeISM->RemoveInstance(RemoveIdx);
+			EnvISMCIndexMap.Remove(DenseIndex, Coord);
 
-			for (auto& Pair : EnvISMCIndexMap)
+			EnvISMCIndexMap.ForEach([RemoveIdx](const FHCubeCoord&, int32& InstanceIndex)
 			{
-				if (Pair.Value > RemoveIdx)
+				if (InstanceIndex > RemoveIdx)
 				{
-					Pair.Value--;
+					InstanceIndex--;
 				}
-			}
+			});
 		}
 		else
 		{
 			// 此时应当已经创建过了实例， 更新直接材质球CustomData即可
-			auto Index = EnvISMCIndexMap[Coord];
+			auto Index = *EnvISMCIndexMap.Find(DenseIndex, Coord);
 			check(EnvType2DefaultCustomDataMap.Contains(OldEnvType))
 			const auto& DefaultCustomData = EnvType2DefaultCustomDataMap[OldEnvType];
 			OldEnvTypeISM->SetCustomData(Index, {
@@ -538,7 +543,7 @@ void AGridMapRenderer::UpdateTileEnvRenderer(FHCubeCoord Coord, const FTileEnvDa
 		GridRotator, TileLocation + RenderConfig.BackgroundDrawLocationOffset,
 		FVector::OneVector * Scale);
 	auto Index = NewEnvISM->AddInstance(MeshTransform, true);
-	EnvISMCIndexMap.Add(Coord, Index);
+	EnvISMCIndexMap.Add(DenseIndex, Coord, Index);
 	// Todo: 赋值正确的CustomData
 	check(EnvType2DefaultCustomDataMap.Contains(NewEnvType))
 	const auto& DefaultCustomData = EnvType2DefaultCustomDataMap[NewEnvType];
@@ -721,9 +726,10 @@ void AGridMapRenderer::AddHighlightMask(const FHCubeCoord& InCoord, const FLinea
 	}
 
 	// 如果已经存在高亮，更新颜色
-	if (HighlightMaskIndexMap.Contains(InCoord))
+	const int32 DenseIndex = GridModel->GetDenseTileIndex(InCoord);
+	if (const int32* ExistingInstanceIndex = HighlightMaskIndexMap.Find(DenseIndex, InCoord))
 	{
-		int32 InstanceIndex = HighlightMaskIndexMap[InCoord];
+		int32 InstanceIndex = *ExistingInstanceIndex;
 		TArray<float> ColorData = {
 			HighlightColor.R,
 			HighlightColor.G,
@@ -768,7 +774,7 @@ void AGridMapRenderer::AddHighlightMask(const FHCubeCoord& InCoord, const FLinea
 	HighLightMask->SetCustomData(InstanceIndex, ColorData);
 
 	// 保存映射
-	HighlightMaskIndexMap.Add(InCoord, InstanceIndex);
+	HighlightMaskIndexMap.Add(DenseIndex, InCoord, InstanceIndex);
 
 	UE_LOG(LogGridPathFinding, VeryVerbose, TEXT("Added highlight mask at coord %s with color (%f, %f, %f, %f)"),
 		*InCoord.ToString(), HighlightColor.R, HighlightColor.G, HighlightColor.B, HighlightColor.A);
@@ -783,7 +789,8 @@ void AGridMapRenderer::RemoveHighlightMask(const FHCubeCoord& InCoord)
 	}
 
 	// 查找实例索引
-	int32* InstanceIndexPtr = HighlightMaskIndexMap.Find(InCoord);
+	const int32 DenseIndex = GridModel->GetDenseTileIndex(InCoord);
+	int32* InstanceIndexPtr = HighlightMaskIndexMap.Find(DenseIndex, InCoord);
 	if (!InstanceIndexPtr)
 	{
 		UE_LOG(LogGridPathFinding, VeryVerbose, TEXT("No highlight mask found at coord %s"), *InCoord.ToString());
@@ -796,16 +803,16 @@ void AGridMapRenderer::RemoveHighlightMask(const FHCubeCoord& InCoord)
 	HighLightMask->RemoveInstance(InstanceIndex);
 	
 	// 更新映射索引（因为RemoveInstance会影响后续实例的索引）
-	HighlightMaskIndexMap.Remove(InCoord);
+	HighlightMaskIndexMap.Remove(DenseIndex, InCoord);
 	
 	// 更新其他实例的索引
-	for (auto& Pair : HighlightMaskIndexMap)
+	HighlightMaskIndexMap.ForEach([InstanceIndex](const FHCubeCoord&, int32& OtherInstanceIndex)
 	{
-		if (Pair.Value > InstanceIndex)
+		if (OtherInstanceIndex > InstanceIndex)
 		{
-			Pair.Value--;
+			OtherInstanceIndex--;
 		}
-	}
+	});
 
 	UE_LOG(LogGridPathFinding, VeryVerbose, TEXT("Removed highlight mask at coord %s"), *InCoord.ToString());
 }
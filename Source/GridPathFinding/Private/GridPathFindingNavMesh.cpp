@@ -3,11 +3,11 @@
 
 #include "GridPathFindingNavMesh.h"
 
-#include <chrono>
-
-#include "GraphAStar.h"
 #include "GridMapModel.h"
 #include "GridPathFindingIdentifier.h"
+#include "GridPathFindingSettings.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "TimerManager.h"
 #include "Types/HCubeCoord.h"
 
 
@@ -21,8 +21,8 @@ FPathFindingResult AGridPathFindingNavMesh::FindPath(const FNavAgentProperties&
 	// the cast of ANavigationData to our class.
 	SCOPE_CYCLE_COUNTER(STAT_Navigation_GASPathfinding);
 	CSV_SCOPED_TIMING_STAT_EXCLUSIVE(Pathfinding);
-	// 获取开始时间
-	auto start = std::chrono::high_resolution_clock::now();
+	TRACE_CPUPROFILER_EVENT_SCOPE(AGridPathFindingNavMesh::FindPath);
+	// 不再逐次输出耗时日志， 需要时使用 GridPathFinding.Telemetry 统计， 或在Unreal Insights中查看
 	// Because we are in a static function we don't have a "this" pointer so we can't access to class member variables like HexGrid
 	// but luckily the FPathFindingQuery contain a pointer to the ANavigationData object.
 	const ANavigationData *Self = Query.NavData.Get();
@@ -66,6 +66,9 @@ FPathFindingResult AGridPathFindingNavMesh::FindPath(const FNavAgentProperties&
 	if (NavMeshPath && NavFilter)
 	{
 		NavMeshPath->ApplyFlags(Query.NavDataFlags);
+		// 复用的路径实例可能保留上一次的结果， 只有搜索成功时才会重新填写
+		NavMeshPath->CurrentPathCost = 0.f;
+		NavMeshPath->NumTileSteps = 0;
 
 		const FVector AdjustedEndLocation = NavFilter->GetAdjustedEndLocation(Query.EndLocation);
 		if ((Query.StartLocation - AdjustedEndLocation).IsNearlyZero() == true)
@@ -104,18 +107,8 @@ FPathFindingResult AGridPathFindingNavMesh::FindPath(const FNavAgentProperties&
 			// 中文：这里我们将存储从路径搜索器生成的路径
 			TArray<int32> PathIndices;
 			
-			// Initialization of the pathfinder, as you can see we pass our GraphAStarNavMesh as parameter,
-			// so internally it can use the functions we implemented.
-			// 中文：路径搜索器的初始化，正如你所看到的，我们将GraphAStarNavMesh作为参数传递，
-			FGraphAStar Pathfinder(*GraphAStarNavMesh);
-
-			// and run the A* algorithm, the FGraphAStar::FindPath function want a starting index, an ending index,
-			// the FGridPathFilter which want our GraphAStarNavMesh as parameter and a reference to the array where
-			// all the indices of our path will be stored
-			// 中文：并运行A*算法，FGraphAStar::FindPath函数需要一个起始索引，一个结束索引，
-			// FGridPathFilter需要我们的GraphAStarNavMesh作为参数，并引用存储我们路径所有索引的数组
-			// Todo: 寻路的时候，
 			auto Filter = FGridPathFilter(*GraphAStarNavMesh);
+			Filter.SearchMode = GraphAStarNavMesh->DefaultSearchMode;
 
 			// Todo: 增加一个接口， 然后实现身份标识的功能
 			if (Query.Owner.IsValid())
@@ -124,13 +117,34 @@ FPathFindingResult AGridPathFindingNavMesh::FindPath(const FNavAgentProperties&
 				{
 					// 如果有身份标识接口，设置过滤器的身份标识
 					Filter.Identifier = IdentifierInterface->GetGridPathFindingIdentifier();
+
+					const EGridPathSearchMode SearchMode = IdentifierInterface->GetGridPathSearchMode();
+					if (SearchMode != EGridPathSearchMode::Default)
+					{
+						Filter.SearchMode = SearchMode;
+					}
 				}
 			}
 			
 			Filter.StartIdx = StartIdx;
 			Filter.EndIdx = EndIdx;
 			// UE_LOG(LogHexAStar_NavMesh, Warning, TEXT("EndCCoord: %s, EndIdx: %d, Query.EndLocation: %s"), *EndCCoord.ToString(), EndIdx, *Query.EndLocation.ToString());
-			EGraphAStarResult AStarResult{ Pathfinder.FindPath(StartIdx, EndIdx, Filter, PathIndices) };
+
+			// Same start, goal and identifier on an unchanged map gives the same result, so try the cache first.
+			// 中文：地图没有变化时，相同起点、终点、身份标识的结果相同，优先使用缓存
+			UGridMapModel* MapModel = GraphAStarNavMesh->WeakMapModel.Get();
+			FGridPathCache& PathCache = MapModel->GetPathCache();
+			const FGridPathCacheKey CacheKey(StartIdx, EndIdx, Filter.Identifier, Filter.SearchMode);
+			EGraphAStarResult AStarResult;
+			float PathCost = 0.f;
+			if (!PathCache.Find(CacheKey, MapModel->GetTopologyVersion(), AStarResult, PathIndices, PathCost))
+			{
+				// FGridAStar directly addresses node data by tile index and reuses the per-thread workspace,
+				// so no node pool is allocated per query. Long queries may go through the chunk hierarchy first.
+				// 中文：FGridAStar按格子Index直接寻址节点数据，并复用当前线程的Workspace，每次查询不再分配节点池；距离较远时可能先使用分层寻路
+				AStarResult = MapModel->SearchPathIndices(Filter, StartIdx, EndIdx, PathIndices, PathCost);
+				PathCache.Add(CacheKey, MapModel->GetTopologyVersion(), AStarResult, PathIndices, PathCost);
+			}
 
 			// The FGraphAStar::FindPath return a EGraphAStarResult enum, we need to assign the right
 			// value to the FPathFindingResult (that is returned by AGraphAStarNavMesh::FindPath) based on this.
@@ -161,6 +175,7 @@ FPathFindingResult AGridPathFindingNavMesh::FindPath(const FNavAgentProperties&
 
 					// Search succeeded
 					Result.Result = ENavigationQueryResult::Success;
+					NavMeshPath->CurrentPathCost = PathCost;
 					
 					// PathIndices array computed by FGraphAStar will not contain the starting point, so
 					// we need to add it manually to the Path::PathPoints array
@@ -169,51 +184,10 @@ FPathFindingResult AGridPathFindingNavMesh::FindPath(const FNavAgentProperties&
 
 					// Let's traverse the PathIndices array and build the FNavPathPoints we 
 					// need to add to the Path.
-					// 中文：让我们遍历PathIndices数组并构建我们需要添加到路径的FNavPathPoints。
-					for (const int32 &PathIndex : PathIndices)
-					{
-						// Get a temporary Cube Coordinate from our HexGrid
-						// 中文：从我们的HexGrid获取一个临时立方体坐标
-						const FHCubeCoord GridCoord{ GraphAStarNavMesh->WeakMapModel->StableGetCoordByIndex(PathIndex) };
-
-						// Create a temporary FNavPathPoint
-						FNavPathPoint PathPoint{};
-
-						// Because we can create HexGrid with only Cube Coordinates and no tiles
-						// we look if the current index we are using is a valid index for the GridTiles array
-						// 中文：因为我们可以创建只有立方体坐标而没有瓦片的HexGrid
-						// 我们查看我们正在使用的当前索引是否是GridTiles数组的有效索引
-
-						// Todo: 这里可以用来做Z轴偏移
-						// if (GraphAStarNavMesh->WeakMapModel->GridTiles.IsValidIndex(PathIndex))
-						// {
-						// 	// If the index is valid (so we have a HexGrid with tiles) we compute the Location
-						// 	// of the PathPoint, we use the World Space coordinates of the current Cube Coordinate
-						// 	// as a base location then we add an offset to the Z.
-						// 	// How to compute the Z axis of the path is up to you, this is only an example!
-						// 	// 中文：如果索引有效（因此我们有一个带有瓦片的HexGrid）我们计算PathPoint的位置，
-						// 	// 我们使用当前立方体坐标的世界空间坐标作为基本位置，并在Z轴上添加一个偏移量。
-						// 	// 如何计算路径的Z轴取决于您，这只是一个示例！
-						// 	PathPoint.Location = GraphAStarNavMesh->WeakMapModel->StableCoordToWorld(GridCoord) +
-						// 		FVector(0.f, 0.f, GraphAStarNavMesh->WeakMapModel->GridTiles[PathIndex].Cost +
-						// 		GraphAStarNavMesh->PathPointZOffset);
-						// }
-						// else
-						// {
-						// 	// If the current PathIndex isn't a valid index for the GridTiles array
-						// 	// (so we assume our HexGrid is only a "logical" grid with only cube coordinates and no tiles)
-						// 	// we simply transform the coordinates from cube space to world space and pass it to the PathPoint
-						// 	// 中文：如果当前PathIndex不是GridTiles数组的有效索引（因此我们假设我们的HexGrid只是一个带有立方体坐标而没有瓦片的“逻辑”网格）
-						// 	// 我们只需将坐标从立方体空间转换为世界空间并将其传递给PathPoint
-						// 	
-						// }
-
-						PathPoint.Location = GraphAStarNavMesh->WeakMapModel->StableCoordToWorld(GridCoord);
-
-						// We finally add the computed PathPoint to the Path::PathPoints array
-						// 中文：我们最终将计算出的PathPoint添加到Path::PathPoints数组
-						Result.Path->GetPathPoints().Add(FNavPathPoint(PathPoint));
-					}
+					// 中文：让我们遍历PathIndices数组并构建我们需要添加到路径的FNavPathPoints， 可选地合并同方向、同高度的连续格子
+					AppendPathPoints(*MapModel, StartIdx, PathIndices, GraphAStarNavMesh->bMergeStraightPathSegments,
+					                 GraphAStarNavMesh->PathPointZOffset, Result.Path->GetPathPoints());
+					NavMeshPath->NumTileSteps = PathIndices.Num();
 
 					// We finished to create the Path so mark it as Ready.
 					// 中文：我们完成了创建路径，因此将其标记为Ready。
@@ -223,18 +197,46 @@ FPathFindingResult AGridPathFindingNavMesh::FindPath(const FNavAgentProperties&
 			// =========================== END OF OUR CODE ============================================================
 		}
 	}
-	
-	// // 获取结束时间
-	auto end = std::chrono::high_resolution_clock::now();
-	//
-	// // 计算并打印执行时间, 0.001毫秒级别寻路，稍长一点也只有0.05毫秒
-	auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
-	UE_LOG(LogTemp, Warning, TEXT("FindPath execution time: %lld microseconds"), duration.count());
-
 
 	return Result;
 }
 
+void AGridPathFindingNavMesh::AppendPathPoints(UGridMapModel& MapModel, int32 StartIndex, const TArray<int32>& PathIndices,
+                                               bool bMergeStraightSegments, float ZOffset, TArray<FNavPathPoint>& OutPathPoints)
+{
+	OutPathPoints.Reserve(OutPathPoints.Num() + PathIndices.Num());
+
+	FHCubeCoord PrevCoord = MapModel.StableGetCoordByIndex(StartIndex);
+	float PrevHeight = bMergeStraightSegments ? MapModel.GetTileHeightOffset(PrevCoord) : 0.f;
+	FHCubeCoord Coord = PathIndices.Num() > 0 ? MapModel.StableGetCoordByIndex(PathIndices[0]) : FHCubeCoord::Invalid;
+	float Height = bMergeStraightSegments && PathIndices.Num() > 0 ? MapModel.GetTileHeightOffset(Coord) : 0.f;
+
+	for (int32 PathStep = 0; PathStep < PathIndices.Num(); ++PathStep)
+	{
+		const bool bHasNext = PathStep + 1 < PathIndices.Num();
+		const FHCubeCoord NextCoord = bHasNext ? MapModel.StableGetCoordByIndex(PathIndices[PathStep + 1]) : FHCubeCoord::Invalid;
+
+		bool bSkip = false;
+		float NextHeight = 0.f;
+		if (bMergeStraightSegments && bHasNext)
+		{
+			NextHeight = MapModel.GetTileHeightOffset(NextCoord);
+			bSkip = Coord.QRS - PrevCoord.QRS == NextCoord.QRS - Coord.QRS && PrevHeight == Height && Height == NextHeight;
+		}
+
+		if (!bSkip)
+		{
+			const FVector Location = MapModel.StableCoordToWorld(Coord, false) + FVector(0.f, 0.f, ZOffset);
+			OutPathPoints.Add(FNavPathPoint(Location));
+		}
+
+		PrevCoord = Coord;
+		PrevHeight = Height;
+		Coord = NextCoord;
+		Height = NextHeight;
+	}
+}
+
 void AGridPathFindingNavMesh::SetMapModel(UGridMapModel* InMapModel)
 {
 	if (InMapModel)
@@ -279,6 +281,178 @@ void AGridPathFindingNavMesh::SetToStatic()
 	RuntimeGeneration = ERuntimeGenerationType::Static;
 }
 
+uint32 AGridPathFindingNavMesh::RequestPathAsync(int32 StartIndex, int32 EndIndex, int32 Identifier,
+                                                 FGridAsyncPathCompleteDelegate OnComplete)
+{
+	if (!WeakMapModel.IsValid() || GetWorld() == nullptr)
+	{
+		UE_LOG(LogGridPathFinding_NavMesh, Error, TEXT("RequestPathAsync: WeakMapModel is not valid!"));
+		return 0;
+	}
+
+	FAsyncPathQuery& Query = AsyncPathQueue.AddDefaulted_GetRef();
+	Query.RequestId = NextAsyncPathRequestId++;
+	if (NextAsyncPathRequestId == 0)
+	{
+		NextAsyncPathRequestId = 1;
+	}
+	Query.Request = FGridPathRequest(StartIndex, EndIndex, Identifier, EGridPathSearchMode::AStar);
+	Query.OnComplete = MoveTemp(OnComplete);
+
+	ScheduleAsyncPathProcessing();
+	return Query.RequestId;
+}
+
+bool AGridPathFindingNavMesh::CancelAsyncPath(uint32 RequestId)
+{
+	const int32 QueryIndex = AsyncPathQueue.IndexOfByPredicate([RequestId](const FAsyncPathQuery& Query)
+	{
+		return Query.RequestId == RequestId;
+	});
+
+	if (QueryIndex == INDEX_NONE)
+	{
+		return false;
+	}
+
+	if (QueryIndex == 0)
+	{
+		// 队首请求的搜索状态作废
+		AsyncPathfinder.Reset();
+	}
+
+	AsyncPathQueue.RemoveAt(QueryIndex);
+	return true;
+}
+
+void AGridPathFindingNavMesh::ScheduleAsyncPathProcessing()
+{
+	if (bAsyncPathProcessingScheduled || AsyncPathQueue.Num() == 0)
+	{
+		return;
+	}
+
+	bAsyncPathProcessingScheduled = true;
+	GetWorld()->GetTimerManager().SetTimerForNextTick(this, &AGridPathFindingNavMesh::ProcessAsyncPaths);
+}
+
+void AGridPathFindingNavMesh::ProcessAsyncPaths()
+{
+	bAsyncPathProcessingScheduled = false;
+
+	UGridMapModel* MapModel = WeakMapModel.Get();
+	if (MapModel == nullptr)
+	{
+		AsyncPathfinder.Reset();
+		AsyncPathQueue.Reset();
+		return;
+	}
+
+	if (MapModel->IsBuildingTilesData())
+	{
+		// 地图构建完成后重新开始
+		AsyncPathfinder.Reset();
+		ScheduleAsyncPathProcessing();
+		return;
+	}
+
+	int32 RemainingBudget = AsyncPathExpansionBudgetPerFrame;
+	while (AsyncPathQueue.Num() > 0 && RemainingBudget > 0)
+	{
+		FAsyncPathQuery& Query = AsyncPathQueue[0];
+
+		if (AsyncPathfinder.IsValid() &&
+			(AsyncPathTopologyVersion != MapModel->GetTopologyVersion() || AsyncPathNodeCount != MapModel->GetMaxValidIndex() + 1))
+		{
+			// 上次Step之后格子发生变化或地图被同步重建， 已展开的节点可能经过新的阻挡， 从头开始搜索
+			AsyncPathfinder.Reset();
+		}
+
+		bool bFinished;
+		if (!AsyncPathfinder.IsValid())
+		{
+			bFinished = BeginAsyncPath(*MapModel, Query);
+		}
+		else
+		{
+			FGridPathFilter Filter(*MapModel);
+			Filter.Identifier = Query.Request.Identifier;
+			Filter.SearchMode = EGridPathSearchMode::AStar;
+			// 两帧之间地标可能完成修复， 新建的Filter会改用地标启发， 已展开节点的F值就不再一致
+			Filter.Landmarks = Query.Landmarks;
+
+			const int32 ExpandedBefore = AsyncPathfinder->GetNumExpandedNodes();
+			bFinished = AsyncPathfinder->Step(Filter, RemainingBudget);
+			RemainingBudget -= FMath::Max(1, AsyncPathfinder->GetNumExpandedNodes() - ExpandedBefore);
+
+			if (bFinished)
+			{
+				FGridPathRequest& Request = Query.Request;
+				Request.Result = AsyncPathfinder->GetResult();
+				if (Request.Result == SearchSuccess || Filter.WantsPartialSolution())
+				{
+					AsyncPathfinder->BuildPath(Request.PathIndices);
+				}
+				Request.PathCost = Request.Result == SearchSuccess ? AsyncPathfinder->GetPathCost() : 0.f;
+				AsyncPathfinder.Reset();
+
+				// 地图变化时搜索已经重新开始， 结果一定对应当前版本
+				const FGridPathCacheKey CacheKey(Request.StartIndex, Request.EndIndex, Request.Identifier, Filter.SearchMode);
+				MapModel->GetPathCache().Add(CacheKey, AsyncPathTopologyVersion, Request.Result, Request.PathIndices, Request.PathCost);
+			}
+		}
+
+		if (bFinished)
+		{
+			// 回调中可能继续提交或取消请求， 先移出队列
+			FAsyncPathQuery Finished = MoveTemp(AsyncPathQueue[0]);
+			AsyncPathQueue.RemoveAt(0);
+			Finished.OnComplete.ExecuteIfBound(Finished.RequestId, Finished.Request);
+		}
+	}
+
+	ScheduleAsyncPathProcessing();
+}
+
+bool AGridPathFindingNavMesh::BeginAsyncPath(UGridMapModel& MapModel, FAsyncPathQuery& Query)
+{
+	FGridPathRequest& Request = Query.Request;
+	Request.PathIndices.Reset();
+	Request.PathCost = 0.f;
+
+	// 分帧寻路固定使用A*， Key中的搜索方式与ProcessAsyncPaths写入缓存时一致
+	const FGridPathCacheKey CacheKey(Request.StartIndex, Request.EndIndex, Request.Identifier, EGridPathSearchMode::AStar);
+	if (MapModel.GetPathCache().Find(CacheKey, MapModel.GetTopologyVersion(), Request.Result, Request.PathIndices, Request.PathCost))
+	{
+		return true;
+	}
+
+	const FGridConnectivity& Connectivity = MapModel.GetConnectivity();
+	if (GetDefault<UGridPathFindingSettings>()->bEnableConnectivityCheck && Connectivity.IsBuilt() &&
+		!Connectivity.AreConnected(MapModel, Request.StartIndex, Request.EndIndex))
+	{
+		Request.Result = GoalUnreachable;
+		return true;
+	}
+
+	FGridPathFilter Filter(MapModel);
+	Filter.Identifier = Request.Identifier;
+	Filter.SearchMode = EGridPathSearchMode::AStar;
+
+	AsyncPathfinder = MakeUnique<FGridAStar>(AsyncPathWorkspace);
+	if (!AsyncPathfinder->BeginSearch(Request.StartIndex, Request.EndIndex, Filter))
+	{
+		AsyncPathfinder.Reset();
+		Request.Result = SearchFail;
+		return true;
+	}
+
+	Query.Landmarks = Filter.Landmarks;
+	AsyncPathTopologyVersion = MapModel.GetTopologyVersion();
+	AsyncPathNodeCount = MapModel.GetMaxValidIndex() + 1;
+	return false;
+}
+
 //////////////////////////////////////////////////////////////////////////
 
 //==== FGridPathFilter functions implementation ===
@@ -310,7 +484,14 @@ FVector::FReal FGridPathFilter::GetHeuristicCost(const int32 StartNodeRef, const
 	 * 没有启发式函数：随机搜索所有方向
 	 * 有启发式函数：优先搜索朝向G的方向
 	 */
-	return GetDistanceByIndexUltraFast(StartNodeRef, EndNodeRef);
+	const int32 HexDistance = GetDistanceByIndexUltraFast(StartNodeRef, EndNodeRef);
+	if (Landmarks && Identifier == Landmarks->GetIdentifier())
+	{
+		// 每步Cost至少为1， 六边形距离本身也是下界， 取两者中较紧的一个
+		return FMath::Max(static_cast<float>(HexDistance), Landmarks->GetLowerBound(StartNodeRef, EndNodeRef));
+	}
+
+	return HexDistance;
 }
 
 // 内置函数寻路中调用GetTraversalCost时，两个格子总是邻居
@@ -332,7 +513,7 @@ FVector::FReal FGridPathFilter::GetTraversalCost(const int32 StartNodeRef, const
 	
 	// 1.f 为基础消耗， 防止0的出现
 	// return 1.f + HeightPenalty + ExtraPenalty;
-	return 1.f + NavMeshRef.WeakMapModel->GetTraversalCost(Identifier, StartNodeRef, EndNodeRef);
+	return 1.f + MapModel->GetTraversalCost(Identifier, StartNodeRef, EndNodeRef);
 }
 
 bool FGridPathFilter::IsTraversalAllowed(const int32 NodeA, const int32 NodeB) const
@@ -344,7 +525,7 @@ bool FGridPathFilter::IsTraversalAllowed(const int32 NodeA, const int32 NodeB) c
 	// 中文：如果NodeB是GridTiles数组的有效索引，我们返回bIsBlocking，否则我们假设我们可以遍历，所以我们返回true。
 	// 在这里，您可以执行更复杂的操作，例如使用线跟踪来查看是否有障碍物（例如敌人），在我们的示例中，我们只是使用简单的实现
 	// Todo: 检查该格子是否存在Tile信息， 判定是否可以通行
-	return NavMeshRef.WeakMapModel->CanTravelTo(NodeA, NodeB);
+	return MapModel->CanTravelTo(NodeA, NodeB);
 }
 
 bool FGridPathFilter::WantsPartialSolution() const
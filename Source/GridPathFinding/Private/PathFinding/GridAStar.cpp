@@ -0,0 +1,58 @@
+﻿#include "PathFinding/GridAStar.h"
+
+#include "Algo/Reverse.h"
+
+void FGridSearchWorkspace::BeginSearch(int32 NodeCount)
+{
+	if (GScores.Num() < NodeCount)
+	{
+		GScores.SetNumUninitialized(NodeCount);
+		ParentIndices.SetNumUninitialized(NodeCount);
+		// 新增部分置0， 不会与任何有效的Generation冲突
+		VisitedGenerations.SetNumZeroed(NodeCount);
+		ClosedGenerations.SetNumZeroed(NodeCount);
+	}
+
+	OpenHeap.Reset();
+
+	++SearchGeneration;
+	if (SearchGeneration == 0)
+	{
+		// Generation回绕， 只有这时才需要清空标记
+		FMemory::Memzero(VisitedGenerations.GetData(), VisitedGenerations.Num() * sizeof(uint32));
+		FMemory::Memzero(ClosedGenerations.GetData(), ClosedGenerations.Num() * sizeof(uint32));
+		SearchGeneration = 1;
+	}
+}
+
+FGridSearchWorkspace& FGridSearchWorkspace::GetThreadLocal()
+{
+	static thread_local FGridSearchWorkspace ThreadWorkspace;
+	return ThreadWorkspace;
+}
+
+void FGridAStar::BuildPath(TArray<int32>& OutPath) const
+{
+	OutPath.Reset();
+	if (BestNodeIndex == INDEX_NONE)
+	{
+		return;
+	}
+
+	for (int32 NodeIndex = BestNodeIndex; NodeIndex != StartIndex; NodeIndex = Workspace.ParentIndices[NodeIndex])
+	{
+		OutPath.Add(NodeIndex);
+	}
+
+	Algo::Reverse(OutPath);
+}
+
+float FGridAStar::GetPathCost() const
+{
+	if (BestNodeIndex == INDEX_NONE)
+	{
+		return 0.f;
+	}
+
+	return Workspace.GScores[BestNodeIndex];
+}
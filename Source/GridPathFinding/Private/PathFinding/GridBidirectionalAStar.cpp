@@ -0,0 +1,56 @@
+#include "PathFinding/GridBidirectionalAStar.h"
+
+#include "Algo/Reverse.h"
+
+namespace GridBidirectionalAStar
+{
+	// 正向搜索使用FGridSearchWorkspace::GetThreadLocal， 反向搜索需要另一份
+	FGridSearchWorkspace& GetThreadLocalBackwardWorkspace()
+	{
+		static thread_local FGridSearchWorkspace ThreadWorkspace;
+		return ThreadWorkspace;
+	}
+}
+
+FGridBidirectionalAStar::FGridBidirectionalAStar()
+	: ForwardWorkspace(FGridSearchWorkspace::GetThreadLocal()),
+	  BackwardWorkspace(GridBidirectionalAStar::GetThreadLocalBackwardWorkspace())
+{
+}
+
+void FGridBidirectionalAStar::BuildPath(TArray<int32>& OutPath) const
+{
+	OutPath.Reset();
+
+	const int32 LastForwardNode = MeetNodeIndex != INDEX_NONE ? MeetNodeIndex : BestNodeIndex;
+	if (LastForwardNode == INDEX_NONE)
+	{
+		return;
+	}
+
+	for (int32 NodeIndex = LastForwardNode; NodeIndex != StartIndex; NodeIndex = ForwardWorkspace.ParentIndices[NodeIndex])
+	{
+		OutPath.Add(NodeIndex);
+	}
+
+	Algo::Reverse(OutPath);
+
+	if (MeetNodeIndex != INDEX_NONE)
+	{
+		for (int32 NodeIndex = MeetNodeIndex; NodeIndex != EndIndex;)
+		{
+			NodeIndex = BackwardWorkspace.ParentIndices[NodeIndex];
+			OutPath.Add(NodeIndex);
+		}
+	}
+}
+
+float FGridBidirectionalAStar::GetPathCost() const
+{
+	if (MeetNodeIndex != INDEX_NONE)
+	{
+		return BestPathCost;
+	}
+
+	return BestNodeIndex != INDEX_NONE ? ForwardWorkspace.GScores[BestNodeIndex] : 0.f;
+}
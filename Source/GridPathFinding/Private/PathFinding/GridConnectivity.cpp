@@ -0,0 +1,308 @@
+#include "PathFinding/GridConnectivity.h"
+
+#include "GridMapModel.h"
+
+void FGridConnectivity::Build(const UGridMapModel& InMapModel)
+{
+	const int32 NodeCount = InMapModel.GetMaxValidIndex() + 1;
+	ComponentIds.Init(INDEX_NONE, NodeCount);
+	ComponentSizes.Reset();
+	NextComponentId = 0;
+
+	for (int32 TileIndex = 0; TileIndex < NodeCount; ++TileIndex)
+	{
+		if (ComponentIds[TileIndex] == INDEX_NONE && IsPassable(InMapModel, TileIndex))
+		{
+			const int32 NewId = NextComponentId++;
+			ComponentSizes.Add(NewId, Relabel(InMapModel, TileIndex, INDEX_NONE, NewId));
+		}
+	}
+}
+
+void FGridConnectivity::Reset()
+{
+	ComponentIds.Empty();
+	ComponentSizes.Empty();
+	NextComponentId = 0;
+}
+
+void FGridConnectivity::UpdateTile(const UGridMapModel& InMapModel, int32 TileIndex)
+{
+	if (!ComponentIds.IsValidIndex(TileIndex))
+	{
+		return;
+	}
+
+	const int32 OldId = ComponentIds[TileIndex];
+	const bool bPassable = IsPassable(InMapModel, TileIndex);
+	if (OldId == INDEX_NONE && bPassable)
+	{
+		MergeAround(InMapModel, TileIndex);
+	}
+	else if (OldId != INDEX_NONE && !bPassable)
+	{
+		SplitAround(InMapModel, TileIndex, OldId);
+	}
+}
+
+bool FGridConnectivity::AreConnected(const UGridMapModel& InMapModel, int32 StartIndex, int32 EndIndex) const
+{
+	const int32 EndId = GetComponentId(EndIndex);
+	if (EndId == INDEX_NONE)
+	{
+		// 终点被阻挡， 任何格子都无法进入
+		return StartIndex == EndIndex;
+	}
+
+	const int32 StartId = GetComponentId(StartIndex);
+	if (StartId != INDEX_NONE)
+	{
+		return StartId == EndId;
+	}
+
+	if (!ComponentIds.IsValidIndex(StartIndex))
+	{
+		return false;
+	}
+
+	for (int32 Direction = 0; Direction < 6; ++Direction)
+	{
+		const int32 NeighbourIndex = InMapModel.GetNeighborIndex(StartIndex, Direction);
+		if (NeighbourIndex != INDEX_NONE && ComponentIds[NeighbourIndex] == EndId)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool FGridConnectivity::IsPassable(const UGridMapModel& InMapModel, int32 TileIndex) const
+{
+	const FGridTileStore& TileStore = InMapModel.GetTileStore();
+	return TileStore.IsValidIndex(TileIndex) && !TileStore.IsBlocked(TileIndex);
+}
+
+int32 FGridConnectivity::Relabel(const UGridMapModel& InMapModel, int32 SeedIndex, int32 FromId, int32 ToId)
+{
+	TArray<int32> Stack;
+	Stack.Add(SeedIndex);
+	ComponentIds[SeedIndex] = ToId;
+	int32 Count = 0;
+
+	while (Stack.Num() > 0)
+	{
+		const int32 CurrentIndex = Stack.Pop(EAllowShrinking::No);
+		++Count;
+
+		for (int32 Direction = 0; Direction < 6; ++Direction)
+		{
+			const int32 NeighbourIndex = InMapModel.GetNeighborIndex(CurrentIndex, Direction);
+			if (NeighbourIndex == INDEX_NONE || ComponentIds[NeighbourIndex] != FromId)
+			{
+				continue;
+			}
+
+			// 首次标记时FromId为INDEX_NONE， 需要跳过阻挡的格子
+			if (FromId == INDEX_NONE && !IsPassable(InMapModel, NeighbourIndex))
+			{
+				continue;
+			}
+
+			ComponentIds[NeighbourIndex] = ToId;
+			Stack.Add(NeighbourIndex);
+		}
+	}
+
+	return Count;
+}
+
+void FGridConnectivity::MergeAround(const UGridMapModel& InMapModel, int32 TileIndex)
+{
+	TArray<int32, TInlineAllocator<6>> NeighbourIds;
+	TArray<int32, TInlineAllocator<6>> NeighbourSeeds;
+	for (int32 Direction = 0; Direction < 6; ++Direction)
+	{
+		const int32 NeighbourIndex = InMapModel.GetNeighborIndex(TileIndex, Direction);
+		const int32 NeighbourId = GetComponentId(NeighbourIndex);
+		if (NeighbourId != INDEX_NONE && !NeighbourIds.Contains(NeighbourId))
+		{
+			NeighbourIds.Add(NeighbourId);
+			NeighbourSeeds.Add(NeighbourIndex);
+		}
+	}
+
+	if (NeighbourIds.Num() == 0)
+	{
+		const int32 NewId = NextComponentId++;
+		ComponentIds[TileIndex] = NewId;
+		ComponentSizes.Add(NewId, 1);
+		return;
+	}
+
+	// 保留最大的区域， 其余区域并入其中
+	int32 KeepSlot = 0;
+	for (int32 Slot = 1; Slot < NeighbourIds.Num(); ++Slot)
+	{
+		if (ComponentSizes[NeighbourIds[Slot]] > ComponentSizes[NeighbourIds[KeepSlot]])
+		{
+			KeepSlot = Slot;
+		}
+	}
+
+	const int32 KeepId = NeighbourIds[KeepSlot];
+	int32& KeepSize = ComponentSizes[KeepId];
+	for (int32 Slot = 0; Slot < NeighbourIds.Num(); ++Slot)
+	{
+		if (Slot != KeepSlot)
+		{
+			KeepSize += Relabel(InMapModel, NeighbourSeeds[Slot], NeighbourIds[Slot], KeepId);
+			ComponentSizes.Remove(NeighbourIds[Slot]);
+		}
+	}
+
+	ComponentIds[TileIndex] = KeepId;
+	++ComponentSizes[KeepId];
+}
+
+void FGridConnectivity::SplitAround(const UGridMapModel& InMapModel, int32 TileIndex, int32 OldId)
+{
+	ComponentIds[TileIndex] = INDEX_NONE;
+	if (--ComponentSizes[OldId] == 0)
+	{
+		ComponentSizes.Remove(OldId);
+		return;
+	}
+
+	// 方向0-5在环上依次相邻， 同一段连续的邻居之间直接相连
+	bool bNeighbourInComponent[6];
+	int32 NeighbourIndices[6];
+	for (int32 Direction = 0; Direction < 6; ++Direction)
+	{
+		NeighbourIndices[Direction] = InMapModel.GetNeighborIndex(TileIndex, Direction);
+		bNeighbourInComponent[Direction] = GetComponentId(NeighbourIndices[Direction]) == OldId;
+	}
+
+	TArray<int32, TInlineAllocator<3>> RunSeeds;
+	for (int32 Direction = 0; Direction < 6; ++Direction)
+	{
+		if (bNeighbourInComponent[Direction] && !bNeighbourInComponent[(Direction + 5) % 6])
+		{
+			RunSeeds.Add(NeighbourIndices[Direction]);
+		}
+	}
+
+	if (RunSeeds.Num() <= 1)
+	{
+		return;
+	}
+
+	// 从每一段同时做BFS， 相遇的搜索合并为一组， 某一组先耗尽时就是被分割出来的区域
+	const int32 NumSearches = RunSeeds.Num();
+	TArray<TArray<int32>, TInlineAllocator<3>> Frontiers;
+	TArray<int32, TInlineAllocator<3>> GroupOf;
+	TArray<bool, TInlineAllocator<3>> GroupFinished;
+	TMap<int32, int32> VisitedOwners;
+	Frontiers.SetNum(NumSearches);
+	for (int32 Search = 0; Search < NumSearches; ++Search)
+	{
+		Frontiers[Search].Add(RunSeeds[Search]);
+		GroupOf.Add(Search);
+		GroupFinished.Add(false);
+		VisitedOwners.Add(RunSeeds[Search], Search);
+	}
+
+	auto FindGroup = [&GroupOf](int32 Search)
+	{
+		while (GroupOf[Search] != Search)
+		{
+			Search = GroupOf[Search];
+		}
+		return Search;
+	};
+
+	auto CountActiveGroups = [&]()
+	{
+		int32 Count = 0;
+		for (int32 Search = 0; Search < NumSearches; ++Search)
+		{
+			if (FindGroup(Search) == Search && !GroupFinished[Search])
+			{
+				++Count;
+			}
+		}
+		return Count;
+	};
+
+	while (CountActiveGroups() > 1)
+	{
+		for (int32 Search = 0; Search < NumSearches; ++Search)
+		{
+			if (Frontiers[Search].Num() == 0 || GroupFinished[FindGroup(Search)])
+			{
+				continue;
+			}
+
+			const int32 CurrentIndex = Frontiers[Search].Pop(EAllowShrinking::No);
+			for (int32 Direction = 0; Direction < 6; ++Direction)
+			{
+				const int32 NeighbourIndex = InMapModel.GetNeighborIndex(CurrentIndex, Direction);
+				if (NeighbourIndex == INDEX_NONE || ComponentIds[NeighbourIndex] != OldId)
+				{
+					continue;
+				}
+
+				if (const int32* Owner = VisitedOwners.Find(NeighbourIndex))
+				{
+					const int32 OwnerGroup = FindGroup(*Owner);
+					const int32 SearchGroup = FindGroup(Search);
+					if (OwnerGroup != SearchGroup)
+					{
+						GroupOf[OwnerGroup] = SearchGroup;
+					}
+					continue;
+				}
+
+				VisitedOwners.Add(NeighbourIndex, Search);
+				Frontiers[Search].Add(NeighbourIndex);
+			}
+		}
+
+		// 所有成员的Frontier都为空的组已经搜索完整个区域， 分配新的ID
+		for (int32 Group = 0; Group < NumSearches; ++Group)
+		{
+			if (FindGroup(Group) != Group || GroupFinished[Group])
+			{
+				continue;
+			}
+
+			bool bExhausted = true;
+			for (int32 Search = 0; Search < NumSearches; ++Search)
+			{
+				if (FindGroup(Search) == Group && Frontiers[Search].Num() > 0)
+				{
+					bExhausted = false;
+					break;
+				}
+			}
+
+			if (bExhausted && CountActiveGroups() > 1)
+			{
+				GroupFinished[Group] = true;
+
+				const int32 NewId = NextComponentId++;
+				int32 Count = 0;
+				for (const TPair<int32, int32>& Visited : VisitedOwners)
+				{
+					if (FindGroup(Visited.Value) == Group)
+					{
+						ComponentIds[Visited.Key] = NewId;
+						++Count;
+					}
+				}
+				ComponentSizes.Add(NewId, Count);
+				ComponentSizes[OldId] -= Count;
+			}
+		}
+	}
+}
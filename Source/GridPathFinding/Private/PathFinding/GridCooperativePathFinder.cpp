@@ -0,0 +1,230 @@
+#include "PathFinding/GridCooperativePathFinder.h"
+
+#include "GridMapModel.h"
+#include "GridPathFindingNavMesh.h"
+#include "Algo/Reverse.h"
+
+void FGridReservationTable::Initialize(int32 InNodeCount, int32 InWindowSize)
+{
+	NodeCount = InNodeCount;
+	WindowSize = InWindowSize;
+	Reservations.Reset();
+	Reservations.SetNum(NodeCount * (WindowSize + 1));
+	Round = 0;
+}
+
+void FGridReservationTable::BeginRound()
+{
+	++Round;
+	if (Round == 0)
+	{
+		// 轮次回绕， 只有这时才需要清空
+		for (FReservation& Reservation : Reservations)
+		{
+			Reservation = FReservation();
+		}
+		Round = 1;
+	}
+}
+
+void FGridReservationTable::Reserve(int32 TileIndex, int32 TimeStep, int32 AgentId)
+{
+	FReservation& Reservation = Reservations[GetSlot(TileIndex, TimeStep)];
+	Reservation.AgentId = AgentId;
+	Reservation.TimeStep = TimeStep;
+	Reservation.Round = Round;
+}
+
+void FGridCooperativePathFinder::Initialize(UGridMapModel& InMapModel, int32 InWindowSize)
+{
+	WeakMapModel = &InMapModel;
+	NodeCount = InMapModel.GetMaxValidIndex() + 1;
+	WindowSize = FMath::Max(1, InWindowSize);
+	ReservationTable.Initialize(NodeCount, WindowSize);
+}
+
+int32 FGridCooperativePathFinder::PlanPaths(TArrayView<FGridCooperativeAgent> Agents, int32 CurrentTimeStep)
+{
+	UGridMapModel* MapModel = WeakMapModel.Get();
+	if (MapModel == nullptr || MapModel->IsBuildingTilesData() || MapModel->GetMaxValidIndex() + 1 != NodeCount)
+	{
+		for (FGridCooperativeAgent& Agent : Agents)
+		{
+			Agent.PlannedTiles.Reset();
+			Agent.bReachesGoal = false;
+		}
+		return 0;
+	}
+
+	ReservationTable.BeginRound();
+
+	// 先预约所有单位当前所在的格子， 用于检测相邻单位互换位置
+	for (const FGridCooperativeAgent& Agent : Agents)
+	{
+		if (Agent.StartIndex >= 0 && Agent.StartIndex < NodeCount)
+		{
+			ReservationTable.Reserve(Agent.StartIndex, CurrentTimeStep, Agent.AgentId);
+		}
+	}
+
+	FGridPathFilter Filter(*MapModel);
+	int32 NumReachesGoal = 0;
+	for (FGridCooperativeAgent& Agent : Agents)
+	{
+		Filter.Identifier = Agent.Identifier;
+		PlanAgent(Filter, Agent, CurrentTimeStep);
+		ReservePath(Agent, CurrentTimeStep);
+		NumReachesGoal += Agent.bReachesGoal ? 1 : 0;
+	}
+
+	return NumReachesGoal;
+}
+
+bool FGridCooperativePathFinder::PlanAgent(const FGridPathFilter& Filter, FGridCooperativeAgent& Agent, int32 CurrentTimeStep)
+{
+	Agent.PlannedTiles.Reset();
+	Agent.bReachesGoal = false;
+
+	const int32 StartIndex = Agent.StartIndex;
+	const int32 GoalIndex = Agent.GoalIndex;
+	if (StartIndex < 0 || StartIndex >= NodeCount || GoalIndex < 0 || GoalIndex >= NodeCount)
+	{
+		return false;
+	}
+
+	const FGridSearchWorkspace::FOpenNodePredicate Predicate;
+	const float HeuristicScale = Filter.GetHeuristicScale();
+	const int32 NeighbourCount = Filter.GetNeighbourCount();
+
+	Workspace.BeginSearch(NodeCount * (WindowSize + 1));
+	Workspace.Visit(StartIndex, 0.f, INDEX_NONE);
+	Workspace.OpenHeap.HeapPush({HeuristicScale * static_cast<float>(Filter.GetHeuristicCost(StartIndex, GoalIndex)), StartIndex}, Predicate);
+
+	int32 TerminalState = INDEX_NONE;
+	while (Workspace.OpenHeap.Num() > 0)
+	{
+		FGridSearchWorkspace::FOpenNode Current;
+		Workspace.OpenHeap.HeapPop(Current, Predicate, EAllowShrinking::No);
+
+		const int32 CurrentState = Current.NodeIndex;
+		if (Workspace.IsClosed(CurrentState))
+		{
+			continue;
+		}
+		Workspace.Close(CurrentState);
+
+		const int32 Step = CurrentState / NodeCount;
+		const int32 TileIndex = CurrentState % NodeCount;
+
+		if (TileIndex == GoalIndex)
+		{
+			// 停在终点之后不能被其他单位的预约占用
+			bool bGoalFree = true;
+			for (int32 WaitStep = Step + 1; WaitStep <= WindowSize && bGoalFree; ++WaitStep)
+			{
+				bGoalFree = !ReservationTable.IsReservedByOther(GoalIndex, CurrentTimeStep + WaitStep, Agent.AgentId);
+			}
+
+			if (bGoalFree)
+			{
+				TerminalState = CurrentState;
+				Agent.bReachesGoal = true;
+				break;
+			}
+		}
+
+		if (Step == WindowSize)
+		{
+			// 窗口的末端， 剩余部分由启发值估计， 按G + H出堆的第一个即为最优
+			TerminalState = CurrentState;
+			break;
+		}
+
+		const float CurrentG = Workspace.GScores[CurrentState];
+		const int32 NextTimeStep = CurrentTimeStep + Step + 1;
+
+		// Direction == NeighbourCount 表示原地等待
+		for (int32 Direction = 0; Direction <= NeighbourCount; ++Direction)
+		{
+			const bool bWait = Direction == NeighbourCount;
+			const int32 NextTile = bWait ? TileIndex : Filter.GetNeighbour(TileIndex, Direction);
+			if (NextTile == INDEX_NONE)
+			{
+				continue;
+			}
+
+			const int32 NextState = (Step + 1) * NodeCount + NextTile;
+			if (Workspace.IsClosed(NextState) || HasConflict(TileIndex, NextTile, NextTimeStep - 1, Agent.AgentId))
+			{
+				continue;
+			}
+
+			FVector::FReal EdgeCost = WaitCost;
+			if (!bWait && !Filter.TryGetEdgeCost(TileIndex, Direction, NextTile, EdgeCost))
+			{
+				continue;
+			}
+
+			const float NewG = CurrentG + static_cast<float>(EdgeCost);
+			if (Workspace.IsVisited(NextState) && NewG >= Workspace.GScores[NextState])
+			{
+				continue;
+			}
+
+			Workspace.Visit(NextState, NewG, CurrentState);
+			Workspace.OpenHeap.HeapPush({NewG + HeuristicScale * static_cast<float>(Filter.GetHeuristicCost(NextTile, GoalIndex)), NextState}, Predicate);
+		}
+	}
+
+	if (TerminalState == INDEX_NONE)
+	{
+		return false;
+	}
+
+	for (int32 State = TerminalState; State != StartIndex; State = Workspace.ParentIndices[State])
+	{
+		Agent.PlannedTiles.Add(State % NodeCount);
+	}
+	Algo::Reverse(Agent.PlannedTiles);
+	return true;
+}
+
+bool FGridCooperativePathFinder::HasConflict(int32 FromIndex, int32 ToIndex, int32 TimeStep, int32 AgentId) const
+{
+	if (ReservationTable.IsReservedByOther(ToIndex, TimeStep + 1, AgentId))
+	{
+		return true;
+	}
+
+	if (FromIndex == ToIndex)
+	{
+		return false;
+	}
+
+	// 互换位置: 目标格子当前的单位下一步走到出发的格子
+	const int32 OtherAgent = ReservationTable.GetReservedAgent(ToIndex, TimeStep);
+	return OtherAgent != INDEX_NONE && OtherAgent != AgentId && ReservationTable.GetReservedAgent(FromIndex, TimeStep + 1) == OtherAgent;
+}
+
+void FGridCooperativePathFinder::ReservePath(const FGridCooperativeAgent& Agent, int32 CurrentTimeStep)
+{
+	if (Agent.StartIndex < 0 || Agent.StartIndex >= NodeCount)
+	{
+		return;
+	}
+
+	// 没有规划出路径时原地等待， 到达终点后停在终点， 都预约到窗口末端
+	int32 LastTile = Agent.StartIndex;
+	for (int32 Step = 1; Step <= WindowSize; ++Step)
+	{
+		if (Agent.PlannedTiles.IsValidIndex(Step - 1))
+		{
+			LastTile = Agent.PlannedTiles[Step - 1];
+		}
+
+		if (!ReservationTable.IsReservedByOther(LastTile, CurrentTimeStep + Step, Agent.AgentId))
+		{
+			ReservationTable.Reserve(LastTile, CurrentTimeStep + Step, Agent.AgentId);
+		}
+	}
+}
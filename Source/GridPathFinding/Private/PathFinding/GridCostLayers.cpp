@@ -0,0 +1,52 @@
+#include "PathFinding/GridCostLayers.h"
+
+#include "GridMapModel.h"
+#include "Async/ParallelFor.h"
+
+void FGridCostLayers::BuildLayer(UGridMapModel& InMapModel, int32 Identifier)
+{
+	const int32 NodeCount = InMapModel.GetMaxValidIndex() + 1;
+	TArray<float>& Layer = Layers.FindOrAdd(Identifier);
+	Layer.SetNumUninitialized(NodeCount * NumDirections);
+
+	float* LayerData = Layer.GetData();
+	ParallelFor(NodeCount, [&InMapModel, Identifier, LayerData](int32 TileIndex)
+	{
+		InMapModel.FillTileEdgeCosts(Identifier, TileIndex, TArrayView<float>(LayerData + TileIndex * NumDirections, NumDirections));
+	}, InMapModel.SupportsParallelPathQueries() ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread);
+}
+
+void FGridCostLayers::Reset()
+{
+	Layers.Empty();
+}
+
+void FGridCostLayers::UpdateTile(UGridMapModel& InMapModel, int32 TileIndex)
+{
+	if (TileIndex < 0 || TileIndex > InMapModel.GetMaxValidIndex())
+	{
+		return;
+	}
+
+	// 格子自身的出边， 以及相邻格子进入它的边
+	int32 AffectedTiles[NumDirections + 1];
+	int32 NumAffectedTiles = 0;
+	AffectedTiles[NumAffectedTiles++] = TileIndex;
+	for (int32 Direction = 0; Direction < NumDirections; ++Direction)
+	{
+		const int32 NeighbourIndex = InMapModel.GetNeighborIndex(TileIndex, Direction);
+		if (NeighbourIndex != INDEX_NONE)
+		{
+			AffectedTiles[NumAffectedTiles++] = NeighbourIndex;
+		}
+	}
+
+	for (TPair<int32, TArray<float>>& Pair : Layers)
+	{
+		for (int32 AffectedIndex = 0; AffectedIndex < NumAffectedTiles; ++AffectedIndex)
+		{
+			const int32 AffectedTile = AffectedTiles[AffectedIndex];
+			InMapModel.FillTileEdgeCosts(Pair.Key, AffectedTile, TArrayView<float>(Pair.Value.GetData() + AffectedTile * NumDirections, NumDirections));
+		}
+	}
+}
@@ -0,0 +1,259 @@
+#include "PathFinding/GridFieldOfView.h"
+
+#include "GridMapModel.h"
+#include "Algo/Unique.h"
+#include "Async/ParallelFor.h"
+
+namespace GridFieldOfView
+{
+	constexpr int32 NumSextants = 6;
+
+	// 扇区内的一层， 斜率0对应第0个格子， 1对应第Depth个格子
+	struct FRow
+	{
+		int32 Depth;
+		double StartSlope;
+		double EndSlope;
+	};
+
+	FORCEINLINE double GetTileStartSlope(int32 Depth, int32 Column)
+	{
+		return (2.0 * Column - 1.0) / (2.0 * Depth);
+	}
+
+	// 格子中心在区间内才可见， 保证结果对称
+	FORCEINLINE bool IsSymmetric(const FRow& Row, int32 Column)
+	{
+		return Column >= Row.Depth * Row.StartSlope && Column <= Row.Depth * Row.EndSlope;
+	}
+
+	FORCEINLINE int32 GetTileIndex(const UGridMapModel& InMapModel, const FHCubeCoord& Coord)
+	{
+		return InMapModel.IsCoordInMapArea(Coord) ? InMapModel.StableGetFullMapGridIterIndex(Coord) : INDEX_NONE;
+	}
+
+	/**
+	 * 扇区Sextant: 从Dir[Sextant]到Dir[Sextant + 1]之间， 第d层为 Source + Dir[Sextant] * d + Step * k, k∈[0, d]
+	 * 两个扇区的边界格子会被扫描两次
+	 */
+	template <typename TRevealFunc>
+	void ScanSextant(const UGridMapModel& InMapModel, const FGridFieldOfView& FieldOfView, const FHCubeCoord& SourceCoord,
+	                 int32 Sextant, int32 MaxDepth, TRevealFunc&& Reveal)
+	{
+		const FHCubeCoord Origin(0, 0, 0);
+		const FHCubeCoord Direction = InMapModel.GetNeighborCoord(Origin, Sextant);
+		const FHCubeCoord Step = InMapModel.GetNeighborCoord(Origin, (Sextant + 1) % NumSextants) - Direction;
+
+		TArray<FRow, TInlineAllocator<32>> Rows;
+		Rows.Add({1, 0.0, 1.0});
+		while (Rows.Num() > 0)
+		{
+			FRow Row = Rows.Pop(EAllowShrinking::No);
+			if (Row.Depth > MaxDepth)
+			{
+				continue;
+			}
+
+			const int32 MinColumn = FMath::Max(0, FMath::FloorToInt(Row.Depth * Row.StartSlope + 0.5));
+			const int32 MaxColumn = FMath::Min(Row.Depth, FMath::CeilToInt(Row.Depth * Row.EndSlope - 0.5));
+			const FHCubeCoord RowStart = SourceCoord + Direction * Row.Depth;
+
+			// 0: 没有上一个格子， 1: 上一个格子透明， 2: 上一个格子阻挡
+			int32 PrevState = 0;
+			for (int32 Column = MinColumn; Column <= MaxColumn; ++Column)
+			{
+				const int32 TileIndex = GetTileIndex(InMapModel, RowStart + Step * Column);
+				const bool bBlocking = TileIndex == INDEX_NONE || FieldOfView.IsBlockingSight(TileIndex);
+				if (TileIndex != INDEX_NONE && (bBlocking || IsSymmetric(Row, Column)))
+				{
+					Reveal(TileIndex);
+				}
+
+				if (PrevState == 2 && !bBlocking)
+				{
+					Row.StartSlope = GetTileStartSlope(Row.Depth, Column);
+				}
+				if (PrevState == 1 && bBlocking)
+				{
+					Rows.Add({Row.Depth + 1, Row.StartSlope, GetTileStartSlope(Row.Depth, Column)});
+				}
+				PrevState = bBlocking ? 2 : 1;
+			}
+
+			if (PrevState == 1)
+			{
+				Rows.Add({Row.Depth + 1, Row.StartSlope, Row.EndSlope});
+			}
+		}
+	}
+}
+
+void FGridFieldOfView::Build(UGridMapModel& InMapModel)
+{
+	const FGridMapConfig& MapConfig = InMapModel.GetMapConfig();
+	const bool bHexMap = MapConfig.MapType == EGridMapType::HEX_STANDARD || MapConfig.MapType == EGridMapType::RECTANGLE_SIX_DIRECTION;
+	if (!bHexMap || MapConfig.DrawMode != EGridMapDrawMode::BaseOnRowColumn)
+	{
+		Reset();
+		return;
+	}
+
+	check(NumBatchQueries.load() == 0);
+	const int32 NodeCount = InMapModel.GetMaxValidIndex() + 1;
+	BlocksSight.Init(false, NodeCount);
+	for (int32 TileIndex = 0; TileIndex < NodeCount; ++TileIndex)
+	{
+		BlocksSight[TileIndex] = InMapModel.IsTileBlockingSight(TileIndex);
+	}
+	++Version;
+}
+
+void FGridFieldOfView::Reset()
+{
+	check(NumBatchQueries.load() == 0);
+	BlocksSight.Empty();
+	++Version;
+
+	FScopeLock ScopeLock(&CacheLock);
+	CachedResults.Reset();
+}
+
+void FGridFieldOfView::UpdateTile(UGridMapModel& InMapModel, int32 TileIndex)
+{
+	if (!BlocksSight.IsValidIndex(TileIndex))
+	{
+		return;
+	}
+
+	const bool bBlocksSight = InMapModel.IsTileBlockingSight(TileIndex);
+	if (BlocksSight[TileIndex] != bBlocksSight)
+	{
+		check(NumBatchQueries.load() == 0);
+		BlocksSight[TileIndex] = bBlocksSight;
+		++Version;
+	}
+}
+
+void FGridFieldOfView::ComputeVisibleTiles(const UGridMapModel& InMapModel, int32 SourceIndex, int32 Radius, TArray<int32>& OutVisibleTiles)
+{
+	if (CachedResults.GetCapacity() <= 0)
+	{
+		ComputeVisibleTilesUncached(InMapModel, SourceIndex, Radius, OutVisibleTiles);
+		return;
+	}
+
+	const uint64 Key = static_cast<uint64>(static_cast<uint32>(SourceIndex)) << 32 | static_cast<uint32>(Radius);
+	{
+		FScopeLock ScopeLock(&CacheLock);
+		const uint32 CurrentVersion = Version.load();
+		if (CachedVersion != CurrentVersion)
+		{
+			CachedResults.Reset();
+			CachedVersion = CurrentVersion;
+		}
+
+		if (const TArray<int32>* CachedTiles = CachedResults.Find(Key))
+		{
+			OutVisibleTiles = *CachedTiles;
+			return;
+		}
+	}
+
+	const uint32 ComputeVersion = Version.load();
+	ComputeVisibleTilesUncached(InMapModel, SourceIndex, Radius, OutVisibleTiles);
+
+	FScopeLock ScopeLock(&CacheLock);
+	if (CachedVersion == ComputeVersion)
+	{
+		CachedResults.Add(Key, OutVisibleTiles);
+	}
+}
+
+void FGridFieldOfView::ComputeVisibleTilesBatch(const UGridMapModel& InMapModel, TArrayView<FGridVisibilityRequest> Requests)
+{
+	++NumBatchQueries;
+	ParallelFor(Requests.Num(), [this, &InMapModel, Requests](int32 RequestIndex)
+	{
+		FGridVisibilityRequest& Request = Requests[RequestIndex];
+		ComputeVisibleTiles(InMapModel, Request.SourceIndex, Request.Radius, Request.VisibleTiles);
+	});
+	--NumBatchQueries;
+}
+
+bool FGridFieldOfView::HasLineOfSight(const UGridMapModel& InMapModel, int32 FromIndex, int32 ToIndex) const
+{
+	if (!IsBuilt() || !BlocksSight.IsValidIndex(FromIndex) || !BlocksSight.IsValidIndex(ToIndex))
+	{
+		return false;
+	}
+
+	if (FromIndex == ToIndex)
+	{
+		return true;
+	}
+
+	const FHCubeCoord FromCoord = InMapModel.StableGetCoordByIndex(FromIndex);
+	const FHCubeCoord Offset = InMapModel.StableGetCoordByIndex(ToIndex) - FromCoord;
+	const int32 Distance = (FMath::Abs(Offset.QRS.X) + FMath::Abs(Offset.QRS.Y) + FMath::Abs(Offset.QRS.Z)) / 2;
+
+	// 目标在扇区边界上时属于两个扇区， 任意一个可见即可见
+	const FHCubeCoord Origin(0, 0, 0);
+	for (int32 Sextant = 0; Sextant < GridFieldOfView::NumSextants; ++Sextant)
+	{
+		const FHCubeCoord Direction = InMapModel.GetNeighborCoord(Origin, Sextant);
+		const FHCubeCoord Step = InMapModel.GetNeighborCoord(Origin, (Sextant + 1) % GridFieldOfView::NumSextants) - Direction;
+		const FHCubeCoord Remainder = Offset - Direction * Distance;
+
+		// Step的三个分量中有一个为0， 用非0分量求出列号再验证
+		const int32 Column = Step.QRS.X != 0 ? Remainder.QRS.X / Step.QRS.X : Remainder.QRS.Y / Step.QRS.Y;
+		if (Column < 0 || Column > Distance || Direction * Distance + Step * Column != Offset)
+		{
+			continue;
+		}
+
+		bool bVisible = false;
+		GridFieldOfView::ScanSextant(InMapModel, *this, FromCoord, Sextant, Distance, [ToIndex, &bVisible](int32 TileIndex)
+		{
+			bVisible |= TileIndex == ToIndex;
+		});
+		if (bVisible)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void FGridFieldOfView::SetMaxCacheEntries(int32 InMaxEntries)
+{
+	FScopeLock ScopeLock(&CacheLock);
+	CachedResults.SetCapacity(InMaxEntries);
+}
+
+void FGridFieldOfView::ComputeVisibleTilesUncached(const UGridMapModel& InMapModel, int32 SourceIndex, int32 Radius,
+                                                   TArray<int32>& OutVisibleTiles) const
+{
+	OutVisibleTiles.Reset();
+	if (!IsBuilt() || !BlocksSight.IsValidIndex(SourceIndex) || Radius < 0)
+	{
+		return;
+	}
+
+	// 半径R内最多 3R(R+1)+1 个格子
+	OutVisibleTiles.Reserve(3 * Radius * (Radius + 1) + 1);
+	OutVisibleTiles.Add(SourceIndex);
+
+	const FHCubeCoord SourceCoord = InMapModel.StableGetCoordByIndex(SourceIndex);
+	for (int32 Sextant = 0; Sextant < GridFieldOfView::NumSextants; ++Sextant)
+	{
+		GridFieldOfView::ScanSextant(InMapModel, *this, SourceCoord, Sextant, Radius, [&OutVisibleTiles](int32 TileIndex)
+		{
+			OutVisibleTiles.Add(TileIndex);
+		});
+	}
+
+	// 去掉扇区边界上重复的格子
+	OutVisibleTiles.Sort();
+	OutVisibleTiles.SetNum(Algo::Unique(OutVisibleTiles), EAllowShrinking::No);
+}
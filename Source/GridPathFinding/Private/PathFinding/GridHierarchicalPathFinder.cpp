@@ -0,0 +1,513 @@
+#include "PathFinding/GridHierarchicalPathFinder.h"
+
+#include "GridMapModel.h"
+#include "GridPathFindingNavMesh.h"
+#include "Algo/Reverse.h"
+#include "Async/ParallelFor.h"
+#include "Misc/ScopeRWLock.h"
+#include "PathFinding/GridAStar.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+namespace GridHierarchicalPathFinder
+{
+	// 边界上连续可通行的格子数量达到该值时， 在两端各放置一个入口
+	constexpr int32 LongRunLength = 6;
+}
+
+void FGridHierarchicalPathFinder::Initialize(UGridMapModel& InMapModel)
+{
+	FRWScopeLock ScopeLock(Lock, SLT_Write);
+
+	MapModel = &InMapModel;
+
+	const int32 NodeCount = MapModel->GetMaxValidIndex() + 1;
+	TileChunkIndices.SetNumUninitialized(NodeCount);
+	TileEntranceSlots.Init(INDEX_NONE, NodeCount);
+
+	int32 NumChunks = 0;
+	for (int32 TileIndex = 0; TileIndex < NodeCount; ++TileIndex)
+	{
+		const int32 ChunkIndex = MapModel->StableGetCoordChunkIndex(MapModel->StableGetCoordByIndex(TileIndex));
+		TileChunkIndices[TileIndex] = ChunkIndex;
+		NumChunks = FMath::Max(NumChunks, ChunkIndex + 1);
+	}
+
+	ChunkTiles.Empty(NumChunks);
+	ChunkTiles.SetNum(NumChunks);
+	for (int32 TileIndex = 0; TileIndex < NodeCount; ++TileIndex)
+	{
+		if (TileChunkIndices[TileIndex] != INDEX_NONE)
+		{
+			ChunkTiles[TileChunkIndices[TileIndex]].Add(TileIndex);
+		}
+	}
+
+	// 默认构造的FChunkGraph都是脏的， 第一次查询时才会构建
+	Chunks.Empty(NumChunks);
+	Chunks.SetNum(NumChunks);
+	bHasDirtyChunks = NumChunks > 0;
+}
+
+void FGridHierarchicalPathFinder::Reset()
+{
+	FRWScopeLock ScopeLock(Lock, SLT_Write);
+
+	MapModel = nullptr;
+	TileChunkIndices.Empty();
+	TileEntranceSlots.Empty();
+	ChunkTiles.Empty();
+	Chunks.Empty();
+	bHasDirtyChunks = false;
+}
+
+void FGridHierarchicalPathFinder::MarkTileDirty(int32 TileIndex)
+{
+	FRWScopeLock ScopeLock(Lock, SLT_Write);
+
+	if (!TileChunkIndices.IsValidIndex(TileIndex) || TileChunkIndices[TileIndex] == INDEX_NONE)
+	{
+		return;
+	}
+
+	// 边界格子的变化会影响相邻Chunk的入口和跨Chunk的边
+	Chunks[TileChunkIndices[TileIndex]].bDirty = true;
+	for (int32 Direction = 0; Direction < 6; ++Direction)
+	{
+		const int32 NeighbourIndex = MapModel->GetNeighborIndex(TileIndex, Direction);
+		if (NeighbourIndex != INDEX_NONE && TileChunkIndices[NeighbourIndex] != INDEX_NONE)
+		{
+			Chunks[TileChunkIndices[NeighbourIndex]].bDirty = true;
+		}
+	}
+
+	bHasDirtyChunks = true;
+}
+
+bool FGridHierarchicalPathFinder::ShouldUse(int32 StartIndex, int32 EndIndex, int32 MinDistance) const
+{
+	if (Chunks.Num() < 2 || !TileChunkIndices.IsValidIndex(StartIndex) || !TileChunkIndices.IsValidIndex(EndIndex))
+	{
+		return false;
+	}
+
+	const int32 StartChunk = TileChunkIndices[StartIndex];
+	const int32 EndChunk = TileChunkIndices[EndIndex];
+	if (StartChunk == INDEX_NONE || EndChunk == INDEX_NONE || StartChunk == EndChunk)
+	{
+		return false;
+	}
+
+	return MapModel->GetDistanceByIndex(StartIndex, EndIndex) >= MinDistance;
+}
+
+bool FGridHierarchicalPathFinder::TryFindPath(const FGridPathFilter& Filter, int32 StartIndex, int32 EndIndex,
+                                              TArray<int32>& OutPath, float& OutPathCost)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FGridHierarchicalPathFinder::TryFindPath);
+
+	// 大多数查询之间没有格子变化， 只读的查询不需要互相等待写锁
+	if (bHasDirtyChunks)
+	{
+		FRWScopeLock ScopeLock(Lock, SLT_Write);
+		RebuildDirtyChunks();
+	}
+
+	FRWScopeLock ScopeLock(Lock, SLT_ReadOnly);
+
+	if (!TileChunkIndices.IsValidIndex(StartIndex) || !TileChunkIndices.IsValidIndex(EndIndex))
+	{
+		return false;
+	}
+
+	const int32 StartChunk = TileChunkIndices[StartIndex];
+	const int32 EndChunk = TileChunkIndices[EndIndex];
+	if (StartChunk == INDEX_NONE || EndChunk == INDEX_NONE || StartChunk == EndChunk)
+	{
+		return false;
+	}
+
+	const FChunkGraph& StartGraph = Chunks[StartChunk];
+	const FChunkGraph& EndGraph = Chunks[EndChunk];
+	FGridSearchWorkspace& Workspace = FGridSearchWorkspace::GetThreadLocal();
+
+	// 起点到所在Chunk各个入口的Cost
+	TArray<float, TInlineAllocator<32>> StartCosts;
+	SearchInsideChunk(Filter, Workspace, StartChunk, StartIndex, false);
+	for (const int32 EntranceTile : StartGraph.EntranceTiles)
+	{
+		StartCosts.Add(Workspace.IsClosed(EntranceTile) ? Workspace.GScores[EntranceTile] : MAX_flt);
+	}
+
+	// 终点所在Chunk各个入口到终点的Cost
+	TArray<float, TInlineAllocator<32>> EndCosts;
+	SearchInsideChunk(Filter, Workspace, EndChunk, EndIndex, true);
+	for (const int32 EntranceTile : EndGraph.EntranceTiles)
+	{
+		EndCosts.Add(Workspace.IsClosed(EntranceTile) ? Workspace.GScores[EntranceTile] : MAX_flt);
+	}
+
+	// ---- 抽象图上的A*， 节点直接使用格子Index ----
+	struct FAbstractNodeRecord
+	{
+		float GScore;
+		int32 ParentTile;
+		bool bClosed;
+	};
+
+	TMap<int32, FAbstractNodeRecord> Records;
+	TArray<FGridSearchWorkspace::FOpenNode> OpenHeap;
+	const FGridSearchWorkspace::FOpenNodePredicate Predicate;
+	const float HeuristicScale = Filter.GetHeuristicScale();
+
+	auto Relax = [&](int32 FromTile, float FromG, int32 ToTile, float EdgeCost)
+	{
+		const float NewG = FromG + EdgeCost;
+		if (FAbstractNodeRecord* Record = Records.Find(ToTile))
+		{
+			if (Record->bClosed || NewG >= Record->GScore)
+			{
+				return;
+			}
+
+			Record->GScore = NewG;
+			Record->ParentTile = FromTile;
+		}
+		else
+		{
+			Records.Add(ToTile, FAbstractNodeRecord{NewG, FromTile, false});
+		}
+
+		OpenHeap.HeapPush({NewG + HeuristicScale * static_cast<float>(Filter.GetHeuristicCost(ToTile, EndIndex)), ToTile}, Predicate);
+	};
+
+	Records.Add(StartIndex, FAbstractNodeRecord{0.f, INDEX_NONE, false});
+	OpenHeap.HeapPush({0.f, StartIndex}, Predicate);
+
+	bool bReachedEnd = false;
+	while (OpenHeap.Num() > 0)
+	{
+		FGridSearchWorkspace::FOpenNode Current;
+		OpenHeap.HeapPop(Current, Predicate, EAllowShrinking::No);
+
+		const int32 CurrentTile = Current.NodeIndex;
+		FAbstractNodeRecord& CurrentRecord = Records.FindChecked(CurrentTile);
+		if (CurrentRecord.bClosed)
+		{
+			continue;
+		}
+
+		CurrentRecord.bClosed = true;
+		const float CurrentG = CurrentRecord.GScore;
+
+		if (CurrentTile == EndIndex)
+		{
+			bReachedEnd = true;
+			break;
+		}
+
+		if (CurrentTile == StartIndex)
+		{
+			for (int32 Slot = 0; Slot < StartCosts.Num(); ++Slot)
+			{
+				if (StartCosts[Slot] < MAX_flt)
+				{
+					Relax(CurrentTile, CurrentG, StartGraph.EntranceTiles[Slot], StartCosts[Slot]);
+				}
+			}
+		}
+
+		const int32 CurrentSlot = TileEntranceSlots[CurrentTile];
+		if (CurrentSlot == INDEX_NONE)
+		{
+			continue;
+		}
+
+		const int32 CurrentChunk = TileChunkIndices[CurrentTile];
+		const FChunkGraph& Graph = Chunks[CurrentChunk];
+		const int32 NumEntrances = Graph.EntranceTiles.Num();
+		for (int32 Slot = 0; Slot < NumEntrances; ++Slot)
+		{
+			const float IntraCost = Graph.IntraCosts[CurrentSlot * NumEntrances + Slot];
+			if (Slot != CurrentSlot && IntraCost < MAX_flt)
+			{
+				Relax(CurrentTile, CurrentG, Graph.EntranceTiles[Slot], IntraCost);
+			}
+		}
+
+		for (const FInterEdge& Edge : Graph.InterEdges[CurrentSlot])
+		{
+			Relax(CurrentTile, CurrentG, Edge.ToTileIndex, Edge.Cost);
+		}
+
+		if (CurrentChunk == EndChunk && EndCosts[CurrentSlot] < MAX_flt)
+		{
+			Relax(CurrentTile, CurrentG, EndIndex, EndCosts[CurrentSlot]);
+		}
+	}
+
+	if (!bReachedEnd)
+	{
+		return false;
+	}
+
+	TArray<int32> Waypoints;
+	for (int32 Tile = EndIndex; Tile != INDEX_NONE; Tile = Records.FindChecked(Tile).ParentTile)
+	{
+		Waypoints.Add(Tile);
+	}
+	Algo::Reverse(Waypoints);
+
+	// ---- 逐段细化， 相邻两个路点总是在同一个Chunk内或相邻的两个格子 ----
+	OutPath.Reset();
+	OutPathCost = 0.f;
+	TArray<int32> SegmentPath;
+	for (int32 WaypointIndex = 1; WaypointIndex < Waypoints.Num(); ++WaypointIndex)
+	{
+		FGridAStar Pathfinder(Workspace);
+		if (Pathfinder.FindPath(Waypoints[WaypointIndex - 1], Waypoints[WaypointIndex], Filter, SegmentPath) != SearchSuccess)
+		{
+			OutPath.Reset();
+			OutPathCost = 0.f;
+			return false;
+		}
+
+		OutPath.Append(SegmentPath);
+		OutPathCost += Pathfinder.GetPathCost();
+	}
+
+	return true;
+}
+
+void FGridHierarchicalPathFinder::RebuildDirtyChunks()
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FGridHierarchicalPathFinder::RebuildDirtyChunks);
+
+	if (!bHasDirtyChunks)
+	{
+		return;
+	}
+
+	TArray<int32> DirtyChunks;
+	for (int32 ChunkIndex = 0; ChunkIndex < Chunks.Num(); ++ChunkIndex)
+	{
+		if (Chunks[ChunkIndex].bDirty)
+		{
+			DirtyChunks.Add(ChunkIndex);
+		}
+	}
+
+	// 抽象图的Cost不区分身份标识
+	const FGridPathFilter BuildFilter(*MapModel);
+
+	// 每个Chunk只写入自己的数据和自己格子的TileEntranceSlots， 可以并行
+	ParallelFor(DirtyChunks.Num(), [this, &DirtyChunks, &BuildFilter](int32 Index)
+	{
+		RebuildChunk(BuildFilter, FGridSearchWorkspace::GetThreadLocal(), DirtyChunks[Index]);
+	}, MapModel->SupportsParallelPathQueries() ? EParallelForFlags::Unbalanced : EParallelForFlags::ForceSingleThread);
+
+	bHasDirtyChunks = false;
+}
+
+void FGridHierarchicalPathFinder::RebuildChunk(const FGridPathFilter& Filter, FGridSearchWorkspace& Workspace, int32 ChunkIndex)
+{
+	FChunkGraph& Graph = Chunks[ChunkIndex];
+	const int32 NeighbourCount = Filter.GetNeighbourCount();
+
+	for (const int32 EntranceTile : Graph.EntranceTiles)
+	{
+		TileEntranceSlots[EntranceTile] = INDEX_NONE;
+	}
+	Graph.EntranceTiles.Reset();
+	Graph.InterEdges.Reset();
+
+	TArray<int32, TInlineAllocator<8>> NeighbourChunks;
+	for (const int32 TileIndex : ChunkTiles[ChunkIndex])
+	{
+		for (int32 Direction = 0; Direction < NeighbourCount; ++Direction)
+		{
+			const int32 NeighbourIndex = Filter.GetNeighbour(TileIndex, Direction);
+			if (NeighbourIndex != INDEX_NONE && TileChunkIndices[NeighbourIndex] != ChunkIndex && TileChunkIndices[NeighbourIndex] != INDEX_NONE)
+			{
+				NeighbourChunks.AddUnique(TileChunkIndices[NeighbourIndex]);
+			}
+		}
+	}
+	NeighbourChunks.Sort();
+
+	TArray<FTransition> Transitions;
+	for (const int32 NeighbourChunk : NeighbourChunks)
+	{
+		const bool bIsMinSide = ChunkIndex < NeighbourChunk;
+		Transitions.Reset();
+		FindTransitions(Filter, FMath::Min(ChunkIndex, NeighbourChunk), FMath::Max(ChunkIndex, NeighbourChunk), Transitions);
+
+		for (const FTransition& Transition : Transitions)
+		{
+			const int32 LocalTile = bIsMinSide ? Transition.MinSideTile : Transition.MaxSideTile;
+			const int32 OtherTile = bIsMinSide ? Transition.MaxSideTile : Transition.MinSideTile;
+			const int32 Direction = bIsMinSide ? Transition.Direction : (Transition.Direction + NeighbourCount / 2) % NeighbourCount;
+
+			const int32 Slot = Graph.EntranceTiles.AddUnique(LocalTile);
+			if (Slot >= Graph.InterEdges.Num())
+			{
+				Graph.InterEdges.SetNum(Slot + 1);
+			}
+
+			FVector::FReal EdgeCost;
+			if (Filter.TryGetEdgeCost(LocalTile, Direction, OtherTile, EdgeCost))
+			{
+				Graph.InterEdges[Slot].Add({OtherTile, static_cast<float>(EdgeCost)});
+			}
+		}
+	}
+
+	const int32 NumEntrances = Graph.EntranceTiles.Num();
+	for (int32 Slot = 0; Slot < NumEntrances; ++Slot)
+	{
+		TileEntranceSlots[Graph.EntranceTiles[Slot]] = Slot;
+	}
+
+	Graph.IntraCosts.Init(MAX_flt, NumEntrances * NumEntrances);
+	for (int32 FromSlot = 0; FromSlot < NumEntrances; ++FromSlot)
+	{
+		SearchInsideChunk(Filter, Workspace, ChunkIndex, Graph.EntranceTiles[FromSlot], false);
+		for (int32 ToSlot = 0; ToSlot < NumEntrances; ++ToSlot)
+		{
+			const int32 ToTile = Graph.EntranceTiles[ToSlot];
+			if (Workspace.IsClosed(ToTile))
+			{
+				Graph.IntraCosts[FromSlot * NumEntrances + ToSlot] = Workspace.GScores[ToTile];
+			}
+		}
+	}
+
+	Graph.bDirty = false;
+}
+
+void FGridHierarchicalPathFinder::FindTransitions(const FGridPathFilter& Filter, int32 MinChunkIndex, int32 MaxChunkIndex,
+                                                  TArray<FTransition>& OutTransitions) const
+{
+	const int32 NeighbourCount = Filter.GetNeighbourCount();
+
+	// MinChunk中与MaxChunk相邻， 并且两个方向都可以通行的格子
+	TArray<int32, TInlineAllocator<64>> BorderTiles;
+	TArray<int32, TInlineAllocator<64>> BorderPartners;
+	TArray<int32, TInlineAllocator<64>> BorderDirections;
+	for (const int32 TileIndex : ChunkTiles[MinChunkIndex])
+	{
+		for (int32 Direction = 0; Direction < NeighbourCount; ++Direction)
+		{
+			const int32 NeighbourIndex = Filter.GetNeighbour(TileIndex, Direction);
+			if (NeighbourIndex == INDEX_NONE || TileChunkIndices[NeighbourIndex] != MaxChunkIndex)
+			{
+				continue;
+			}
+
+			if (Filter.IsTraversalAllowed(TileIndex, NeighbourIndex) && Filter.IsTraversalAllowed(NeighbourIndex, TileIndex))
+			{
+				BorderTiles.Add(TileIndex);
+				BorderPartners.Add(NeighbourIndex);
+				BorderDirections.Add(Direction);
+				break;
+			}
+		}
+	}
+
+	// 相邻的边界格子连成一段
+	TArray<bool, TInlineAllocator<64>> Visited;
+	Visited.SetNumZeroed(BorderTiles.Num());
+	TArray<int32, TInlineAllocator<64>> Run;
+	for (int32 Seed = 0; Seed < BorderTiles.Num(); ++Seed)
+	{
+		if (Visited[Seed])
+		{
+			continue;
+		}
+
+		Run.Reset();
+		Run.Add(Seed);
+		Visited[Seed] = true;
+		for (int32 Cursor = 0; Cursor < Run.Num(); ++Cursor)
+		{
+			for (int32 Direction = 0; Direction < NeighbourCount; ++Direction)
+			{
+				const int32 NeighbourIndex = Filter.GetNeighbour(BorderTiles[Run[Cursor]], Direction);
+				const int32 BorderIndex = NeighbourIndex == INDEX_NONE ? INDEX_NONE : BorderTiles.Find(NeighbourIndex);
+				if (BorderIndex != INDEX_NONE && !Visited[BorderIndex])
+				{
+					Visited[BorderIndex] = true;
+					Run.Add(BorderIndex);
+				}
+			}
+		}
+
+		auto AddTransition = [&](int32 BorderIndex)
+		{
+			OutTransitions.Add({BorderTiles[BorderIndex], BorderPartners[BorderIndex], BorderDirections[BorderIndex]});
+		};
+
+		if (Run.Num() < GridHierarchicalPathFinder::LongRunLength)
+		{
+			AddTransition(Run[Run.Num() / 2]);
+		}
+		else
+		{
+			AddTransition(Run[0]);
+			AddTransition(Run.Last());
+		}
+	}
+}
+
+void FGridHierarchicalPathFinder::SearchInsideChunk(const FGridPathFilter& Filter, FGridSearchWorkspace& Workspace,
+                                                    int32 ChunkIndex, int32 SourceIndex, bool bReverse) const
+{
+	const FGridSearchWorkspace::FOpenNodePredicate Predicate;
+	const int32 NeighbourCount = Filter.GetNeighbourCount();
+
+	Workspace.BeginSearch(TileChunkIndices.Num());
+	Workspace.Visit(SourceIndex, 0.f, INDEX_NONE);
+	Workspace.OpenHeap.HeapPush({0.f, SourceIndex}, Predicate);
+
+	while (Workspace.OpenHeap.Num() > 0)
+	{
+		FGridSearchWorkspace::FOpenNode Current;
+		Workspace.OpenHeap.HeapPop(Current, Predicate, EAllowShrinking::No);
+
+		const int32 CurrentIndex = Current.NodeIndex;
+		if (Workspace.IsClosed(CurrentIndex))
+		{
+			continue;
+		}
+
+		Workspace.Close(CurrentIndex);
+		const float CurrentG = Workspace.GScores[CurrentIndex];
+
+		for (int32 Direction = 0; Direction < NeighbourCount; ++Direction)
+		{
+			const int32 NeighbourIndex = Filter.GetNeighbour(CurrentIndex, Direction);
+			if (NeighbourIndex == INDEX_NONE || TileChunkIndices[NeighbourIndex] != ChunkIndex || Workspace.IsClosed(NeighbourIndex))
+			{
+				continue;
+			}
+
+			// 反向搜索时使用Neighbour -> Current这条边， 其方向与Direction相反
+			FVector::FReal EdgeCost;
+			const bool bAllowed = bReverse
+				                      ? Filter.TryGetEdgeCost(NeighbourIndex, (Direction + NeighbourCount / 2) % NeighbourCount, CurrentIndex, EdgeCost)
+				                      : Filter.TryGetEdgeCost(CurrentIndex, Direction, NeighbourIndex, EdgeCost);
+			if (!bAllowed)
+			{
+				continue;
+			}
+
+			const float NewG = CurrentG + static_cast<float>(EdgeCost);
+			if (Workspace.IsVisited(NeighbourIndex) && NewG >= Workspace.GScores[NeighbourIndex])
+			{
+				continue;
+			}
+
+			Workspace.Visit(NeighbourIndex, NewG, CurrentIndex);
+			Workspace.OpenHeap.HeapPush({NewG, NeighbourIndex}, Predicate);
+		}
+	}
+}
@@ -0,0 +1,363 @@
+#include "PathFinding/GridIncrementalPathPlanner.h"
+
+#include "GridMapModel.h"
+#include "GridPathFindingNavMesh.h"
+
+FGridIncrementalPathPlanner::~FGridIncrementalPathPlanner()
+{
+	Release();
+}
+
+void FGridIncrementalPathPlanner::Initialize(UGridMapModel& InMapModel, int32 InIdentifier)
+{
+	Release();
+
+	WeakMapModel = &InMapModel;
+	Identifier = InIdentifier;
+	TileNavDataDirtyHandle = InMapModel.OnTileNavDataDirty.AddRaw(this, &FGridIncrementalPathPlanner::OnTileNavDataDirty);
+	BuildCompleteHandle = InMapModel.OnTilesDataBuildComplete.AddRaw(this, &FGridIncrementalPathPlanner::OnTilesDataBuildComplete);
+	bNeedsReset = true;
+}
+
+void FGridIncrementalPathPlanner::Release()
+{
+	if (UGridMapModel* MapModel = WeakMapModel.Get())
+	{
+		MapModel->OnTileNavDataDirty.Remove(TileNavDataDirtyHandle);
+		MapModel->OnTilesDataBuildComplete.Remove(BuildCompleteHandle);
+	}
+
+	TileNavDataDirtyHandle.Reset();
+	BuildCompleteHandle.Reset();
+	WeakMapModel.Reset();
+	PathFilter.Reset();
+	States.Empty();
+	OpenHeap.Empty();
+	PendingTiles.Empty();
+	StartIndex = INDEX_NONE;
+	LastStartIndex = INDEX_NONE;
+	GoalIndex = INDEX_NONE;
+	KeyModifier = 0.f;
+	bNeedsReset = false;
+}
+
+void FGridIncrementalPathPlanner::SetGoal(int32 InGoalIndex)
+{
+	if (GoalIndex != InGoalIndex)
+	{
+		GoalIndex = InGoalIndex;
+		bNeedsReset = true;
+	}
+}
+
+void FGridIncrementalPathPlanner::SetStart(int32 InStartIndex)
+{
+	if (StartIndex == InStartIndex)
+	{
+		return;
+	}
+
+	StartIndex = InStartIndex;
+	if (LastStartIndex == INDEX_NONE || bNeedsReset || !PathFilter.IsValid())
+	{
+		LastStartIndex = StartIndex;
+		return;
+	}
+
+	// 已在Open列表中的Key是按旧起点计算的， 通过累加修正值保证其仍是下界
+	KeyModifier += GetHeuristic(LastStartIndex, StartIndex);
+	LastStartIndex = StartIndex;
+}
+
+EGraphAStarResult FGridIncrementalPathPlanner::Replan()
+{
+	NumExpandedNodes = 0;
+
+	UGridMapModel* MapModel = WeakMapModel.Get();
+	if (MapModel == nullptr || MapModel->IsBuildingTilesData())
+	{
+		return SearchFail;
+	}
+
+	if (bNeedsReset || !PathFilter.IsValid())
+	{
+		ResetSearch();
+	}
+
+	const int32 NodeCount = PathFilter->GetNodeCount();
+	if (StartIndex < 0 || StartIndex >= NodeCount || GoalIndex < 0 || GoalIndex >= NodeCount)
+	{
+		return SearchFail;
+	}
+
+	// 变化格子的出边， 以及相邻格子进入它的边都可能改变
+	for (const int32 TileIndex : PendingTiles)
+	{
+		if (TileIndex < 0 || TileIndex >= NodeCount)
+		{
+			continue;
+		}
+
+		UpdateVertex(TileIndex);
+		for (int32 Direction = 0; Direction < PathFilter->GetNeighbourCount(); ++Direction)
+		{
+			const int32 NeighbourIndex = PathFilter->GetNeighbour(TileIndex, Direction);
+			if (NeighbourIndex != INDEX_NONE)
+			{
+				UpdateVertex(NeighbourIndex);
+			}
+		}
+	}
+	PendingTiles.Reset();
+
+	ComputeShortestPath();
+
+	return GetG(StartIndex) < MAX_flt ? SearchSuccess : GoalUnreachable;
+}
+
+bool FGridIncrementalPathPlanner::GetPath(TArray<int32>& OutPath) const
+{
+	OutPath.Reset();
+
+	if (!PathFilter.IsValid() || StartIndex == INDEX_NONE || GetG(StartIndex) == MAX_flt)
+	{
+		return false;
+	}
+
+	// 每一步走向 Cost + G 最小的邻居， 步数不会超过访问过的节点数
+	int32 RemainingSteps = States.Num();
+	for (int32 CurrentIndex = StartIndex; CurrentIndex != GoalIndex;)
+	{
+		int32 BestIndex = INDEX_NONE;
+		float BestCost = MAX_flt;
+		for (int32 Direction = 0; Direction < PathFilter->GetNeighbourCount(); ++Direction)
+		{
+			const int32 NeighbourIndex = PathFilter->GetNeighbour(CurrentIndex, Direction);
+			if (NeighbourIndex == INDEX_NONE)
+			{
+				continue;
+			}
+
+			const float NeighbourG = GetG(NeighbourIndex);
+			const float EdgeCost = GetEdgeCost(CurrentIndex, Direction, NeighbourIndex);
+			if (NeighbourG == MAX_flt || EdgeCost == MAX_flt)
+			{
+				continue;
+			}
+
+			if (EdgeCost + NeighbourG < BestCost)
+			{
+				BestCost = EdgeCost + NeighbourG;
+				BestIndex = NeighbourIndex;
+			}
+		}
+
+		if (BestIndex == INDEX_NONE || --RemainingSteps < 0)
+		{
+			OutPath.Reset();
+			return false;
+		}
+
+		OutPath.Add(BestIndex);
+		CurrentIndex = BestIndex;
+	}
+
+	return true;
+}
+
+float FGridIncrementalPathPlanner::GetPathCost() const
+{
+	const float StartG = StartIndex != INDEX_NONE ? GetG(StartIndex) : MAX_flt;
+	return StartG < MAX_flt ? StartG : 0.f;
+}
+
+void FGridIncrementalPathPlanner::OnTileNavDataDirty(int32 TileIndex)
+{
+	PendingTiles.Add(TileIndex);
+}
+
+void FGridIncrementalPathPlanner::OnTilesDataBuildComplete()
+{
+	bNeedsReset = true;
+}
+
+void FGridIncrementalPathPlanner::ResetSearch()
+{
+	PathFilter = MakeUnique<FGridPathFilter>(*WeakMapModel.Get());
+	PathFilter->Identifier = Identifier;
+
+	States.Reset();
+	OpenHeap.Reset();
+	PendingTiles.Reset();
+	KeyModifier = 0.f;
+	LastStartIndex = StartIndex;
+	bNeedsReset = false;
+
+	if (GoalIndex < 0 || GoalIndex >= PathFilter->GetNodeCount())
+	{
+		return;
+	}
+
+	FNodeState& GoalState = States.Add(GoalIndex);
+	GoalState.Rhs = 0.f;
+	GoalState.Key = CalculateKey(GoalIndex, GoalState);
+	GoalState.bInOpen = true;
+	OpenHeap.HeapPush({GoalState.Key, GoalIndex}, FOpenNodePredicate());
+}
+
+float FGridIncrementalPathPlanner::GetHeuristic(int32 FromIndex, int32 ToIndex) const
+{
+	return PathFilter->GetHeuristicScale() * static_cast<float>(PathFilter->GetHeuristicCost(FromIndex, ToIndex));
+}
+
+float FGridIncrementalPathPlanner::GetEdgeCost(int32 FromIndex, int32 Direction, int32 ToIndex) const
+{
+	FVector::FReal EdgeCost;
+	if (!PathFilter->TryGetEdgeCost(FromIndex, Direction, ToIndex, EdgeCost))
+	{
+		return MAX_flt;
+	}
+
+	return static_cast<float>(EdgeCost);
+}
+
+FGridIncrementalPathPlanner::FKey FGridIncrementalPathPlanner::CalculateKey(int32 NodeIndex, const FNodeState& State) const
+{
+	const float MinG = FMath::Min(State.G, State.Rhs);
+	if (MinG == MAX_flt)
+	{
+		return FKey();
+	}
+
+	return {MinG + GetHeuristic(StartIndex, NodeIndex) + KeyModifier, MinG};
+}
+
+void FGridIncrementalPathPlanner::UpdateVertex(int32 NodeIndex)
+{
+	FNodeState* State = States.Find(NodeIndex);
+
+	if (NodeIndex != GoalIndex)
+	{
+		// Rhs为走一步到邻居后， 邻居到终点的最小Cost
+		float MinRhs = MAX_flt;
+		for (int32 Direction = 0; Direction < PathFilter->GetNeighbourCount(); ++Direction)
+		{
+			const int32 NeighbourIndex = PathFilter->GetNeighbour(NodeIndex, Direction);
+			if (NeighbourIndex == INDEX_NONE)
+			{
+				continue;
+			}
+
+			const float NeighbourG = GetG(NeighbourIndex);
+			if (NeighbourG == MAX_flt)
+			{
+				continue;
+			}
+
+			const float EdgeCost = GetEdgeCost(NodeIndex, Direction, NeighbourIndex);
+			if (EdgeCost != MAX_flt)
+			{
+				MinRhs = FMath::Min(MinRhs, EdgeCost + NeighbourG);
+			}
+		}
+
+		if (State == nullptr)
+		{
+			if (MinRhs == MAX_flt)
+			{
+				// 从未访问过且仍不可达， 不需要记录
+				return;
+			}
+			State = &States.Add(NodeIndex);
+		}
+
+		State->Rhs = MinRhs;
+	}
+	else if (State == nullptr)
+	{
+		return;
+	}
+
+	if (State->G != State->Rhs)
+	{
+		State->Key = CalculateKey(NodeIndex, *State);
+		State->bInOpen = true;
+		OpenHeap.HeapPush({State->Key, NodeIndex}, FOpenNodePredicate());
+	}
+	else
+	{
+		State->bInOpen = false;
+	}
+}
+
+void FGridIncrementalPathPlanner::ComputeShortestPath()
+{
+	const FOpenNodePredicate Predicate;
+
+	while (true)
+	{
+		CleanOpenTop();
+		if (OpenHeap.Num() == 0)
+		{
+			break;
+		}
+
+		const FNodeState StartState = States.FindRef(StartIndex);
+		if (!(OpenHeap.HeapTop().Key < CalculateKey(StartIndex, StartState)) && StartState.G == StartState.Rhs)
+		{
+			break;
+		}
+
+		FOpenNode Top;
+		OpenHeap.HeapPop(Top, Predicate, EAllowShrinking::No);
+
+		const int32 NodeIndex = Top.NodeIndex;
+		FNodeState& State = States.FindChecked(NodeIndex);
+		const FKey NewKey = CalculateKey(NodeIndex, State);
+		if (Top.Key < NewKey)
+		{
+			// 起点移动后Key变大， 重新入堆
+			State.Key = NewKey;
+			OpenHeap.HeapPush({NewKey, NodeIndex}, Predicate);
+			continue;
+		}
+
+		++NumExpandedNodes;
+
+		if (State.G > State.Rhs)
+		{
+			State.G = State.Rhs;
+			State.bInOpen = false;
+		}
+		else
+		{
+			State.G = MAX_flt;
+			UpdateVertex(NodeIndex);
+		}
+
+		// State在UpdateVertex中可能因为TMap扩容失效， 之后不再使用
+		for (int32 Direction = 0; Direction < PathFilter->GetNeighbourCount(); ++Direction)
+		{
+			const int32 NeighbourIndex = PathFilter->GetNeighbour(NodeIndex, Direction);
+			if (NeighbourIndex != INDEX_NONE)
+			{
+				UpdateVertex(NeighbourIndex);
+			}
+		}
+	}
+}
+
+void FGridIncrementalPathPlanner::CleanOpenTop()
+{
+	while (OpenHeap.Num() > 0)
+	{
+		const FOpenNode& Top = OpenHeap.HeapTop();
+		const FNodeState* State = States.Find(Top.NodeIndex);
+		if (State && State->bInOpen && State->Key == Top.Key)
+		{
+			return;
+		}
+
+		OpenHeap.HeapPopDiscard(FOpenNodePredicate(), EAllowShrinking::No);
+	}
+}
@@ -0,0 +1,253 @@
+#include "PathFinding/GridLandmarks.h"
+
+#include "GridMapModel.h"
+#include "GridPathFinding.h"
+#include "GridPathFindingNavMesh.h"
+#include "Async/ParallelFor.h"
+
+void FGridLandmarks::Build(UGridMapModel& InMapModel, int32 MemoryBudgetKB, int32 MaxLandmarkCount, int32 InIdentifier)
+{
+	Reset();
+	Identifier = InIdentifier;
+
+	FGridPathFilter Filter(InMapModel);
+	Filter.Identifier = Identifier;
+	const int32 NodeCount = Filter.GetNodeCount();
+	const FGridTileStore& TileStore = InMapModel.GetTileStore();
+	if (NodeCount <= 0 || TileStore.Num() < NodeCount)
+	{
+		return;
+	}
+
+	const int64 BytesPerLandmark = static_cast<int64>(NodeCount) * 2 * sizeof(float);
+	const int64 BudgetLandmarkCount = static_cast<int64>(MemoryBudgetKB) * 1024 / BytesPerLandmark;
+	const int32 LandmarkCount = static_cast<int32>(FMath::Min<int64>(MaxLandmarkCount, BudgetLandmarkCount));
+	if (LandmarkCount <= 0)
+	{
+		return;
+	}
+
+	int32 SeedIndex = INDEX_NONE;
+	for (int32 TileIndex = 0; TileIndex < NodeCount; ++TileIndex)
+	{
+		if (!TileStore.IsBlocked(TileIndex))
+		{
+			SeedIndex = TileIndex;
+			break;
+		}
+	}
+
+	if (SeedIndex == INDEX_NONE)
+	{
+		return;
+	}
+
+	NumLandmarks = LandmarkCount;
+	ForwardDistances.Init(MAX_flt, NodeCount * NumLandmarks);
+	BackwardDistances.Init(MAX_flt, NodeCount * NumLandmarks);
+
+	// 最远点选择: 每次选离已有路标最远的可通行格子， 其他连通区域中的格子距离为MAX_flt， 会被优先选中
+	TArray<float> MinDistances;
+	MinDistances.Init(MAX_flt, NodeCount);
+	int32 NextLandmark = SeedIndex;
+	for (int32 Slot = 0; Slot < NumLandmarks && NextLandmark != INDEX_NONE; ++Slot)
+	{
+		LandmarkTiles.Add(NextLandmark);
+		BuildSlot<false>(Filter, Slot);
+
+		NextLandmark = INDEX_NONE;
+		float FarthestDistance = 0.f;
+		for (int32 TileIndex = 0; TileIndex < NodeCount; ++TileIndex)
+		{
+			MinDistances[TileIndex] = FMath::Min(MinDistances[TileIndex], Distance(false, TileIndex, Slot));
+			if (MinDistances[TileIndex] > FarthestDistance && !TileStore.IsBlocked(TileIndex) && !LandmarkTiles.Contains(TileIndex))
+			{
+				FarthestDistance = MinDistances[TileIndex];
+				NextLandmark = TileIndex;
+			}
+		}
+	}
+
+	if (LandmarkTiles.Num() < NumLandmarks)
+	{
+		// 可通行的格子比路标数量少， 缩小数组
+		const int32 OldCount = NumLandmarks;
+		NumLandmarks = LandmarkTiles.Num();
+		for (int32 TileIndex = 0; TileIndex < NodeCount; ++TileIndex)
+		{
+			for (int32 Slot = 0; Slot < NumLandmarks; ++Slot)
+			{
+				ForwardDistances[TileIndex * NumLandmarks + Slot] = ForwardDistances[TileIndex * OldCount + Slot];
+			}
+		}
+		ForwardDistances.SetNum(NodeCount * NumLandmarks);
+		BackwardDistances.Init(MAX_flt, NodeCount * NumLandmarks);
+	}
+
+	// 每个路标写入各自的Slot， 可以并行
+	ParallelFor(NumLandmarks, [this, &Filter](int32 Slot)
+	{
+		BuildSlot<true>(Filter, Slot);
+	}, InMapModel.SupportsParallelPathQueries() ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread);
+
+	UE_LOG(LogGridPathFinding, Log, TEXT("[FGridLandmarks] Built %d landmarks for %d tiles, %lld KB"),
+	       NumLandmarks, NodeCount, BytesPerLandmark * NumLandmarks / 1024);
+}
+
+void FGridLandmarks::Reset()
+{
+	NumLandmarks = 0;
+	LandmarkTiles.Empty();
+	PendingTiles.Empty();
+	ForwardDistances.Empty();
+	BackwardDistances.Empty();
+}
+
+void FGridLandmarks::UpdateTile(int32 TileIndex)
+{
+	if (IsBuilt())
+	{
+		PendingTiles.Add(TileIndex);
+	}
+}
+
+void FGridLandmarks::FlushPendingRepairs(UGridMapModel& InMapModel)
+{
+	if (!IsBuilt() || PendingTiles.Num() == 0)
+	{
+		return;
+	}
+
+	FGridPathFilter Filter(InMapModel);
+	Filter.Identifier = Identifier;
+	const int32 NodeCount = Filter.GetNodeCount();
+
+	TArray<int32> RepairTiles;
+	RepairTiles.Reserve(PendingTiles.Num());
+	for (const int32 TileIndex : PendingTiles)
+	{
+		if (TileIndex >= 0 && TileIndex < NodeCount)
+		{
+			RepairTiles.Add(TileIndex);
+		}
+	}
+	PendingTiles.Reset();
+
+	// 所有变化的格子一起入堆， 每个路标只传播一次； 每个路标写入各自的Slot， 可以并行
+	ParallelFor(NumLandmarks, [this, &Filter, &RepairTiles](int32 Slot)
+	{
+		TArray<FOpenNode> OpenHeap;
+		for (const int32 TileIndex : RepairTiles)
+		{
+			SeedAroundTile<false>(Filter, Slot, TileIndex, OpenHeap);
+		}
+		Propagate<false>(Filter, Slot, OpenHeap);
+
+		for (const int32 TileIndex : RepairTiles)
+		{
+			SeedAroundTile<true>(Filter, Slot, TileIndex, OpenHeap);
+		}
+		Propagate<true>(Filter, Slot, OpenHeap);
+	}, InMapModel.SupportsParallelPathQueries() ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread);
+}
+
+template <bool bBackward>
+void FGridLandmarks::Propagate(const FGridPathFilter& Filter, int32 Slot, TArray<FOpenNode>& OpenHeap)
+{
+	const FOpenNodePredicate Predicate;
+	const int32 NeighbourCount = Filter.GetNeighbourCount();
+
+	while (OpenHeap.Num() > 0)
+	{
+		FOpenNode Current;
+		OpenHeap.HeapPop(Current, Predicate, EAllowShrinking::No);
+
+		const int32 CurrentIndex = Current.NodeIndex;
+		if (Current.Distance > Distance(bBackward, CurrentIndex, Slot))
+		{
+			continue;
+		}
+
+		for (int32 Direction = 0; Direction < NeighbourCount; ++Direction)
+		{
+			const int32 NeighbourIndex = Filter.GetNeighbour(CurrentIndex, Direction);
+			if (NeighbourIndex == INDEX_NONE)
+			{
+				continue;
+			}
+
+			FVector::FReal EdgeCost;
+			const bool bAllowed = bBackward
+				                      ? Filter.TryGetEdgeCost(NeighbourIndex, (Direction + NeighbourCount / 2) % NeighbourCount, CurrentIndex, EdgeCost)
+				                      : Filter.TryGetEdgeCost(CurrentIndex, Direction, NeighbourIndex, EdgeCost);
+			if (!bAllowed)
+			{
+				continue;
+			}
+
+			const float NewDistance = Current.Distance + static_cast<float>(EdgeCost);
+			float& NeighbourDistance = Distance(bBackward, NeighbourIndex, Slot);
+			if (NewDistance < NeighbourDistance)
+			{
+				NeighbourDistance = NewDistance;
+				OpenHeap.HeapPush({NewDistance, NeighbourIndex}, Predicate);
+			}
+		}
+	}
+}
+
+template <bool bBackward>
+void FGridLandmarks::SeedAroundTile(const FGridPathFilter& Filter, int32 Slot, int32 TileIndex, TArray<FOpenNode>& OpenHeap)
+{
+	const FOpenNodePredicate Predicate;
+	const int32 NeighbourCount = Filter.GetNeighbourCount();
+
+	// Forward时检查 From -> To 能否降低To的距离， Backward时检查能否降低From的距离
+	auto Relax = [this, &Filter, &OpenHeap, &Predicate, Slot](int32 FromIndex, int32 Direction, int32 ToIndex)
+	{
+		const int32 SourceIndex = bBackward ? ToIndex : FromIndex;
+		const int32 TargetIndex = bBackward ? FromIndex : ToIndex;
+		const float SourceDistance = Distance(bBackward, SourceIndex, Slot);
+		if (SourceDistance == MAX_flt)
+		{
+			return;
+		}
+
+		FVector::FReal EdgeCost;
+		if (!Filter.TryGetEdgeCost(FromIndex, Direction, ToIndex, EdgeCost))
+		{
+			return;
+		}
+
+		const float NewDistance = SourceDistance + static_cast<float>(EdgeCost);
+		float& TargetDistance = Distance(bBackward, TargetIndex, Slot);
+		if (NewDistance < TargetDistance)
+		{
+			TargetDistance = NewDistance;
+			OpenHeap.HeapPush({NewDistance, TargetIndex}, Predicate);
+		}
+	};
+
+	for (int32 Direction = 0; Direction < NeighbourCount; ++Direction)
+	{
+		const int32 NeighbourIndex = Filter.GetNeighbour(TileIndex, Direction);
+		if (NeighbourIndex == INDEX_NONE)
+		{
+			continue;
+		}
+
+		Relax(TileIndex, Direction, NeighbourIndex);
+		Relax(NeighbourIndex, (Direction + NeighbourCount / 2) % NeighbourCount, TileIndex);
+	}
+}
+
+template <bool bBackward>
+void FGridLandmarks::BuildSlot(const FGridPathFilter& Filter, int32 Slot)
+{
+	const int32 LandmarkIndex = LandmarkTiles[Slot];
+	Distance(bBackward, LandmarkIndex, Slot) = 0.f;
+
+	TArray<FOpenNode> OpenHeap;
+	OpenHeap.HeapPush({0.f, LandmarkIndex}, FOpenNodePredicate());
+	Propagate<bBackward>(Filter, Slot, OpenHeap);
+}
@@ -0,0 +1,64 @@
+#include "PathFinding/GridNavSnapshot.h"
+
+#include "PathFinding/GridAStar.h"
+
+namespace
+{
+	/**
+	 * 只读取快照数据的Filter， 满足FGridAStar的要求
+	 */
+	struct FGridNavSnapshotFilter
+	{
+		explicit FGridNavSnapshotFilter(const FGridNavSnapshot& InSnapshot) : Snapshot(InSnapshot)
+		{
+		}
+
+		FORCEINLINE int32 GetNodeCount() const { return Snapshot.NodeCount; }
+
+		FORCEINLINE int32 GetNeighbourCount() const { return FGridNavSnapshot::NumDirections; }
+
+		FORCEINLINE int32 GetNeighbour(const int32 NodeIndex, const int32 Direction) const
+		{
+			return Snapshot.GetNeighbour(NodeIndex, Direction);
+		}
+
+		FORCEINLINE FVector::FReal GetHeuristicScale() const { return 1.f; }
+
+		FORCEINLINE FVector::FReal GetHeuristicCost(const int32 StartIndex, const int32 EndIndex) const
+		{
+			return Snapshot.GetDistance(StartIndex, EndIndex);
+		}
+
+		FORCEINLINE bool TryGetEdgeCost(const int32 FromIndex, const int32 Direction, const int32 ToIndex, FVector::FReal& OutCost) const
+		{
+			const float EdgeCost = Snapshot.GetEdgeCost(FromIndex, Direction);
+			if (EdgeCost == MAX_flt)
+			{
+				return false;
+			}
+
+			OutCost = EdgeCost;
+			return true;
+		}
+
+		FORCEINLINE bool WantsPartialSolution() const { return true; }
+
+		const FGridNavSnapshot& Snapshot;
+	};
+}
+
+EGraphAStarResult FGridNavSnapshot::FindPath(int32 StartIndex, int32 EndIndex, TArray<int32>& OutPath, float& OutPathCost) const
+{
+	OutPathCost = 0.f;
+	if (!NeighborTable.IsValid())
+	{
+		OutPath.Reset();
+		return SearchFail;
+	}
+
+	const FGridNavSnapshotFilter Filter(*this);
+	FGridAStar Pathfinder;
+	const EGraphAStarResult Result = Pathfinder.FindPath(StartIndex, EndIndex, Filter, OutPath);
+	OutPathCost = Result == SearchSuccess ? Pathfinder.GetPathCost() : 0.f;
+	return Result;
+}
@@ -0,0 +1,101 @@
+#include "PathFinding/GridPagedTileIndex.h"
+
+void FGridPagedTileIndex::Build(const TArray<FIntPoint>& InAxialCoords)
+{
+	Reset();
+	if (InAxialCoords.Num() == 0)
+	{
+		return;
+	}
+
+	FIntPoint PageMin(MAX_int32, MAX_int32);
+	FIntPoint PageMax(MIN_int32, MIN_int32);
+	for (const FIntPoint& Axial : InAxialCoords)
+	{
+		const FIntPoint PageCoord(Axial.X >> PageShift, Axial.Y >> PageShift);
+		PageMin = PageMin.ComponentMin(PageCoord);
+		PageMax = PageMax.ComponentMax(PageCoord);
+	}
+
+	PageOrigin = PageMin;
+	PageTableSize = PageMax - PageMin + FIntPoint(1, 1);
+	PageTable.Init(INDEX_NONE, PageTableSize.X * PageTableSize.Y);
+
+	// 先标记用到的页， 再按页表顺序分配， Index顺序与输入顺序无关
+	for (const FIntPoint& Axial : InAxialCoords)
+	{
+		PageTable[((Axial.X >> PageShift) - PageOrigin.X) * PageTableSize.Y + (Axial.Y >> PageShift) - PageOrigin.Y] = 0;
+	}
+
+	for (int32 TableIndex = 0; TableIndex < PageTable.Num(); ++TableIndex)
+	{
+		if (PageTable[TableIndex] == INDEX_NONE)
+		{
+			continue;
+		}
+
+		PageTable[TableIndex] = Pages.Num();
+		FPage& Page = Pages.AddZeroed_GetRef();
+		Page.Origin = FIntPoint((PageOrigin.X + TableIndex / PageTableSize.Y) * PageSize, (PageOrigin.Y + TableIndex % PageTableSize.Y) * PageSize);
+	}
+
+	for (const FIntPoint& Axial : InAxialCoords)
+	{
+		FPage& Page = Pages[FindPage(Axial.X, Axial.Y)];
+		const int32 Slot = GetSlot(Axial.X, Axial.Y);
+		Page.Bits[Slot >> 6] |= 1ull << (Slot & 63);
+	}
+
+	int32 NextIndex = 0;
+	for (FPage& Page : Pages)
+	{
+		Page.FirstIndex = NextIndex;
+		for (int32 WordIndex = 0; WordIndex < PageWords; ++WordIndex)
+		{
+			Page.WordPrefix[WordIndex] = static_cast<uint16>(NextIndex - Page.FirstIndex);
+			NextIndex += static_cast<int32>(FMath::CountBits(Page.Bits[WordIndex]));
+		}
+	}
+
+	IndexToAxial.SetNumUninitialized(NextIndex);
+	int32 TileIndex = 0;
+	for (const FPage& Page : Pages)
+	{
+		for (int32 WordIndex = 0; WordIndex < PageWords; ++WordIndex)
+		{
+			uint64 Word = Page.Bits[WordIndex];
+			while (Word != 0)
+			{
+				const int32 Slot = WordIndex * 64 + static_cast<int32>(FMath::CountTrailingZeros64(Word));
+				Word &= Word - 1;
+				IndexToAxial[TileIndex++] = Page.Origin + FIntPoint(Slot >> PageShift, Slot & PageMask);
+			}
+		}
+	}
+}
+
+void FGridPagedTileIndex::Reset()
+{
+	PageOrigin = FIntPoint::ZeroValue;
+	PageTableSize = FIntPoint::ZeroValue;
+	PageTable.Reset();
+	Pages.Reset();
+	IndexToAxial.Reset();
+}
+
+void FGridPagedTileIndex::GetPageTiles(int32 PageIndex, TArray<FIntPoint>& OutAxialCoords) const
+{
+	if (!Pages.IsValidIndex(PageIndex))
+	{
+		return;
+	}
+
+	const int32 StartIndex = Pages[PageIndex].FirstIndex;
+	const int32 EndIndex = Pages.IsValidIndex(PageIndex + 1) ? Pages[PageIndex + 1].FirstIndex : IndexToAxial.Num();
+	OutAxialCoords.Append(IndexToAxial.GetData() + StartIndex, EndIndex - StartIndex);
+}
+
+SIZE_T FGridPagedTileIndex::GetAllocatedSize() const
+{
+	return PageTable.GetAllocatedSize() + Pages.GetAllocatedSize() + IndexToAxial.GetAllocatedSize();
+}
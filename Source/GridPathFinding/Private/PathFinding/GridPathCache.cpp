@@ -0,0 +1,74 @@
+﻿#include "PathFinding/GridPathCache.h"
+
+bool FGridPathCache::Find(const FGridPathCacheKey& Key, uint32 CurrentVersion, EGraphAStarResult& OutResult,
+                          TArray<int32>& OutPathIndices, float& OutPathCost)
+{
+	if (!IsEnabled())
+	{
+		return false;
+	}
+
+	FScopeLock ScopeLock(&Lock);
+	DropStaleEntries(CurrentVersion);
+
+	const FEntry* Entry = Entries.Find(Key);
+	if (Entry == nullptr)
+	{
+		++MissCount;
+		return false;
+	}
+
+	++HitCount;
+	OutResult = Entry->Result;
+	OutPathIndices = Entry->PathIndices;
+	OutPathCost = Entry->PathCost;
+	return true;
+}
+
+void FGridPathCache::Add(const FGridPathCacheKey& Key, uint32 CurrentVersion, EGraphAStarResult InResult,
+                         const TArray<int32>& InPathIndices, float InPathCost)
+{
+	if (!IsEnabled())
+	{
+		return;
+	}
+
+	FScopeLock ScopeLock(&Lock);
+	DropStaleEntries(CurrentVersion);
+
+	FEntry Entry;
+	Entry.Result = InResult;
+	Entry.PathIndices = InPathIndices;
+	Entry.PathCost = InPathCost;
+	Entries.Add(Key, Entry);
+}
+
+void FGridPathCache::Reset()
+{
+	FScopeLock ScopeLock(&Lock);
+	Entries.Reset();
+	HitCount = 0;
+	MissCount = 0;
+}
+
+void FGridPathCache::SetMaxEntries(int32 InMaxEntries)
+{
+	FScopeLock ScopeLock(&Lock);
+	MaxEntries = FMath::Max(0, InMaxEntries);
+	Entries.SetCapacity(MaxEntries);
+}
+
+int32 FGridPathCache::GetNumEntries() const
+{
+	FScopeLock ScopeLock(&Lock);
+	return Entries.Num();
+}
+
+void FGridPathCache::DropStaleEntries(uint32 CurrentVersion)
+{
+	if (EntriesVersion != CurrentVersion)
+	{
+		Entries.Reset();
+		EntriesVersion = CurrentVersion;
+	}
+}
@@ -0,0 +1,225 @@
+#include "PathFinding/GridPathTelemetry.h"
+
+#include "GridPathFinding.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+namespace GridPathTelemetry
+{
+	bool bEnabled = false;
+
+	// 关闭GRID_PATH_TELEMETRY时不注册控制台变量与命令， 统计接口仍可直接调用
+#if GRID_PATH_TELEMETRY
+	FAutoConsoleVariableRef CVarEnabled(
+		TEXT("GridPathFinding.Telemetry"),
+		bEnabled,
+		TEXT("开启寻路统计, 使用 GridPathFinding.Telemetry.Dump/Reset/ExportCsv 查看"));
+#endif
+
+	struct FIdentifierStats
+	{
+		int64 NumQueries = 0;
+		int64 NumSuccess = 0;
+		int64 NumGoalUnreachable = 0;
+		int64 NumInfiniteLoop = 0;
+		int64 NumSearchFail = 0;
+		int64 NumRejectedByConnectivity = 0;
+		int64 NumHierarchical = 0;
+		int64 TotalExpandedNodes = 0;
+		int32 MaxExpandedNodes = 0;
+		int32 PeakOpenNodes = 0;
+		double TotalMicroseconds = 0.0;
+		double MaxMicroseconds = 0.0;
+		int64 LatencyHistogram[FGridPathTelemetry::NumLatencyBuckets] = {};
+	};
+
+	FCriticalSection Lock;
+
+	// Key为身份标识
+	TMap<int32, FIdentifierStats> StatsByIdentifier;
+
+	FString GetBucketName(int32 Bucket)
+	{
+		if (Bucket == FGridPathTelemetry::NumLatencyBuckets - 1)
+		{
+			return FString::Printf(TEXT(">=%dus"), 1 << (Bucket - 1));
+		}
+
+		return FString::Printf(TEXT("<%dus"), 1 << Bucket);
+	}
+
+	/**
+	 * 在持有Lock时复制一份， 输出时不阻塞记录
+	 */
+	TArray<TPair<int32, FIdentifierStats>> CopySortedStats()
+	{
+		TArray<TPair<int32, FIdentifierStats>> SortedStats;
+		{
+			FScopeLock ScopeLock(&Lock);
+			SortedStats.Reserve(StatsByIdentifier.Num());
+			for (const TPair<int32, FIdentifierStats>& Pair : StatsByIdentifier)
+			{
+				SortedStats.Add(Pair);
+			}
+		}
+
+		SortedStats.Sort([](const TPair<int32, FIdentifierStats>& A, const TPair<int32, FIdentifierStats>& B)
+		{
+			return A.Key < B.Key;
+		});
+		return SortedStats;
+	}
+
+#if GRID_PATH_TELEMETRY
+	FAutoConsoleCommandWithOutputDevice DumpCommand(
+		TEXT("GridPathFinding.Telemetry.Dump"),
+		TEXT("输出寻路统计"),
+		FConsoleCommandWithOutputDeviceDelegate::CreateStatic(&FGridPathTelemetry::Dump));
+
+	FAutoConsoleCommand ResetCommand(
+		TEXT("GridPathFinding.Telemetry.Reset"),
+		TEXT("清空寻路统计"),
+		FConsoleCommandDelegate::CreateStatic(&FGridPathTelemetry::Reset));
+
+	FAutoConsoleCommand ExportCsvCommand(
+		TEXT("GridPathFinding.Telemetry.ExportCsv"),
+		TEXT("导出寻路统计为CSV, 参数为文件路径, 省略时写到Saved/Profiling/GridPathFinding/"),
+		FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+		{
+			const FString FilePath = Args.Num() > 0
+				                         ? Args[0]
+				                         : FPaths::ProfilingDir() / TEXT("GridPathFinding") /
+				                         FString::Printf(TEXT("GridPathTelemetry-%s.csv"), *FDateTime::Now().ToString());
+			if (FGridPathTelemetry::ExportCsv(FilePath))
+			{
+				UE_LOG(LogGridPathFinding, Log, TEXT("[GridPathTelemetry] 已导出到 %s"), *FilePath);
+			}
+			else
+			{
+				UE_LOG(LogGridPathFinding, Error, TEXT("[GridPathTelemetry] 导出失败: %s"), *FilePath);
+			}
+		}));
+#endif
+}
+
+bool FGridPathTelemetry::IsEnabled()
+{
+	return GridPathTelemetry::bEnabled;
+}
+
+void FGridPathTelemetry::RecordQuery(const FGridPathQueryStats& Stats)
+{
+	using namespace GridPathTelemetry;
+
+	const int32 Bucket = GetLatencyBucket(Stats.Microseconds);
+
+	FScopeLock ScopeLock(&Lock);
+	FIdentifierStats& IdentifierStats = StatsByIdentifier.FindOrAdd(Stats.Identifier);
+	++IdentifierStats.NumQueries;
+	switch (Stats.Result)
+	{
+	case SearchSuccess:
+		++IdentifierStats.NumSuccess;
+		break;
+	case GoalUnreachable:
+		++IdentifierStats.NumGoalUnreachable;
+		break;
+	case InfiniteLoop:
+		++IdentifierStats.NumInfiniteLoop;
+		break;
+	default:
+		++IdentifierStats.NumSearchFail;
+		break;
+	}
+
+	IdentifierStats.NumRejectedByConnectivity += Stats.bRejectedByConnectivity ? 1 : 0;
+	IdentifierStats.NumHierarchical += Stats.bHierarchical ? 1 : 0;
+	IdentifierStats.TotalExpandedNodes += Stats.NumExpandedNodes;
+	IdentifierStats.MaxExpandedNodes = FMath::Max(IdentifierStats.MaxExpandedNodes, Stats.NumExpandedNodes);
+	IdentifierStats.PeakOpenNodes = FMath::Max(IdentifierStats.PeakOpenNodes, Stats.PeakOpenNodes);
+	IdentifierStats.TotalMicroseconds += Stats.Microseconds;
+	IdentifierStats.MaxMicroseconds = FMath::Max(IdentifierStats.MaxMicroseconds, Stats.Microseconds);
+	++IdentifierStats.LatencyHistogram[Bucket];
+}
+
+void FGridPathTelemetry::Reset()
+{
+	FScopeLock ScopeLock(&GridPathTelemetry::Lock);
+	GridPathTelemetry::StatsByIdentifier.Reset();
+}
+
+void FGridPathTelemetry::Dump(FOutputDevice& Ar)
+{
+	using namespace GridPathTelemetry;
+
+	const TArray<TPair<int32, FIdentifierStats>> SortedStats = CopySortedStats();
+	if (SortedStats.Num() == 0)
+	{
+		Ar.Logf(TEXT("[GridPathTelemetry] 没有记录, 是否已开启 GridPathFinding.Telemetry ?"));
+		return;
+	}
+
+	for (const TPair<int32, FIdentifierStats>& Pair : SortedStats)
+	{
+		const FIdentifierStats& Stats = Pair.Value;
+		const double NumQueries = FMath::Max<int64>(Stats.NumQueries, 1);
+		Ar.Logf(TEXT("[GridPathTelemetry] Identifier %d: %lld次, 成功%lld 不可达%lld(连通区域%lld) 失败%lld 死循环%lld 分层%lld"),
+		        Pair.Key, Stats.NumQueries, Stats.NumSuccess, Stats.NumGoalUnreachable, Stats.NumRejectedByConnectivity,
+		        Stats.NumSearchFail, Stats.NumInfiniteLoop, Stats.NumHierarchical);
+		Ar.Logf(TEXT("    展开节点 平均%.1f 最大%d, Open列表峰值%d, 耗时 平均%.2fus 最大%.2fus"),
+		        Stats.TotalExpandedNodes / NumQueries, Stats.MaxExpandedNodes, Stats.PeakOpenNodes,
+		        Stats.TotalMicroseconds / NumQueries, Stats.MaxMicroseconds);
+
+		FString Histogram;
+		for (int32 Bucket = 0; Bucket < NumLatencyBuckets; ++Bucket)
+		{
+			if (Stats.LatencyHistogram[Bucket] > 0)
+			{
+				Histogram += FString::Printf(TEXT(" %s:%lld"), *GetBucketName(Bucket), Stats.LatencyHistogram[Bucket]);
+			}
+		}
+		Ar.Logf(TEXT("    耗时分布%s"), *Histogram);
+	}
+}
+
+bool FGridPathTelemetry::ExportCsv(const FString& FilePath)
+{
+	using namespace GridPathTelemetry;
+
+	FString Csv = TEXT("Identifier,Queries,Success,GoalUnreachable,RejectedByConnectivity,SearchFail,InfiniteLoop,Hierarchical,")
+		TEXT("AvgExpandedNodes,MaxExpandedNodes,PeakOpenNodes,AvgMicroseconds,MaxMicroseconds");
+	for (int32 Bucket = 0; Bucket < NumLatencyBuckets; ++Bucket)
+	{
+		Csv += TEXT(",") + GetBucketName(Bucket);
+	}
+	Csv += LINE_TERMINATOR;
+
+	for (const TPair<int32, FIdentifierStats>& Pair : CopySortedStats())
+	{
+		const FIdentifierStats& Stats = Pair.Value;
+		const double NumQueries = FMath::Max<int64>(Stats.NumQueries, 1);
+		Csv += FString::Printf(TEXT("%d,%lld,%lld,%lld,%lld,%lld,%lld,%lld,%.2f,%d,%d,%.3f,%.3f"),
+		                       Pair.Key, Stats.NumQueries, Stats.NumSuccess, Stats.NumGoalUnreachable, Stats.NumRejectedByConnectivity,
+		                       Stats.NumSearchFail, Stats.NumInfiniteLoop, Stats.NumHierarchical,
+		                       Stats.TotalExpandedNodes / NumQueries, Stats.MaxExpandedNodes, Stats.PeakOpenNodes,
+		                       Stats.TotalMicroseconds / NumQueries, Stats.MaxMicroseconds);
+		for (int32 Bucket = 0; Bucket < NumLatencyBuckets; ++Bucket)
+		{
+			Csv += FString::Printf(TEXT(",%lld"), Stats.LatencyHistogram[Bucket]);
+		}
+		Csv += LINE_TERMINATOR;
+	}
+
+	return FFileHelper::SaveStringToFile(Csv, *FilePath);
+}
+
+int32 FGridPathTelemetry::GetLatencyBucket(double Microseconds)
+{
+	int32 Bucket = 0;
+	while (Bucket < NumLatencyBuckets - 1 && Microseconds >= static_cast<double>(1 << Bucket))
+	{
+		++Bucket;
+	}
+	return Bucket;
+}
@@ -0,0 +1,22 @@
+#include "PathFinding/GridReachableArea.h"
+
+#include "Algo/Reverse.h"
+
+bool FGridReachableArea::GetPathTo(int32 TileIndex, TArray<int32>& OutPath) const
+{
+	OutPath.Reset();
+
+	const int32* EntryIndex = EntryIndices.Find(TileIndex);
+	if (EntryIndex == nullptr)
+	{
+		return false;
+	}
+
+	for (int32 Entry = *EntryIndex; TileIndices[Entry] != StartIndex; Entry = EntryIndices.FindChecked(PredecessorIndices[Entry]))
+	{
+		OutPath.Add(TileIndices[Entry]);
+	}
+
+	Algo::Reverse(OutPath);
+	return true;
+}
@@ -0,0 +1,48 @@
+#include "PathFinding/GridTileStore.h"
+
+void FGridTileStore::Initialize(TArray<FTileInfo>& InOutTiles)
+{
+	const int32 NodeCount = InOutTiles.Num();
+	BlockCounts.SetNumUninitialized(NodeCount);
+	BlockedBits.Init(false, NodeCount);
+	Costs.SetNumUninitialized(NodeCount);
+	Heights.SetNumUninitialized(NodeCount);
+	CustomData.Reset();
+
+	for (int32 TileIndex = 0; TileIndex < NodeCount; ++TileIndex)
+	{
+		FTileInfo& TileInfo = InOutTiles[TileIndex];
+		BlockCounts[TileIndex] = TileInfo.GetBlockCount();
+		BlockedBits[TileIndex] = TileInfo.IsBlocking();
+		Costs[TileIndex] = TileInfo.Cost;
+		Heights[TileIndex] = TileInfo.Height;
+		if (TileInfo.CustomDataMap.Num() > 0)
+		{
+			CustomData.Add(TileIndex, MoveTemp(TileInfo.CustomDataMap));
+			TileInfo.CustomDataMap.Reset();
+		}
+	}
+}
+
+void FGridTileStore::Reset()
+{
+	BlockCounts.Empty();
+	BlockedBits.Empty();
+	Costs.Empty();
+	Heights.Empty();
+	CustomData.Empty();
+}
+
+void FGridTileStore::FillTileInfo(int32 TileIndex, FTileInfo& InOutTileInfo) const
+{
+	InOutTileInfo.Cost = Costs[TileIndex];
+	InOutTileInfo.Height = Heights[TileIndex];
+	if (const TMap<FName, FString>* TileCustomData = CustomData.Find(TileIndex))
+	{
+		InOutTileInfo.CustomDataMap = *TileCustomData;
+	}
+	else
+	{
+		InOutTileInfo.CustomDataMap.Reset();
+	}
+}
@@ -113,6 +113,10 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Gameplay")
 	bool bIsBlocking = false;
 
+	// 是否阻挡视线(UGridMapModel::ComputeVisibleTiles)， 与是否可通行无关
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Gameplay")
+	bool bBlocksSight = false;
+
 	// ---------- 用于地图编辑器的资源 / 运行时默认的地图绘制方式 Start----------
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "BuildGridMap")
 	TSoftObjectPtr<UStaticMesh> BuildGridMapMesh;
@@ -2,7 +2,21 @@
 
 #include "CoreMinimal.h"
 #include "HGTypes.h"
+#include "PathFinding/GridConnectivity.h"
+#include "PathFinding/GridCostLayers.h"
+#include "PathFinding/GridFieldOfView.h"
+#include "PathFinding/GridLandmarks.h"
+#include "PathFinding/GridPagedTileIndex.h"
+#include "PathFinding/GridNavSnapshot.h"
+#include "PathFinding/GridTopology.h"
+#include "PathFinding/GridFlowField.h"
+#include "PathFinding/GridHierarchicalPathFinder.h"
+#include "PathFinding/GridPathCache.h"
+#include "PathFinding/GridReachableArea.h"
+#include "PathFinding/GridTileStore.h"
+#include "PathFinding/GridPathRequest.h"
 #include "Types/GridMapSave.h"
+#include "Types/GridTileMap.h"
 #include "Types/TileInfo.h"
 #include "UObject/Object.h"
 #include "GridMapModel.generated.h"
@@ -15,9 +29,14 @@ enum class ETileTokenModifyType
 	UpdateTileToken,
 };
 
+struct FGridPathFilter;
+struct FGridPathQueryStats;
+
 DECLARE_MULTICAST_DELEGATE_ThreeParams(FTileEnvUpdateDelegate, const FHCubeCoord&, const FTileEnvData& OldTileEnv, const FTileEnvData& NewTileEnv);
 DECLARE_MULTICAST_DELEGATE_ThreeParams(FTileHeightUpdateDelegate, const FHCubeCoord&, const float OldHeight, const float NewHeight);
 
+DECLARE_MULTICAST_DELEGATE_OneParam(FTileNavDataDirtyDelegate, int32 TileIndex);
+
 DECLARE_MULTICAST_DELEGATE_ThreeParams(FTileTokensUpdateDelegate, const FHCubeCoord& Coord, const int32 TokenIndex, const FSerializableTokenData& NewTokenData);
 
 /**
@@ -45,29 +64,41 @@ public:
 	UPROPERTY()
 	bool EnableTokenCollision{true};
 	
+	/**
+	 * TGridTileMap不是UPROPERTY， 由这里向GC上报其中的对象引用
+	 */
+	static void AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector);
+
 protected:
 	virtual void BeginDestroy() override;
 
 protected:
-	// 运行时用于寻路相关的数据
+	// 运行时用于寻路相关的数据， 寻路时读取TileStore， 这里作为FTileInfo的兼容视图保留
 	UPROPERTY()
 	TArray<FTileInfo> Tiles;
 
+	// 与Tiles同步的列式数据
+	FGridTileStore TileStore;
+
+	// BaseOnVolume 地图的格子Index， 其他绘制模式为空
+	FGridPagedTileIndex PagedTileIndex;
+
+	// [TileIndex] BaseOnRadius 地图格子的(Q, R)， 其他绘制模式为空
+	TArray<FIntPoint> RadiusIndexToAxial;
+
 	// 记录格子上的Actor, 寻路系统会使用该数据来判断格子是否被占用
-	UPROPERTY()
-	TMap<FHCubeCoord, TWeakObjectPtr<AActor>> StandingActors;
+	TGridTileMap<TWeakObjectPtr<AActor>> StandingActors;
 
 	/**
 	 * 总是创建的, 地图多大这个Map就有多少数据， 一般也不会存在某一个格子没有TileContainer的情况
 	 */
-	UPROPERTY()
-	TMap<FHCubeCoord, FTileEnvData> TileEnvDataMap;
+	TGridTileMap<FTileEnvData> TileEnvDataMap;
 
 	// 当前坐标上的TokenActor数据
 	// 地图编辑器: 保存数据时要对其进行序列化， 读取数据时， 创建这些Actor
 	// 游戏运行时: 读取数据创建这些Actor; 可以通过游戏中的一些功能, 增加、删除、更改这些Actor
 	TMap<int32, TObjectPtr<ATokenActor>> TokenMap;
-	TMap<FHCubeCoord, TArray<int32>> Coord2TokenIDsMap;
+	TGridTileMap<TArray<int32>> Coord2TokenIDsMap;
 	
 	UPROPERTY()
 	FGridMapConfig MapConfig;
@@ -94,6 +125,10 @@ public:
 	FTileHeightUpdateDelegate OnTileHeightModify;
 
 	FTileTokensUpdateDelegate OnTileTokensModify;
+
+	// 格子的寻路数据(阻挡、高度、环境、站立的Actor)发生变化， 不受bNotify影响
+	// 用于增量更新寻路状态， 如FGridIncrementalPathPlanner
+	FTileNavDataDirtyDelegate OnTileNavDataDirty;
 	
 	/** 
 	 * 构建地图数据
@@ -102,10 +137,16 @@ public:
 	 */
 	virtual void BuildTilesData(const FGridMapConfig& InMapConfig, const TMap<FHCubeCoord, FSerializableTile>& InTilesData);
 
-	void SetMapConfig(const FGridMapConfig& InMapConfig)
-	{
-		MapConfig = InMapConfig;
-	}
+	/**
+	 * 在调用线程上同步构建只包含默认格子数据的地图(没有环境数据和Token)， 不需要World
+	 * 用于自动化测试与寻路基准， 之后仍可通过BlockTileOnce等接口修改
+	 */
+	void BuildBlankTilesData(const FGridMapConfig& InMapConfig);
+
+	/**
+	 * 只更新配置和格子Index， 不重新构建格子数据
+	 */
+	void SetMapConfig(const FGridMapConfig& InMapConfig);
 	
 	void UpdateTileEnv(const FSerializableTile& InTileData, bool bNotify = true);
 	void UpdateTileHeight(const FHCubeCoord& InCoord, float NewHeight, bool bNotify = true);
@@ -132,7 +173,7 @@ public:
 		return &Tiles;
 	}
 
-	const TMap<FHCubeCoord, FTileEnvData>* GetTileEnvMapPtr() const
+	const TGridTileMap<FTileEnvData>* GetTileEnvMapPtr() const
 	{
 		return &TileEnvDataMap;
 	}
@@ -143,11 +184,18 @@ public:
 		if (Tiles.IsValidIndex(Index))
 		{
 			OutTileInfo = Tiles[Index];
+			if (TileStore.IsValidIndex(Index))
+			{
+				TileStore.FillTileInfo(Index, OutTileInfo);
+			}
 			return true;
 		}
 		return false;
 	}
 
+	/**
+	 * 返回的FTileInfo中不包含自定义数据， 需要时使用TryGetTileInfo或GetTileCustomData
+	 */
 	const FTileInfo* GetTilePtr(const FHCubeCoord& InCoord) const
 	{
 		return &Tiles[StableGetFullMapGridIterIndex(InCoord)];
@@ -155,16 +203,34 @@ public:
 
 	const FTileEnvData& GetTileEnvData(const FHCubeCoord& InCoord) const
 	{
-		if (TileEnvDataMap.Contains(InCoord))
+		if (const FTileEnvData* EnvData = TileEnvDataMap.Find(GetDenseTileIndex(InCoord), InCoord))
 		{
-			return TileEnvDataMap[InCoord];
+			return *EnvData;
 		}
 
 		static FTileEnvData DefaultTileEnvData;
 		return DefaultTileEnvData; // 返回一个默认值或处理错误
 	}
 
-	const TMap<FHCubeCoord, TArray<int32>>& GetCoord2TokensMap() const
+	/**
+	 * 寻路使用的列式格子数据
+	 */
+	const FGridTileStore& GetTileStore() const
+	{
+		return TileStore;
+	}
+
+	const FGridPagedTileIndex& GetPagedTileIndex() const
+	{
+		return PagedTileIndex;
+	}
+
+	const TArray<FIntPoint>& GetRadiusIndexToAxial() const
+	{
+		return RadiusIndexToAxial;
+	}
+
+	const TGridTileMap<TArray<int32>>& GetCoord2TokensMap() const
 	{
 		return Coord2TokenIDsMap;
 	}
@@ -198,9 +264,9 @@ public:
 
 	bool TryGetStandingActor(const FHCubeCoord& Coord, AActor*& OutActor) const
 	{
-		if (StandingActors.Contains(Coord))
+		if (const TWeakObjectPtr<AActor>* StandingActor = StandingActors.Find(GetDenseTileIndex(Coord), Coord))
 		{
-			OutActor = StandingActors[Coord].Get();
+			OutActor = StandingActor->Get();
 			return OutActor != nullptr;
 		}
 
@@ -210,15 +276,16 @@ public:
 
 	bool IsContainStandingActor(AActor* InActor)
 	{
-		return StandingActors.Contains(StableWorldToCoord(InActor->GetActorLocation()));
+		return IsContainStandingActor(InActor->GetActorLocation());
 	}
 
 	bool IsContainStandingActor(const FVector& InActorLocation)
 	{
-		return StandingActors.Contains(StableWorldToCoord(InActorLocation));
+		const FHCubeCoord Coord = StableWorldToCoord(InActorLocation);
+		return StandingActors.Contains(GetDenseTileIndex(Coord), Coord);
 	}
 	
-	const TMap<FHCubeCoord, TWeakObjectPtr<AActor>>& GetStandingActors() const
+	const TGridTileMap<TWeakObjectPtr<AActor>>& GetStandingActors() const
 	{
 		return StandingActors;
 	}
@@ -255,6 +322,191 @@ public:
 
 	virtual double GetTraversalCost(int Identifier, int32 FromIndex, int32 ToIndex);
 
+	/**
+	 * CanTravelTo、GetTraversalCost、FillTileEdgeCosts是否可以在工作线程上同时调用
+	 * 返回false时FindPathsBatch、RebuildStaleFlowFields以及Cost表的构建都在调用线程上逐个计算
+	 * 子类确认自己的重写只读取数据后返回true以启用并行
+	 */
+	virtual bool SupportsParallelPathQueries() const;
+
+	/**
+	 * 填充预计算Cost表中一个格子的6条出边， 不可通行为MAX_flt， 否则为 1 + GetTraversalCost
+	 * SupportsParallelPathQueries返回true时， 构建Cost表会在工作线程上调用
+	 * @param OutEdgeCosts [Direction]， Direction与GetNeighborIndex相同
+	 */
+	virtual void FillTileEdgeCosts(int32 Identifier, int32 TileIndex, TArrayView<float> OutEdgeCosts);
+
+	/**
+	 * 为身份标识构建预计算的边Cost表， 已存在时重建
+	 * 设置中的CostLayerIdentifiers会在地图构建完成后自动构建
+	 */
+	void BuildCostLayer(int32 Identifier);
+
+	/**
+	 * 批量寻路， SupportsParallelPathQueries返回true时请求会被分发到工作线程并行计算， 函数返回时所有请求都已完成
+	 * @param Requests 结果直接写回每个请求
+	 */
+	void FindPathsBatch(TArrayView<FGridPathRequest> Requests);
+
+	/**
+	 * 只输出格子Index的寻路， 不创建NavPath与路径点， 适合回合制等只需要格子的调用方
+	 * 与NavMesh的FindPath相同， 先查找寻路缓存， 之后使用SearchPathIndices
+	 * @param OutPathIndices 调用方持有的缓冲区， 会先Reset， 保留已分配的容量； 不包含起点， 包含终点
+	 * @param SearchMode Default时使用A*
+	 */
+	EGraphAStarResult FindPathIndices(int32 StartIndex, int32 EndIndex, int32 Identifier, TArray<int32>& OutPathIndices, float& OutPathCost,
+	                                  EGridPathSearchMode SearchMode = EGridPathSearchMode::Default);
+
+	/**
+	 * 不经过缓存的单次寻路， 开启分层寻路并且距离足够远时先尝试分层寻路
+	 * 之后按Filter.SearchMode使用单向或双向A*
+	 * 开启连通区域检查时， 起点终点不连通会直接返回GoalUnreachable， 不会给出部分路径
+	 * 开启寻路统计(GridPathFinding.Telemetry)时记录到FGridPathTelemetry
+	 * @param OutPathIndices 不包含起点， 包含终点
+	 * @param OutStats 不为空时填写本次查询的展开节点数等数据(不包含耗时)
+	 */
+	EGraphAStarResult SearchPathIndices(const FGridPathFilter& Filter, int32 StartIndex, int32 EndIndex, TArray<int32>& OutPathIndices, float& OutPathCost,
+	                                    FGridPathQueryStats* OutStats = nullptr);
+
+	/**
+	 * 从GoalIndex出发做一次Dijkstra， 得到每个格子到终点的距离与下一步方向
+	 * 许多单位前往同一目标时用来代替逐个单位的FindPath
+	 * 终点本身被阻挡时(CanTravelTo返回false)， 其他格子均不可达
+	 * 地图数据构建中调用时只记录终点， 流场为过期状态， 构建完成后由RebuildStaleFlowFields重建
+	 */
+	void BuildFlowField(int32 GoalIndex, int32 Identifier, FGridFlowField& OutFlowField);
+
+	/**
+	 * 并行重建已过期(构建后TopologyVersion发生过变化)的流场， 未过期的流场不做处理
+	 * 与FindPathsBatch相同， 只在SupportsParallelPathQueries返回true时并行
+	 * @return 重建的流场数量
+	 */
+	int32 RebuildStaleFlowFields(TArrayView<FGridFlowField> FlowFields);
+
+	/**
+	 * 移动范围查询， 以起点为中心、总Cost不超过MaxCost的Dijkstra
+	 * 与寻路相同， 通行判断使用CanTravelTo， Cost使用 1 + GetTraversalCost(Identifier, ...)
+	 * @param OutArea 包含起点， 以及所有可达格子的Cost与前驱
+	 */
+	void FindReachableArea(int32 StartIndex, int32 Identifier, float MaxCost, FGridReachableArea& OutArea);
+
+	/**
+	 * 一次搜索找到多个终点中Cost最小的一个， 代替对每个终点分别FindPath再取最小值
+	 * 启发值为到各个终点的最小距离， 终点数量超过MaxGoalsForHeuristic时退化为Dijkstra
+	 * 与寻路相同， 被阻挡的终点不可达
+	 * @param OutGoalIndex 到达的终点， 全部不可达时为INDEX_NONE
+	 * @param OutPathIndices 不包含起点， 包含终点
+	 */
+	EGraphAStarResult FindPathToNearestGoal(int32 StartIndex, TConstArrayView<int32> GoalIndices, int32 Identifier,
+	                                        int32& OutGoalIndex, TArray<int32>& OutPathIndices, float& OutPathCost);
+
+	static constexpr int32 MaxGoalsForHeuristic = 32;
+
+	/**
+	 * 寻路相关的格子数据(阻挡、高度、环境、站立的Actor)每次变化都会递增， 用于判断缓存的寻路结果是否过期
+	 */
+	uint32 GetTopologyVersion() const
+	{
+		return TopologyVersion;
+	}
+
+	FGridPathCache& GetPathCache()
+	{
+		return PathCache;
+	}
+
+	/**
+	 * 未开启连通区域检查时为空
+	 */
+	const FGridConnectivity& GetConnectivity() const
+	{
+		return Connectivity;
+	}
+
+	const FGridLandmarks& GetLandmarks() const
+	{
+		return Landmarks;
+	}
+
+	/**
+	 * 修复格子变化影响到的路标距离， 每帧结束时自动调用
+	 * 同一帧内修改格子后需要立即使用路标启发式时可以手动调用， 需要在游戏线程上、没有其他线程寻路时调用
+	 */
+	void FlushLandmarkRepairs();
+
+	const FGridCostLayers& GetCostLayers() const
+	{
+		return CostLayers;
+	}
+
+	/**
+	 * 根据当前地图数据发布新的寻路快照， 需要在游戏线程上、所有修改完成之后调用
+	 * 设置中开启bPublishNavSnapshots时每帧结束自动调用； 地图没有变化时不做处理
+	 * 只支持行列排布的六边形地图(HexFlat/HexPointy)， BaseOnRadius、BaseOnVolume等其他排布不发布快照， 只输出一次警告
+	 */
+	void PublishNavSnapshot();
+
+	/**
+	 * 最近一次发布的快照， 可以在任意线程上调用， 没有发布过时为空
+	 */
+	FGridNavSnapshotPtr GetNavSnapshot() const
+	{
+		FScopeLock Lock(&NavSnapshotLock);
+		return NavSnapshot;
+	}
+
+	// ---------- 视野 Start -----------------
+
+	/**
+	 * 格子是否阻挡视线， 默认读取环境类型的bBlocksSight与格子上Token的bBlocksSight
+	 */
+	virtual bool IsTileBlockingSight(int32 TileIndex);
+
+	/**
+	 * IsTileBlockingSight的结果可能发生了变化， 修改环境、Token时已自动调用
+	 */
+	void MarkTileSightDirty(int32 TileIndex);
+
+	/**
+	 * 半径内从SourceIndex可见的格子， 见FGridFieldOfView
+	 * @param OutVisibleTiles 按格子Index升序， 包含起点
+	 */
+	void ComputeVisibleTiles(int32 SourceIndex, int32 Radius, TArray<int32>& OutVisibleTiles);
+
+	/**
+	 * 多个观察者的视野， 在工作线程上并行计算， 调用期间不能修改地图
+	 */
+	void ComputeVisibleTilesBatch(TArrayView<FGridVisibilityRequest> Requests);
+
+	bool HasLineOfSight(int32 FromIndex, int32 ToIndex) const;
+
+	UFUNCTION(BlueprintCallable)
+	TArray<FHCubeCoord> GetVisibleCoords(const FHCubeCoord& SourceCoord, int32 Radius);
+
+	UFUNCTION(BlueprintCallable)
+	bool HasLineOfSightBetween(const FHCubeCoord& FromCoord, const FHCubeCoord& ToCoord) const;
+
+	const FGridFieldOfView& GetFieldOfView() const
+	{
+		return FieldOfView;
+	}
+
+	// ---------- 视野 End -----------------
+
+	/**
+	 * 寻路内核使用的拓扑， BuildTilesData时根据MapType、TileOrientation、DrawMode确定
+	 */
+	EGridPathTopology GetPathTopology() const
+	{
+		return PathTopology;
+	}
+
+	/**
+	 * 格子的寻路数据发生了变化
+	 * 子类重写CanTravelTo、GetTraversalCost时， 如果依赖的自定义数据发生变化， 也需要调用该函数
+	 */
+	void MarkTileNavDataDirty(int32 TileIndex);
+
 	/**
 	 * 计算从指定坐标到地图边界的最大距离
 	 * 用于优化AI算法中的范围搜索，避免超出地图边界的无效计算
@@ -275,7 +527,7 @@ protected:
 		FBuildTilesDataTask(UGridMapModel* InOwner, TArray<UGridEnvironmentType*> InEnvTypes,
 		                    const TMap<FHCubeCoord, FSerializableTile>& InTilesData,
 		                    TSharedPtr<TArray<FTileInfo>> OutTiles,
-		                    TSharedPtr<TMap<FHCubeCoord, FTileEnvData>> OutEnvData);
+		                    TSharedPtr<TGridTileMap<FTileEnvData>> OutEnvData);
 
 		void DoWork();
 		
@@ -303,7 +555,7 @@ protected:
 		TSharedPtr<TArray<FTileInfo>> TargetTilesPtr;
 
 		/** 输出的环境数据 */
-		TSharedPtr<TMap<FHCubeCoord, FTileEnvData>> TargetTileEnvDataMapPtr;
+		TSharedPtr<TGridTileMap<FTileEnvData>> TargetTileEnvDataMapPtr;
 
 		TSharedPtr<TArray<FHCubeCoord>> KeyArray; // 用于批量创建TokenActor时的Key数组
 
@@ -357,6 +609,9 @@ public:
 	UFUNCTION(BlueprintCallable)
 	const FHCubeCoord GetBackwardCoord(const FHCubeCoord& InLocalCoord, const FHCubeCoord& InNextCoord) const;
 
+	/**
+	 * 两点之间直线经过的格子， 判断视线请使用HasLineOfSight
+	 */
 	UFUNCTION(BlueprintCallable)
 	TArray<FHCubeCoord> GetCoordsBetween(const FHCubeCoord& StartCoord, const FHCubeCoord& EndCoord);
 
@@ -380,6 +635,23 @@ public:
 	 */
 	int32 StableGetFullMapGridIterIndex(const FHCubeCoord& InCoord) const;
 
+	/**
+	 * 当前绘制模式是否支持StableGetFullMapGridIterIndex
+	 */
+	bool HasDenseTileIndex() const
+	{
+		return MapConfig.DrawMode == EGridMapDrawMode::BaseOnRowColumn || PathTopology == EGridPathTopology::HexRadius ||
+			PathTopology == EGridPathTopology::HexVolume;
+	}
+
+	/**
+	 * TGridTileMap使用的格子Index， 不支持Index的绘制模式返回INDEX_NONE且不输出错误日志
+	 */
+	FORCEINLINE int32 GetDenseTileIndex(const FHCubeCoord& InCoord) const
+	{
+		return HasDenseTileIndex() ? StableGetFullMapGridIterIndex(InCoord) : INDEX_NONE;
+	}
+
 	FHCubeCoord StableGetCoordByIndex(const int32 InIndex) const;
 
 	// ---------- Chunk 分区功能 Start------------------
@@ -403,8 +675,51 @@ public:
 
 	TArray<FHCubeCoord> GetRangeCoords(const FHCubeCoord& Center, int32 Radius) const;
 	
+	static constexpr int32 NeighborTableStride = 6;
+
 	// 获取邻居索引（高效版本）， 仅用于A星寻路快速查询
-	int32 GetNeighborIndex(int32 NodeIndex, int32 Direction) const;
+	FORCEINLINE int32 GetNeighborIndex(int32 NodeIndex, int32 Direction) const
+	{
+		if (NeighborIndicesCache.Num() > 0)
+		{
+			return NeighborIndicesCache[NodeIndex * NeighborTableStride + Direction];
+		}
+
+		return ComputeNeighborIndex(NodeIndex, Direction);
+	}
+
+	/**
+	 * 不读取邻居表， 六边形拓扑由行列奇偶性计算， 其他拓扑经过坐标转换
+	 */
+	FORCEINLINE int32 ComputeNeighborIndex(int32 NodeIndex, int32 Direction) const
+	{
+		switch (PathTopology)
+		{
+		case EGridPathTopology::HexFlat:
+			return FGridHexFlatTopology::GetNeighbour(NodeIndex, Direction, NeighborTopologyParams);
+		case EGridPathTopology::HexPointy:
+			return FGridHexPointyTopology::GetNeighbour(NodeIndex, Direction, NeighborTopologyParams);
+		case EGridPathTopology::HexRadius:
+			return FGridHexRadiusTopology::GetNeighbour(NodeIndex, Direction, NeighborTopologyParams);
+		case EGridPathTopology::HexVolume:
+			return FGridHexVolumeTopology::GetNeighbour(NodeIndex, Direction, NeighborTopologyParams);
+		default:
+			return ComputeNeighborIndexByCoord(NodeIndex, Direction);
+		}
+	}
+
+	/**
+	 * [NodeIndex * NeighborTableStride + Direction]， 邻居获取方式为实时计算时返回nullptr
+	 */
+	const int32* GetNeighborTable() const
+	{
+		return NeighborIndicesCache.Num() > 0 ? NeighborIndicesCache.GetData() : nullptr;
+	}
+
+	SIZE_T GetNeighborTableAllocatedSize() const
+	{
+		return NeighborIndicesCache.GetAllocatedSize();
+	}
 
 	int32 GetMaxValidIndex() const { return MaxValidIndex; }
 
@@ -416,14 +731,74 @@ public:
 	virtual float GetTileHeightOffset(const FHCubeCoord& InCoord);
 private:
 	FSixDirections SixDirections{};
+
+	/**
+	 * BuildTilesData与BuildBlankTilesData共用: 设置MapConfig， 计算拓扑与邻居缓存， 清空依赖格子数据的寻路结构
+	 */
+	void PrepareTilesDataBuild(const FGridMapConfig& InMapConfig);
+
+	/**
+	 * 根据MapConfig计算寻路拓扑、SixDirections与框选地图的格子Index， GetDenseTileIndex依赖这里的结果
+	 */
+	void UpdateTileIndexMapping();
+
+	/**
+	 * Tiles写入完成后构建分层寻路、Cost表、连通区域等寻路数据
+	 */
+	void FinishTilesDataBuild();
+
+	/**
+	 * SearchPathIndices的实现， OutStats不为空时填写展开节点数等统计数据
+	 */
+	EGraphAStarResult SearchPathIndicesInternal(const FGridPathFilter& Filter, int32 StartIndex, int32 EndIndex, TArray<int32>& OutPathIndices,
+	                                            float& OutPathCost, FGridPathQueryStats* OutStats);
 	
 	FHCubeCoord HexCoordRound(const FHFractional& F);
 
-	// 邻居索引缓存 [NodeIndex][Direction] = NeighborIndex
-	TArray<TArray<int32>> NeighborIndicesCache;
+	// 邻居索引缓存 [NodeIndex * NeighborTableStride + Direction] = NeighborIndex， 实时计算模式下为空
+	TArray<int32> NeighborIndicesCache;
+
+	FGridTopologyParams NeighborTopologyParams;
+
+	int32 ComputeNeighborIndexByCoord(int32 NodeIndex, int32 Direction) const;
+
+	uint32 TopologyVersion = 0;
+
+	FGridPathCache PathCache;
+
+	FGridHierarchicalPathFinder HierarchicalPathFinder;
+
+	FGridConnectivity Connectivity;
+
+	FGridLandmarks Landmarks;
+
+	FGridCostLayers CostLayers;
+
+	EGridPathTopology PathTopology = EGridPathTopology::Generic;
+
+	FGridFieldOfView FieldOfView;
+
+	// 阻挡视线的环境类型， 地图构建完成时从设置中读取
+	TSet<FName> SightBlockingEnvTypes;
+
+	// 只在游戏线程上替换， 其他线程通过GetNavSnapshot加锁复制指针
+	FGridNavSnapshotPtr NavSnapshot;
+	mutable FCriticalSection NavSnapshotLock;
+
+	// 上一次发布之后变化的格子
+	TSet<int32> NavSnapshotDirtyTiles;
+
+	FDelegateHandle NavSnapshotEndFrameHandle;
+
+	FDelegateHandle LandmarksEndFrameHandle;
 	
 	UPROPERTY()
 	int32 MaxValidIndex = 0;  // 最大有效索引
 
 	void BuildPathFindingCache();
+
+	/**
+	 * 收集PlaceVolumes覆盖、并且不在SubtractVolumes中的格子， 构建PagedTileIndex
+	 */
+	void BuildVolumeTileIndex();
 };
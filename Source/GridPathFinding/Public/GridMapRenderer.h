@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "GridEnvironmentType.h"
 #include "GameFramework/Actor.h"
+#include "Types/GridTileMap.h"
 #include "Types/HCubeCoord.h"
 #include "Types/MapConfig.h"
 #include "Types/TileInfo.h"
@@ -167,8 +168,7 @@ protected:
 	TMap<FName, FGridEnvironmentMaterialCustomData> EnvType2DefaultCustomDataMap;
 
 	// Coord to ISM Index
-	UPROPERTY()
-	TMap<FHCubeCoord, int32> EnvISMCIndexMap;
+	TGridTileMap<int32> EnvISMCIndexMap;
 
 	UPROPERTY(EditAnywhere, Category=Config, meta=(DisplayName="默认Lit"))
 	float DefaultTint = 1.0f;
@@ -185,8 +185,7 @@ protected:
 
 	// ------- HighLightMask 功能 Start ----------
 	// 坐标到 HighLightMask 实例索引的映射
-	UPROPERTY()
-	TMap<FHCubeCoord, int32> HighlightMaskIndexMap;
+	TGridTileMap<int32> HighlightMaskIndexMap;
 	// ------- HighLightMask 功能 End ----------
 
 private:
@@ -3,6 +3,7 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "PathFinding/GridPathRequest.h"
 #include "UObject/Interface.h"
 #include "GridPathFindingIdentifier.generated.h"
 
@@ -23,4 +24,10 @@ class GRIDPATHFINDING_API IGridPathFindingIdentifier
 	// Add interface functions to this class. This is the class that will be inherited to implement this interface.
 public:
 	virtual int32 GetGridPathFindingIdentifier() const = 0;
+
+	// 寻路使用的搜索方式， Default表示使用NavMesh上的DefaultSearchMode
+	virtual EGridPathSearchMode GetGridPathSearchMode() const
+	{
+		return EGridPathSearchMode::Default;
+	}
 };
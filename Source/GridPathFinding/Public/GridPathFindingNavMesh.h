@@ -4,6 +4,9 @@
 
 #include "CoreMinimal.h"
 #include "GridMapModel.h"
+#include "PathFinding/GridAStar.h"
+#include "PathFinding/GridPathRequest.h"
+#include "PathFinding/GridTopology.h"
 #include "NavMesh/RecastNavMesh.h"
 #include "Types/MapConfig.h"
 #include "GridPathFindingNavMesh.generated.h"
@@ -13,6 +16,9 @@ DECLARE_LOG_CATEGORY_EXTERN(LogGridPathFinding_NavMesh, Log, All);
 
 DECLARE_CYCLE_STAT(TEXT("Grid A* Pathfinding"), STAT_Navigation_GASPathfinding, STATGROUP_Navigation);
 
+// 分帧寻路完成， Request中包含结果
+DECLARE_DELEGATE_TwoParams(FGridAsyncPathCompleteDelegate, uint32 RequestId, const FGridPathRequest& Request);
+
 UCLASS()
 class GRIDPATHFINDING_API AGridPathFindingNavMesh : public ARecastNavMesh
 {
@@ -28,6 +34,13 @@ public:
 	 * or in some other function like we do here in SetHexGrid().
 	 */
 	static FPathFindingResult FindPath(const FNavAgentProperties &AgentProperties, const FPathFindingQuery &Query);
+
+	/**
+	 * 把格子路径转换为路径点， 高度来自StableCoordToWorld(GetTileHeightOffset)， 不包含起点
+	 * bMergeStraightSegments为true时， 前后两步方向相同且三个格子高度相同的中间格子不生成路径点， 终点总是保留
+	 */
+	static void AppendPathPoints(UGridMapModel& MapModel, int32 StartIndex, const TArray<int32>& PathIndices, bool bMergeStraightSegments,
+	                             float ZOffset, TArray<FNavPathPoint>& OutPathPoints);
 	
 	/* Set a pointer to a grid map, it can be nullptr */
 	void SetMapModel(UGridMapModel* InMapModel);
@@ -53,12 +66,80 @@ public:
 
 	void SetToStatic();
 
+	/**
+	 * 分帧寻路， 请求按提交顺序处理， 每帧最多展开AsyncPathExpansionBudgetPerFrame个格子
+	 * 大量寻路者同时重新寻路时(如墙被摧毁)把Cost分摊到多帧， 避免单帧卡顿
+	 * 只使用单向A*； 搜索跨越多帧， 期间地图发生变化时从头开始搜索， 地图频繁变化时完成时间会变长
+	 * @param OnComplete 在游戏线程上调用， 请求被取消时不会调用
+	 * @return 请求ID， 用于CancelAsyncPath， 0表示请求无效
+	 */
+	uint32 RequestPathAsync(int32 StartIndex, int32 EndIndex, int32 Identifier, FGridAsyncPathCompleteDelegate OnComplete);
+
+	bool CancelAsyncPath(uint32 RequestId);
+
+	int32 GetNumPendingAsyncPaths() const
+	{
+		return AsyncPathQueue.Num();
+	}
+
 	/* Just a pointer to a grid map model */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "HexAStar|NavMesh")
 	TWeakObjectPtr<UGridMapModel> WeakMapModel;
 	
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "HexAStar|NavMesh")
 	float PathPointZOffset{0.f};
+
+	// 寻路者没有通过IGridPathFindingIdentifier指定搜索方式时使用
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "HexAStar|NavMesh")
+	EGridPathSearchMode DefaultSearchMode{EGridPathSearchMode::AStar};
+
+	// 路径上同方向、同高度的连续格子只保留两端的路径点， 减少路径跟随的分段数量
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "HexAStar|NavMesh")
+	bool bMergeStraightPathSegments{false};
+
+	// 分帧寻路每帧最多展开的格子数量， 所有请求共用
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "HexAStar|NavMesh", meta = (ClampMin = 1))
+	int32 AsyncPathExpansionBudgetPerFrame{2048};
+
+private:
+	struct FAsyncPathQuery
+	{
+		uint32 RequestId = 0;
+		FGridPathRequest Request;
+		FGridAsyncPathCompleteDelegate OnComplete;
+		// BeginAsyncPath时选定的地标， 之后每次Step都使用它， 保证同一次搜索的启发函数不变
+		// 地标修复只在格子变化后发生， 格子变化会让搜索从头开始， 所以这里不会指向修复中的数据
+		const FGridLandmarks* Landmarks = nullptr;
+	};
+
+	void ScheduleAsyncPathProcessing();
+
+	/**
+	 * 每帧调用一次， 继续处理队首的请求， 预算用完时保存搜索状态， 下一帧继续
+	 * 两帧之间地图发生变化时， 队首请求从头开始搜索
+	 */
+	void ProcessAsyncPaths();
+
+	/**
+	 * 开始队首的请求， 命中缓存或不需要搜索时直接得出结果并返回true
+	 */
+	bool BeginAsyncPath(UGridMapModel& MapModel, FAsyncPathQuery& Query);
+
+	// 请求按提交顺序处理， 只有队首的请求处于搜索中， 共用同一份Workspace
+	TArray<FAsyncPathQuery> AsyncPathQueue;
+
+	FGridSearchWorkspace AsyncPathWorkspace;
+
+	// 队首请求的搜索状态， 为空表示队首请求尚未开始
+	TUniquePtr<FGridAStar> AsyncPathfinder;
+
+	// 队首请求开始搜索时地图的TopologyVersion与格子数量， 任意一个变化时重新开始搜索
+	uint32 AsyncPathTopologyVersion = 0;
+	int32 AsyncPathNodeCount = 0;
+
+	uint32 NextAsyncPathRequestId = 1;
+
+	bool bAsyncPathProcessingScheduled = false;
 };
 
 
@@ -67,16 +148,25 @@ public:
  */
 struct FGridPathFilter
 {
-	FGridPathFilter(const AGridPathFindingNavMesh &InNavMeshRef) : NavMeshRef(InNavMeshRef)
+	FGridPathFilter(const AGridPathFindingNavMesh &InNavMeshRef) : MapModel(InNavMeshRef.WeakMapModel.Get())
 	{
 		// 构造时缓存地图参数
 		InitializeDistanceCache();
 	}
 
+	// 不经过NavigationSystem时直接使用MapModel， 如UGridMapModel::FindPathsBatch
+	explicit FGridPathFilter(UGridMapModel& InMapModel) : MapModel(&InMapModel)
+	{
+		InitializeDistanceCache();
+	}
+
 	int StartIdx{};
 	int EndIdx{};
 	int Identifier = INDEX_NONE;
 
+	// UGridMapModel::SearchPathIndices 根据该值选择搜索方式， Default按AStar处理
+	EGridPathSearchMode SearchMode = EGridPathSearchMode::Default;
+
 	/**
 	 * Used as GetHeuristicCost's multiplier
 	 * 作用: 作为启发式代价的乘数，调节算法行为
@@ -111,66 +201,157 @@ struct FGridPathFilter
 	 */
 	bool WantsPartialSolution() const;
 
+	// ---------- FGridAStar 使用的图接口 Start ----------
+	FORCEINLINE int32 GetNodeCount() const
+	{
+		return CachedNodeCount;
+	}
+
+	FORCEINLINE int32 GetNeighbourCount() const
+	{
+		return 6;
+	}
+
+	FORCEINLINE int32 GetNeighbour(const int32 NodeIndex, const int32 Direction) const
+	{
+		return MapModel->GetNeighborIndex(NodeIndex, Direction);
+	}
+
+	/**
+	 * 合并IsTraversalAllowed与GetTraversalCost, 不可通行时返回false
+	 */
+	FORCEINLINE bool TryGetEdgeCost(const int32 FromIndex, const int32 Direction, const int32 ToIndex, FVector::FReal& OutCost) const
+	{
+		if (const float* CostLayer = GetCostLayer())
+		{
+			const float EdgeCost = CostLayer[FromIndex * FGridCostLayers::NumDirections + Direction];
+			if (EdgeCost == MAX_flt)
+			{
+				return false;
+			}
+
+			OutCost = EdgeCost;
+			return true;
+		}
+
+		if (!IsTraversalAllowed(FromIndex, ToIndex))
+		{
+			return false;
+		}
+
+		OutCost = GetTraversalCost(FromIndex, ToIndex);
+		return true;
+	}
+	// ---------- FGridAStar 使用的图接口 End ----------
+
 protected:
 
 	/**
-	 * A reference to our NavMesh
+	 * 构造时从NavMesh取出的地图， 避免每条边都解析一次WeakPtr
 	 */
-	const AGridPathFindingNavMesh &NavMeshRef;
+	UGridMapModel* MapModel;
 
-private:
 	// 寻路缓存参数 - 构造时初始化一次，整个寻路过程复用
-	int32 CachedMapRows = 0;
-	int32 CachedMapColumns = 0;
-	int32 CachedMapRowsHalf = 0;
-	int32 CachedMapColumnsHalf = 0;
+	FGridTopologyParams TopologyParams;
 	bool bCachedIsFlatOrientation = true;
+	bool bCachedIsRadiusMap = false;
+	bool bCachedIsVolumeMap = false;
+	int32 CachedNodeCount = 0;
+
+	// Identifier在构造之后才会设置， 第一次读取边Cost时再查找对应的Cost表
+	mutable const float* CachedCostLayer = nullptr;
+	mutable int32 CachedCostLayerIdentifier = MIN_int32;
+
+	FORCEINLINE const float* GetCostLayer() const
+	{
+		if (CachedCostLayerIdentifier != Identifier)
+		{
+			CachedCostLayer = MapModel->GetCostLayers().FindLayer(Identifier);
+			CachedCostLayerIdentifier = Identifier;
+		}
+		return CachedCostLayer;
+	}
+
+	// 地图构建了路标时使用ALT下界， 只对与路标相同的身份标识有效， 有未修复的格子变化时不使用
+	const FGridLandmarks* Landmarks = nullptr;
+
+	// UGridMapModel::GetNeighborTable， 实时计算邻居时为nullptr
+	const int32* NeighborTable = nullptr;
 
 	void InitializeDistanceCache()
 	{
-		const auto& MapConfig = NavMeshRef.WeakMapModel->GetMapConfig();
-		CachedMapRows = MapConfig.MapSize.X;
-		CachedMapColumns = MapConfig.MapSize.Y;
-		CachedMapRowsHalf = CachedMapRows / 2;
-		CachedMapColumnsHalf = CachedMapColumns / 2;
+		CachedNodeCount = MapModel->GetMaxValidIndex() + 1;
+		const FGridLandmarks& MapLandmarks = MapModel->GetLandmarks();
+		Landmarks = MapLandmarks.IsBuilt() && !MapLandmarks.HasPendingRepairs() ? &MapLandmarks : nullptr;
+		NeighborTable = MapModel->GetNeighborTable();
+		const auto& MapConfig = MapModel->GetMapConfig();
+		TopologyParams.Initialize(MapConfig);
+		TopologyParams.PagedTileIndex = &MapModel->GetPagedTileIndex();
+		TopologyParams.RadiusIndexToAxial = &MapModel->GetRadiusIndexToAxial();
 		bCachedIsFlatOrientation = (MapConfig.TileOrientation == ETileOrientationFlag::FLAT);
+		bCachedIsRadiusMap = MapModel->GetPathTopology() == EGridPathTopology::HexRadius;
+		bCachedIsVolumeMap = MapModel->GetPathTopology() == EGridPathTopology::HexVolume;
 	}
 
 	// 极速距离计算 - 零内存访问开销
-	// 仅适用于六边形网格（FLAT或POINTY），且地图通过RowColumn方式遍历
+	// 仅适用于六边形网格（FLAT或POINTY），且地图通过RowColumn、Radius或Volume方式遍历
 	FORCEINLINE int32 GetDistanceByIndexUltraFast(const int32 A, const int32 B) const
 	{
-		if (A == B) return 0;
+		if (bCachedIsRadiusMap)
+		{
+			return FGridHexRadiusTopology::GetDistance(A, B, TopologyParams);
+		}
+
+		if (bCachedIsVolumeMap)
+		{
+			return FGridHexVolumeTopology::GetDistance(A, B, TopologyParams);
+		}
+
+		return bCachedIsFlatOrientation
+			       ? FGridHexFlatTopology::GetDistance(A, B, TopologyParams)
+			       : FGridHexPointyTopology::GetDistance(A, B, TopologyParams);
+	}
+};
+
+
+/**
+ * 按拓扑策略特化的Filter， 由 UGridMapModel::SearchPathIndices 在每次查询开始时选择
+ * 距离、邻居都是编译期确定的内联计算， 其余行为与FGridPathFilter相同
+ */
+template <typename TTopology>
+struct TGridPathFilter : public FGridPathFilter
+{
+	explicit TGridPathFilter(const FGridPathFilter& InFilter) : FGridPathFilter(InFilter)
+	{
+	}
 
-		int32 qA, rA, qB, rB;
+	FORCEINLINE int32 GetNeighbourCount() const
+	{
+		return TTopology::NeighbourCount;
+	}
 
-		if (bCachedIsFlatOrientation)
+	FORCEINLINE int32 GetNeighbour(const int32 NodeIndex, const int32 Direction) const
+	{
+		if constexpr (TTopology::bUseNeighborCache)
 		{
-			// 使用缓存值，全部在栈上，CPU缓存友好
-			const int32 columnA = A / CachedMapRows;
-			const int32 rowA = A % CachedMapRows;
-			qA = columnA - CachedMapColumnsHalf;
-			rA = rowA - (columnA - (columnA & 1)) / 2 - CachedMapRowsHalf;
-
-			const int32 columnB = B / CachedMapRows;
-			const int32 rowB = B % CachedMapRows;
-			qB = columnB - CachedMapColumnsHalf;
-			rB = rowB - (columnB - (columnB & 1)) / 2 - CachedMapRowsHalf;
+			if (NeighborTable)
+			{
+				return NeighborTable[NodeIndex * UGridMapModel::NeighborTableStride + Direction];
+			}
 		}
-		else // POINTY
+
+		return TTopology::GetNeighbour(NodeIndex, Direction, TopologyParams);
+	}
+
+	FORCEINLINE FVector::FReal GetHeuristicCost(const int32 StartNodeRef, const int32 EndNodeRef) const
+	{
+		const int32 Distance = TTopology::GetDistance(StartNodeRef, EndNodeRef, TopologyParams);
+		if (Landmarks && Identifier == Landmarks->GetIdentifier())
 		{
-			const int32 rowA = A / CachedMapColumns;
-			const int32 columnA = A % CachedMapColumns;
-			qA = columnA - (rowA - (rowA & 1)) / 2 - CachedMapColumnsHalf;
-			rA = rowA - CachedMapRowsHalf;
-
-			const int32 rowB = B / CachedMapColumns;
-			const int32 columnB = B % CachedMapColumns;
-			qB = columnB - (rowB - (rowB & 1)) / 2 - CachedMapColumnsHalf;
-			rB = rowB - CachedMapRowsHalf;
+			return FMath::Max(static_cast<float>(Distance), Landmarks->GetLowerBound(StartNodeRef, EndNodeRef));
 		}
 
-		return (FMath::Abs(qA - qB) + FMath::Abs(qA + rA - qB - rB) + FMath::Abs(rA - rB)) / 2;
+		return Distance;
 	}
 };
 
@@ -187,9 +368,12 @@ struct FGridNavMeshPath : public FNavMeshPath
 	FORCEINLINE
 	virtual FVector::FReal GetLengthFromPosition(FVector SegmentStart, uint32 NextPathPointIndex) const override
 	{
-		// We exclude the starting point so -1	
-		return PathPoints.Num() - 1;
+		// 合并路径点后PathPoints.Num() - 1不再是格子步数
+		return NumTileSteps;
 	}
 
 	float CurrentPathCost{ 0 };
+
+	// 路径经过的格子数量， 不包含起点
+	int32 NumTileSteps{ 0 };
 };
@@ -32,6 +32,18 @@ enum class ETokenActorType : uint8
 	Environment UMETA(DisplayName = "环境"),
 };
 
+/**
+ * 寻路邻居的获取方式
+ */
+UENUM()
+enum class EGridNeighborIndexMode : uint8
+{
+	// 构建地图时生成连续的邻居表， 每个格子占用24字节
+	Table UMETA(DisplayName = "邻居表"),
+	// 寻路时由行列奇偶性计算， 不占用内存
+	Computed UMETA(DisplayName = "实时计算"),
+};
+
 USTRUCT(BlueprintType)
 struct FTokenActorClassArray
 {
@@ -78,6 +90,52 @@ public:
 	UPROPERTY(config, EditAnywhere, meta = (DisplayName = "地图Chunk尺寸"))
 	FIntPoint MapChunkSize = FIntPoint(25, 25);
 
+	// 相同起点、终点、身份标识的寻路结果会被缓存， 格子数据变化后自动失效
+	UPROPERTY(config, EditAnywhere, meta = (DisplayName = "寻路缓存数量上限(0为关闭)", ClampMin = 0))
+	int32 PathCacheMaxEntries = 4096;
+
+	// 起点终点距离较远时， 先在Chunk边界入口构成的抽象图上寻路， 再细化为格子路径
+	// 大地图上可以显著减少展开的格子数量， 路径接近最优但不保证最优
+	UPROPERTY(config, EditAnywhere, meta = (DisplayName = "启用分层寻路"))
+	bool bEnableHierarchicalPathFinding = false;
+
+	UPROPERTY(config, EditAnywhere, meta = (DisplayName = "分层寻路最小距离", ClampMin = 1, EditCondition = "bEnableHierarchicalPathFinding"))
+	int32 HierarchicalPathFindingMinDistance = 64;
+
+	// 寻路前检查起点与终点是否在同一连通区域， 不在时直接返回不可达
+	// 连通区域只根据格子是否阻挡计算， 子类重写CanTravelTo允许进入阻挡格子时需要关闭
+	UPROPERTY(config, EditAnywhere, meta = (DisplayName = "启用连通区域检查"))
+	bool bEnableConnectivityCheck = true;
+
+	// 地图构建完成后选择路标并预计算距离， 格子Cost差异较大时A*的启发式更接近真实Cost
+	// 每个路标占用 格子数量 * 8 字节， 路标数量受内存预算和数量上限共同限制， 0为关闭
+	UPROPERTY(config, EditAnywhere, meta = (DisplayName = "路标启发式内存预算(KB, 0为关闭)", ClampMin = 0))
+	int32 LandmarkMemoryBudgetKB = 0;
+
+	UPROPERTY(config, EditAnywhere, meta = (DisplayName = "路标数量上限", ClampMin = 1, ClampMax = 32))
+	int32 MaxLandmarkCount = 8;
+
+	// 路标距离按该身份标识的Cost计算， 其他身份标识的查询仍使用六边形距离
+	UPROPERTY(config, EditAnywhere, meta = (DisplayName = "路标启发式的身份标识"))
+	int32 LandmarkIdentifier = INDEX_NONE;
+
+	// 地图构建完成后为这些身份标识预计算每个格子6个方向的边Cost， 寻路时不再逐条边调用CanTravelTo、GetTraversalCost
+	// 每个身份标识占用 格子数量 * 24 字节， 不在列表中的身份标识仍然使用虚函数
+	UPROPERTY(config, EditAnywhere, meta = (DisplayName = "预计算边Cost的身份标识"))
+	TArray<int32> CostLayerIdentifiers{INDEX_NONE};
+
+	// 大地图可以使用实时计算省去邻居表的内存与构建时间， 代价是每次展开节点多几次整数运算
+	UPROPERTY(config, EditAnywhere, meta = (DisplayName = "寻路邻居获取方式"))
+	EGridNeighborIndexMode NeighborIndexMode = EGridNeighborIndexMode::Table;
+
+	// 每帧结束时发布一份只读的寻路快照(UGridMapModel::GetNavSnapshot)， 供工作线程在不加锁的情况下寻路
+	UPROPERTY(config, EditAnywhere, meta = (DisplayName = "每帧发布寻路快照"))
+	bool bPublishNavSnapshots = false;
+
+	// 相同起点、半径的视野结果会被缓存， 阻挡视线的格子变化后自动失效
+	UPROPERTY(config, EditAnywhere, meta = (DisplayName = "视野缓存数量上限(0为关闭)", ClampMin = 0))
+	int32 FieldOfViewCacheMaxEntries = 0;
+
 	UPROPERTY(config, EditAnywhere, meta = (DisplayName = "六边形网格朝向"))
 	ETileOrientationFlag HexTileOrientation = ETileOrientationFlag::FLAT;
 	
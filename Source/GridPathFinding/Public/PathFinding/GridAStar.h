@@ -0,0 +1,304 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "GraphAStar.h"
+#include <type_traits>
+
+/**
+ * 寻路过程中复用的节点数据
+ * 所有数组都直接使用 StableGetFullMapGridIterIndex 得到的格子Index寻址， 不做Hash查找
+ * 通过SearchGeneration标记节点属于哪一次搜索， 两次查询之间不需要清空数组
+ */
+struct GRIDPATHFINDING_API FGridSearchWorkspace
+{
+	struct FOpenNode
+	{
+		// G + H
+		float TotalCost;
+		int32 NodeIndex;
+	};
+
+	struct FOpenNodePredicate
+	{
+		FORCEINLINE bool operator()(const FOpenNode& A, const FOpenNode& B) const
+		{
+			return A.TotalCost < B.TotalCost;
+		}
+	};
+
+	TArray<float> GScores;
+	TArray<int32> ParentIndices;
+	// 值等于SearchGeneration时， 表示本次搜索中该节点已被访问(进入过Open列表)
+	TArray<uint32> VisitedGenerations;
+	// 值等于SearchGeneration时， 表示本次搜索中该节点已关闭
+	TArray<uint32> ClosedGenerations;
+	// 二叉堆, 同一个节点可能因为Cost降低重复入堆， 出堆时通过Closed标记跳过
+	TArray<FOpenNode> OpenHeap;
+
+	uint32 SearchGeneration = 0;
+
+	/**
+	 * 开始一次新的搜索， 保证数组容量不小于NodeCount
+	 */
+	void BeginSearch(int32 NodeCount);
+
+	FORCEINLINE bool IsVisited(int32 NodeIndex) const
+	{
+		return VisitedGenerations[NodeIndex] == SearchGeneration;
+	}
+
+	FORCEINLINE bool IsClosed(int32 NodeIndex) const
+	{
+		return ClosedGenerations[NodeIndex] == SearchGeneration;
+	}
+
+	FORCEINLINE void Visit(int32 NodeIndex, float GScore, int32 ParentIndex)
+	{
+		VisitedGenerations[NodeIndex] = SearchGeneration;
+		GScores[NodeIndex] = GScore;
+		ParentIndices[NodeIndex] = ParentIndex;
+	}
+
+	FORCEINLINE void Close(int32 NodeIndex)
+	{
+		ClosedGenerations[NodeIndex] = SearchGeneration;
+	}
+
+	/**
+	 * 当前线程的Workspace， 同一线程上的同步查询共用一份
+	 */
+	static FGridSearchWorkspace& GetThreadLocal();
+};
+
+namespace GridAStarPrivate
+{
+	template <typename TQueryFilter, typename = void>
+	struct THasIsGoal : std::false_type
+	{
+	};
+
+	template <typename TQueryFilter>
+	struct THasIsGoal<TQueryFilter, std::void_t<decltype(std::declval<const TQueryFilter&>().IsGoal(0))>> : std::true_type
+	{
+	};
+}
+
+/**
+ * 网格专用的A*实现， 用于替代FGraphAStar
+ *
+ * TQueryFilter 需要实现:
+ *  int32 GetNodeCount() const
+ *  int32 GetNeighbourCount() const
+ *  int32 GetNeighbour(int32 NodeIndex, int32 Direction) const				无邻居返回INDEX_NONE
+ *  FVector::FReal GetHeuristicScale() const
+ *  FVector::FReal GetHeuristicCost(int32 StartIndex, int32 EndIndex) const
+ *  bool TryGetEdgeCost(int32 FromIndex, int32 Direction, int32 ToIndex, FVector::FReal& OutCost) const	不可通行返回false
+ *  bool WantsPartialSolution() const
+ *
+ * 可选:
+ *  bool IsGoal(int32 NodeIndex) const		除EndIndex外， 返回true的节点同样视为终点， 用于多终点搜索
+ *
+ * 与FGraphAStar的结果保持一致: 路径不包含起点， 包含终点
+ */
+class GRIDPATHFINDING_API FGridAStar
+{
+public:
+	FGridAStar()
+		: Workspace(FGridSearchWorkspace::GetThreadLocal())
+	{
+	}
+
+	explicit FGridAStar(FGridSearchWorkspace& InWorkspace)
+		: Workspace(InWorkspace)
+	{
+	}
+
+	template <typename TQueryFilter>
+	EGraphAStarResult FindPath(const int32 InStartIndex, const int32 InEndIndex, const TQueryFilter& Filter, TArray<int32>& OutPath)
+	{
+		if (!BeginSearch(InStartIndex, InEndIndex, Filter))
+		{
+			OutPath.Reset();
+			return SearchFail;
+		}
+
+		Step(Filter, MAX_int32);
+
+		if (Result == SearchSuccess || Filter.WantsPartialSolution())
+		{
+			BuildPath(OutPath);
+		}
+		else
+		{
+			OutPath.Reset();
+		}
+
+		return Result;
+	}
+
+	/**
+	 * 初始化搜索, 起点或终点无效时返回false
+	 */
+	template <typename TQueryFilter>
+	bool BeginSearch(const int32 InStartIndex, const int32 InEndIndex, const TQueryFilter& Filter)
+	{
+		const int32 NodeCount = Filter.GetNodeCount();
+		StartIndex = InStartIndex;
+		EndIndex = InEndIndex;
+		BestNodeIndex = INDEX_NONE;
+		BestNodeHeuristic = TNumericLimits<float>::Max();
+		NumExpandedNodes = 0;
+		PeakOpenNodes = 0;
+		Result = SearchFail;
+		bFinished = true;
+
+		if (StartIndex < 0 || StartIndex >= NodeCount || EndIndex < 0 || EndIndex >= NodeCount)
+		{
+			return false;
+		}
+
+		Workspace.BeginSearch(NodeCount);
+
+		const float StartHeuristic = Filter.GetHeuristicScale() * Filter.GetHeuristicCost(StartIndex, EndIndex);
+		Workspace.Visit(StartIndex, 0.f, INDEX_NONE);
+		Workspace.OpenHeap.HeapPush({StartHeuristic, StartIndex}, FGridSearchWorkspace::FOpenNodePredicate());
+		BestNodeIndex = StartIndex;
+		BestNodeHeuristic = StartHeuristic;
+		bFinished = false;
+		return true;
+	}
+
+	/**
+	 * 最多展开MaxExpansions个节点， 搜索结束时返回true
+	 */
+	template <typename TQueryFilter>
+	bool Step(const TQueryFilter& Filter, const int32 MaxExpansions)
+	{
+		if (bFinished)
+		{
+			return true;
+		}
+
+		const FGridSearchWorkspace::FOpenNodePredicate Predicate;
+		const float HeuristicScale = Filter.GetHeuristicScale();
+		const int32 NeighbourCount = Filter.GetNeighbourCount();
+		int32 StepExpansions = 0;
+
+		while (Workspace.OpenHeap.Num() > 0)
+		{
+			if (StepExpansions >= MaxExpansions)
+			{
+				return false;
+			}
+
+			FGridSearchWorkspace::FOpenNode Current;
+			Workspace.OpenHeap.HeapPop(Current, Predicate, EAllowShrinking::No);
+
+			const int32 CurrentIndex = Current.NodeIndex;
+			if (Workspace.IsClosed(CurrentIndex))
+			{
+				// 已经以更低的Cost展开过
+				continue;
+			}
+
+			Workspace.Close(CurrentIndex);
+			++StepExpansions;
+			++NumExpandedNodes;
+
+			if (IsGoal(Filter, CurrentIndex))
+			{
+				BestNodeIndex = CurrentIndex;
+				Result = SearchSuccess;
+				bFinished = true;
+				return true;
+			}
+
+			const float CurrentG = Workspace.GScores[CurrentIndex];
+			for (int32 Direction = 0; Direction < NeighbourCount; ++Direction)
+			{
+				const int32 NeighbourIndex = Filter.GetNeighbour(CurrentIndex, Direction);
+				if (NeighbourIndex == INDEX_NONE || Workspace.IsClosed(NeighbourIndex))
+				{
+					continue;
+				}
+
+				FVector::FReal EdgeCost;
+				if (!Filter.TryGetEdgeCost(CurrentIndex, Direction, NeighbourIndex, EdgeCost))
+				{
+					continue;
+				}
+
+				const float NewG = CurrentG + static_cast<float>(EdgeCost);
+				if (Workspace.IsVisited(NeighbourIndex) && NewG >= Workspace.GScores[NeighbourIndex])
+				{
+					continue;
+				}
+
+				const float Heuristic = HeuristicScale * Filter.GetHeuristicCost(NeighbourIndex, EndIndex);
+				Workspace.Visit(NeighbourIndex, NewG, CurrentIndex);
+				Workspace.OpenHeap.HeapPush({NewG + Heuristic, NeighbourIndex}, Predicate);
+
+				if (Heuristic < BestNodeHeuristic)
+				{
+					BestNodeHeuristic = Heuristic;
+					BestNodeIndex = NeighbourIndex;
+				}
+			}
+
+			PeakOpenNodes = FMath::Max(PeakOpenNodes, Workspace.OpenHeap.Num());
+		}
+
+		Result = GoalUnreachable;
+		bFinished = true;
+		return true;
+	}
+
+	/**
+	 * 搜索成功时为到终点的路径， 否则为到启发值最小节点的部分路径
+	 */
+	void BuildPath(TArray<int32>& OutPath) const;
+
+	EGraphAStarResult GetResult() const { return Result; }
+
+	/**
+	 * 搜索成功时到达的终点， 多终点搜索时可能不是EndIndex
+	 */
+	int32 GetReachedGoalIndex() const { return Result == SearchSuccess ? BestNodeIndex : INDEX_NONE; }
+
+	bool IsFinished() const { return bFinished; }
+
+	int32 GetNumExpandedNodes() const { return NumExpandedNodes; }
+
+	// Open列表的最大长度(包含已关闭的旧节点)
+	int32 GetPeakOpenNodes() const { return PeakOpenNodes; }
+
+	/**
+	 * BuildPath得到的路径的Cost
+	 */
+	float GetPathCost() const;
+
+private:
+	template <typename TQueryFilter>
+	FORCEINLINE bool IsGoal(const TQueryFilter& Filter, const int32 NodeIndex) const
+	{
+		if constexpr (GridAStarPrivate::THasIsGoal<TQueryFilter>::value)
+		{
+			return NodeIndex == EndIndex || Filter.IsGoal(NodeIndex);
+		}
+		else
+		{
+			return NodeIndex == EndIndex;
+		}
+	}
+
+	FGridSearchWorkspace& Workspace;
+
+	int32 StartIndex = INDEX_NONE;
+	int32 EndIndex = INDEX_NONE;
+	int32 BestNodeIndex = INDEX_NONE;
+	float BestNodeHeuristic = 0.f;
+	int32 NumExpandedNodes = 0;
+	int32 PeakOpenNodes = 0;
+	EGraphAStarResult Result = SearchFail;
+	bool bFinished = true;
+};
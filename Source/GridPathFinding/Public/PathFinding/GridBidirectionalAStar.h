@@ -0,0 +1,212 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PathFinding/GridAStar.h"
+
+/**
+ * 双向A*， 从起点和终点同时搜索， 在中间相遇
+ * 两侧使用平均势函数 P(v) = (h(v, End) - h(Start, v)) / 2， 正向Key为 G + P， 反向Key为 G - P，
+ * 两侧最小Key之和不小于已知的最短路径时即可结束， 结果与单向A*同样是最优路径
+ *
+ * 每次展开Open列表较小的一侧， 终点不可达时只要有一侧先耗尽就结束，
+ * 被困在小区域中的终点(或起点)不再需要把整个连通区域搜索一遍
+ *
+ * TQueryFilter 的要求与 FGridAStar 相同， 反向搜索时通过相反方向的TryGetEdgeCost获取 邻居 -> 当前格子 的Cost
+ * 终点不可达时， 部分路径为正向搜索中启发值最小的节点， 可能与FGridAStar的部分路径不同
+ */
+class GRIDPATHFINDING_API FGridBidirectionalAStar
+{
+public:
+	/**
+	 * 使用当前线程的两份Workspace
+	 */
+	FGridBidirectionalAStar();
+
+	FGridBidirectionalAStar(FGridSearchWorkspace& InForwardWorkspace, FGridSearchWorkspace& InBackwardWorkspace)
+		: ForwardWorkspace(InForwardWorkspace), BackwardWorkspace(InBackwardWorkspace)
+	{
+	}
+
+	template <typename TQueryFilter>
+	EGraphAStarResult FindPath(const int32 InStartIndex, const int32 InEndIndex, const TQueryFilter& Filter, TArray<int32>& OutPath)
+	{
+		const int32 NodeCount = Filter.GetNodeCount();
+		StartIndex = InStartIndex;
+		EndIndex = InEndIndex;
+		MeetNodeIndex = INDEX_NONE;
+		BestPathCost = TNumericLimits<float>::Max();
+		BestNodeIndex = INDEX_NONE;
+		BestNodeHeuristic = TNumericLimits<float>::Max();
+		NumExpandedNodes = 0;
+		PeakOpenNodes = 0;
+		Result = SearchFail;
+		OutPath.Reset();
+
+		if (StartIndex < 0 || StartIndex >= NodeCount || EndIndex < 0 || EndIndex >= NodeCount)
+		{
+			return SearchFail;
+		}
+
+		ForwardWorkspace.BeginSearch(NodeCount);
+		BackwardWorkspace.BeginSearch(NodeCount);
+
+		const FGridSearchWorkspace::FOpenNodePredicate Predicate;
+		ForwardWorkspace.Visit(StartIndex, 0.f, INDEX_NONE);
+		ForwardWorkspace.OpenHeap.HeapPush({GetPotential(Filter, StartIndex), StartIndex}, Predicate);
+		BackwardWorkspace.Visit(EndIndex, 0.f, INDEX_NONE);
+		BackwardWorkspace.OpenHeap.HeapPush({-GetPotential(Filter, EndIndex), EndIndex}, Predicate);
+		BestNodeIndex = StartIndex;
+		BestNodeHeuristic = Filter.GetHeuristicScale() * Filter.GetHeuristicCost(StartIndex, EndIndex);
+
+		while (ForwardWorkspace.OpenHeap.Num() > 0 && BackwardWorkspace.OpenHeap.Num() > 0)
+		{
+			// 堆顶可能是已关闭的旧节点， 其Key只会更小， 不影响结果的正确性
+			if (ForwardWorkspace.OpenHeap.HeapTop().TotalCost + BackwardWorkspace.OpenHeap.HeapTop().TotalCost >= BestPathCost)
+			{
+				break;
+			}
+
+			if (ForwardWorkspace.OpenHeap.Num() <= BackwardWorkspace.OpenHeap.Num())
+			{
+				ExpandNode<true>(Filter);
+			}
+			else
+			{
+				ExpandNode<false>(Filter);
+			}
+
+			PeakOpenNodes = FMath::Max(PeakOpenNodes, ForwardWorkspace.OpenHeap.Num() + BackwardWorkspace.OpenHeap.Num());
+		}
+
+		Result = MeetNodeIndex != INDEX_NONE ? SearchSuccess : GoalUnreachable;
+		if (Result == SearchSuccess || Filter.WantsPartialSolution())
+		{
+			BuildPath(OutPath);
+		}
+
+		return Result;
+	}
+
+	/**
+	 * 搜索成功时为到终点的路径， 否则为正向搜索中到启发值最小节点的部分路径
+	 */
+	void BuildPath(TArray<int32>& OutPath) const;
+
+	EGraphAStarResult GetResult() const { return Result; }
+
+	int32 GetNumExpandedNodes() const { return NumExpandedNodes; }
+
+	// 两侧Open列表长度之和的最大值
+	int32 GetPeakOpenNodes() const { return PeakOpenNodes; }
+
+	/**
+	 * BuildPath得到的路径的Cost
+	 */
+	float GetPathCost() const;
+
+private:
+	template <typename TQueryFilter>
+	FORCEINLINE float GetPotential(const TQueryFilter& Filter, const int32 NodeIndex) const
+	{
+		return 0.5f * Filter.GetHeuristicScale() * static_cast<float>(Filter.GetHeuristicCost(NodeIndex, EndIndex) - Filter.GetHeuristicCost(StartIndex, NodeIndex));
+	}
+
+	FORCEINLINE void UpdateMeetNode(const int32 NodeIndex)
+	{
+		const float PathCost = ForwardWorkspace.GScores[NodeIndex] + BackwardWorkspace.GScores[NodeIndex];
+		if (PathCost < BestPathCost)
+		{
+			BestPathCost = PathCost;
+			MeetNodeIndex = NodeIndex;
+		}
+	}
+
+	template <bool bForward, typename TQueryFilter>
+	void ExpandNode(const TQueryFilter& Filter)
+	{
+		FGridSearchWorkspace& Workspace = bForward ? ForwardWorkspace : BackwardWorkspace;
+		const FGridSearchWorkspace& OtherWorkspace = bForward ? BackwardWorkspace : ForwardWorkspace;
+		const FGridSearchWorkspace::FOpenNodePredicate Predicate;
+
+		FGridSearchWorkspace::FOpenNode Current;
+		Workspace.OpenHeap.HeapPop(Current, Predicate, EAllowShrinking::No);
+
+		const int32 CurrentIndex = Current.NodeIndex;
+		if (Workspace.IsClosed(CurrentIndex))
+		{
+			// 已经以更低的Cost展开过
+			return;
+		}
+
+		Workspace.Close(CurrentIndex);
+		++NumExpandedNodes;
+
+		if (OtherWorkspace.IsVisited(CurrentIndex))
+		{
+			UpdateMeetNode(CurrentIndex);
+		}
+
+		const float CurrentG = Workspace.GScores[CurrentIndex];
+		const float HeuristicScale = Filter.GetHeuristicScale();
+		const int32 NeighbourCount = Filter.GetNeighbourCount();
+		for (int32 Direction = 0; Direction < NeighbourCount; ++Direction)
+		{
+			const int32 NeighbourIndex = Filter.GetNeighbour(CurrentIndex, Direction);
+			if (NeighbourIndex == INDEX_NONE || Workspace.IsClosed(NeighbourIndex))
+			{
+				continue;
+			}
+
+			// 反向搜索沿着 Neighbour -> Current 这条边， 其方向与Direction相反
+			FVector::FReal EdgeCost;
+			const bool bAllowed = bForward
+				                      ? Filter.TryGetEdgeCost(CurrentIndex, Direction, NeighbourIndex, EdgeCost)
+				                      : Filter.TryGetEdgeCost(NeighbourIndex, (Direction + NeighbourCount / 2) % NeighbourCount, CurrentIndex, EdgeCost);
+			if (!bAllowed)
+			{
+				continue;
+			}
+
+			const float NewG = CurrentG + static_cast<float>(EdgeCost);
+			if (Workspace.IsVisited(NeighbourIndex) && NewG >= Workspace.GScores[NeighbourIndex])
+			{
+				continue;
+			}
+
+			Workspace.Visit(NeighbourIndex, NewG, CurrentIndex);
+			const float Potential = GetPotential(Filter, NeighbourIndex);
+			Workspace.OpenHeap.HeapPush({bForward ? NewG + Potential : NewG - Potential, NeighbourIndex}, Predicate);
+
+			if (OtherWorkspace.IsVisited(NeighbourIndex))
+			{
+				UpdateMeetNode(NeighbourIndex);
+			}
+
+			if (bForward)
+			{
+				const float Heuristic = HeuristicScale * Filter.GetHeuristicCost(NeighbourIndex, EndIndex);
+				if (Heuristic < BestNodeHeuristic)
+				{
+					BestNodeHeuristic = Heuristic;
+					BestNodeIndex = NeighbourIndex;
+				}
+			}
+		}
+	}
+
+	// 正向搜索的ParentIndices指向起点方向， 反向搜索的ParentIndices指向终点方向
+	FGridSearchWorkspace& ForwardWorkspace;
+	FGridSearchWorkspace& BackwardWorkspace;
+
+	int32 StartIndex = INDEX_NONE;
+	int32 EndIndex = INDEX_NONE;
+	// 两侧相遇的节点， 最短路径经过该节点
+	int32 MeetNodeIndex = INDEX_NONE;
+	float BestPathCost = 0.f;
+	// 正向搜索中启发值最小的节点， 用于部分路径
+	int32 BestNodeIndex = INDEX_NONE;
+	float BestNodeHeuristic = 0.f;
+	int32 NumExpandedNodes = 0;
+	int32 PeakOpenNodes = 0;
+	EGraphAStarResult Result = SearchFail;
+};
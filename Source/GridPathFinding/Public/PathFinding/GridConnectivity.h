@@ -0,0 +1,73 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UGridMapModel;
+
+/**
+ * 格子的连通区域标记， 用于在搜索前O(1)排除不可达的终点
+ * 只考虑格子本身是否阻挡(FTileInfo::IsBlocking)， 阻挡的格子没有连通区域
+ * 阻挡变化时增量更新:
+ *  - 格子变为可通行: 合并相邻的连通区域， 只重新标记较小的区域
+ *  - 格子变为阻挡: 相邻的可通行格子在环上连续时不可能被分割， 否则从每一段同时向外搜索， 只重新标记先搜索完的较小区域
+ */
+class GRIDPATHFINDING_API FGridConnectivity
+{
+public:
+	/**
+	 * 重新标记整张地图
+	 */
+	void Build(const UGridMapModel& InMapModel);
+
+	void Reset();
+
+	bool IsBuilt() const
+	{
+		return ComponentIds.Num() > 0;
+	}
+
+	/**
+	 * 格子的阻挡状态可能发生了变化， 在修改格子数据之后调用
+	 */
+	void UpdateTile(const UGridMapModel& InMapModel, int32 TileIndex);
+
+	/**
+	 * @return 阻挡的格子或无效的Index返回INDEX_NONE
+	 */
+	FORCEINLINE int32 GetComponentId(int32 TileIndex) const
+	{
+		return ComponentIds.IsValidIndex(TileIndex) ? ComponentIds[TileIndex] : INDEX_NONE;
+	}
+
+	/**
+	 * 从StartIndex是否可能走到EndIndex
+	 * 起点本身被阻挡时仍然可以走出来， 此时检查相邻的格子
+	 */
+	bool AreConnected(const UGridMapModel& InMapModel, int32 StartIndex, int32 EndIndex) const;
+
+	int32 GetNumComponents() const
+	{
+		return ComponentSizes.Num();
+	}
+
+private:
+	bool IsPassable(const UGridMapModel& InMapModel, int32 TileIndex) const;
+
+	/**
+	 * 把SeedIndex所在的FromId区域全部标记为ToId
+	 * @return 重新标记的格子数量
+	 */
+	int32 Relabel(const UGridMapModel& InMapModel, int32 SeedIndex, int32 FromId, int32 ToId);
+
+	void MergeAround(const UGridMapModel& InMapModel, int32 TileIndex);
+
+	void SplitAround(const UGridMapModel& InMapModel, int32 TileIndex, int32 OldId);
+
+	// [TileIndex] 连通区域ID
+	TArray<int32> ComponentIds;
+
+	// 连通区域ID -> 格子数量
+	TMap<int32, int32> ComponentSizes;
+
+	int32 NextComponentId = 0;
+};
@@ -0,0 +1,140 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PathFinding/GridAStar.h"
+
+class UGridMapModel;
+struct FGridPathFilter;
+
+/**
+ * (格子, 时间步)的预约表， 所有数据存放在一个数组中: [TimeSlot * NodeCount + TileIndex]
+ * 时间步按 WindowSize + 1 循环使用， 预约记录自身的时间步与规划轮次， 不匹配的记录视为空闲， 不需要清空
+ */
+class GRIDPATHFINDING_API FGridReservationTable
+{
+public:
+	void Initialize(int32 InNodeCount, int32 InWindowSize);
+
+	/**
+	 * 开始新一轮规划， 之前所有的预约失效
+	 */
+	void BeginRound();
+
+	void Reserve(int32 TileIndex, int32 TimeStep, int32 AgentId);
+
+	/**
+	 * 被其他寻路者预约时返回true
+	 */
+	FORCEINLINE bool IsReservedByOther(int32 TileIndex, int32 TimeStep, int32 AgentId) const
+	{
+		const FReservation& Reservation = Reservations[GetSlot(TileIndex, TimeStep)];
+		return Reservation.Round == Round && Reservation.TimeStep == TimeStep && Reservation.AgentId != AgentId;
+	}
+
+	/**
+	 * @return 预约该格子的寻路者， 空闲为INDEX_NONE
+	 */
+	FORCEINLINE int32 GetReservedAgent(int32 TileIndex, int32 TimeStep) const
+	{
+		const FReservation& Reservation = Reservations[GetSlot(TileIndex, TimeStep)];
+		return Reservation.Round == Round && Reservation.TimeStep == TimeStep ? Reservation.AgentId : INDEX_NONE;
+	}
+
+	int32 GetWindowSize() const
+	{
+		return WindowSize;
+	}
+
+private:
+	struct FReservation
+	{
+		int32 AgentId = INDEX_NONE;
+		int32 TimeStep = INDEX_NONE;
+		uint32 Round = 0;
+	};
+
+	FORCEINLINE int32 GetSlot(int32 TileIndex, int32 TimeStep) const
+	{
+		return (TimeStep % (WindowSize + 1)) * NodeCount + TileIndex;
+	}
+
+	TArray<FReservation> Reservations;
+	int32 NodeCount = 0;
+	int32 WindowSize = 0;
+	uint32 Round = 0;
+};
+
+/**
+ * 参与协同寻路的单位
+ */
+struct FGridCooperativeAgent
+{
+	// ---- 输入 ----
+	// 在一轮规划中唯一即可
+	int32 AgentId = INDEX_NONE;
+	int32 StartIndex = INDEX_NONE;
+	int32 GoalIndex = INDEX_NONE;
+	// IGridPathFindingIdentifier::GetGridPathFindingIdentifier
+	int32 Identifier = INDEX_NONE;
+
+	// ---- 输出 ----
+	// [Step] 第Step + 1个时间步所在的格子， 原地等待时与上一步相同； 到达终点后不再继续
+	TArray<int32> PlannedTiles;
+	// 在窗口内到达了终点
+	bool bReachesGoal = false;
+};
+
+/**
+ * 窗口化协同A*(WHCA*)
+ * 单位按优先级(数组顺序)依次在(格子, 时间步)空间中搜索， 避开排在前面的单位在窗口内预约的格子， 并预约自己的路径
+ * 每一步可以走到相邻格子或原地等待， 同时禁止两个单位在同一步中互换位置
+ * 窗口之外的部分只用启发值估计， 单位应在走完约一半窗口后重新规划
+ *
+ * 格子的阻挡与Cost仍然使用FGridPathFilter， 站立的单位如果通过BlockCount阻挡格子， 会与预约表重复阻挡
+ */
+class GRIDPATHFINDING_API FGridCooperativePathFinder
+{
+public:
+	/**
+	 * @param InWindowSize 向前规划的时间步数量， 内存占用为 格子数量 * (WindowSize + 1) * 12 字节
+	 */
+	void Initialize(UGridMapModel& InMapModel, int32 InWindowSize = 16);
+
+	/**
+	 * 按数组顺序为所有单位重新规划， 上一轮的预约全部失效
+	 * @param CurrentTimeStep 单位位于StartIndex的时间步， 只需要单调递增
+	 * @return 窗口内到达终点的单位数量
+	 */
+	int32 PlanPaths(TArrayView<FGridCooperativeAgent> Agents, int32 CurrentTimeStep);
+
+	const FGridReservationTable& GetReservationTable() const
+	{
+		return ReservationTable;
+	}
+
+	// 原地等待一步的Cost
+	float WaitCost = 1.f;
+
+private:
+	/**
+	 * 单个单位的时空A*， 找不到任何可行的移动时返回false， 此时原地等待
+	 */
+	bool PlanAgent(const FGridPathFilter& Filter, FGridCooperativeAgent& Agent, int32 CurrentTimeStep);
+
+	/**
+	 * 从 FromIndex(TimeStep) 走到 ToIndex(TimeStep + 1) 是否与已有的预约冲突
+	 */
+	bool HasConflict(int32 FromIndex, int32 ToIndex, int32 TimeStep, int32 AgentId) const;
+
+	void ReservePath(const FGridCooperativeAgent& Agent, int32 CurrentTimeStep);
+
+	TWeakObjectPtr<UGridMapModel> WeakMapModel;
+
+	FGridReservationTable ReservationTable;
+
+	// 时空状态 Step * NodeCount + TileIndex 的搜索数据
+	FGridSearchWorkspace Workspace;
+
+	int32 NodeCount = 0;
+	int32 WindowSize = 0;
+};
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UGridMapModel;
+
+/**
+ * 按身份标识(IGridPathFindingIdentifier::GetGridPathFindingIdentifier)预计算的边Cost表
+ * 每个格子6个方向各一项， 值为 1 + GetTraversalCost， 不可通行为MAX_flt
+ * 寻路时直接读取内存， 不再逐条边调用虚函数CanTravelTo、GetTraversalCost
+ *
+ * 表的内容由 UGridMapModel::FillTileEdgeCosts 填充， 子类可以重写
+ * 格子变化时只重新填充该格子与相邻格子， 与FGridConnectivity相同， 在修改格子数据的线程上更新
+ */
+class GRIDPATHFINDING_API FGridCostLayers
+{
+public:
+	static constexpr int32 NumDirections = 6;
+
+	/**
+	 * 构建(或重建)一个身份标识的Cost表， SupportsParallelPathQueries返回true时在工作线程上调用FillTileEdgeCosts
+	 */
+	void BuildLayer(UGridMapModel& InMapModel, int32 Identifier);
+
+	void Reset();
+
+	/**
+	 * 格子的寻路数据发生变化， 在修改格子数据之后调用
+	 */
+	void UpdateTile(UGridMapModel& InMapModel, int32 TileIndex);
+
+	/**
+	 * @return [TileIndex * NumDirections + Direction]， 没有该身份标识的表时返回nullptr
+	 */
+	const float* FindLayer(int32 Identifier) const
+	{
+		const TArray<float>* Layer = Layers.Find(Identifier);
+		return Layer ? Layer->GetData() : nullptr;
+	}
+
+	int32 GetNumLayers() const
+	{
+		return Layers.Num();
+	}
+
+private:
+	TMap<int32, TArray<float>> Layers;
+};
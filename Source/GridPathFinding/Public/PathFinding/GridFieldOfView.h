@@ -0,0 +1,108 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PathFinding/GridFifoCache.h"
+#include <atomic>
+
+class UGridMapModel;
+
+/**
+ * 批量视野查询， 输入输出都使用格子Index(StableGetFullMapGridIterIndex)
+ */
+struct FGridVisibilityRequest
+{
+	FGridVisibilityRequest()
+	{
+	}
+
+	FGridVisibilityRequest(int32 InSourceIndex, int32 InRadius) : SourceIndex(InSourceIndex), Radius(InRadius)
+	{
+	}
+
+	int32 SourceIndex = INDEX_NONE;
+	int32 Radius = 0;
+
+	// 输出， 按格子Index升序， 包含起点
+	TArray<int32> VisibleTiles;
+};
+
+/**
+ * 六边形地图的视野(对称阴影投射)
+ *
+ * 以起点为中心把地图分成6个扇区， 扇区内第d层是一段由d+1个格子组成的直线， 逐层向外扫描并收窄未被遮挡的斜率区间
+ * 一次扫描得到半径内的全部可见格子， 每个格子只读取一次阻挡位， 不需要逐个目标做插值取整
+ * 结果对称: A能看到B时B也能看到A(两者都不是阻挡格子时)
+ *
+ * 阻挡视线的格子记录在按格子Index排列的位数组中， 来自 UGridMapModel::IsTileBlockingSight (环境类型与Token)
+ * 地图边界之外视为阻挡； 阻挡视线的格子本身可见， 但其后方不可见
+ * 只支持BaseOnRowColumn绘制模式的六边形地图
+ */
+class GRIDPATHFINDING_API FGridFieldOfView
+{
+public:
+	/**
+	 * 重新读取所有格子的阻挡状态
+	 */
+	void Build(UGridMapModel& InMapModel);
+
+	void Reset();
+
+	bool IsBuilt() const
+	{
+		return BlocksSight.Num() > 0;
+	}
+
+	/**
+	 * 格子是否阻挡视线可能发生了变化， 只有确实变化时才使缓存的视野失效
+	 */
+	void UpdateTile(UGridMapModel& InMapModel, int32 TileIndex);
+
+	FORCEINLINE bool IsBlockingSight(int32 TileIndex) const
+	{
+		return !BlocksSight.IsValidIndex(TileIndex) || BlocksSight[TileIndex];
+	}
+
+	/**
+	 * 阻挡状态每次变化加1
+	 */
+	uint32 GetVersion() const { return Version.load(); }
+
+	/**
+	 * 半径内从SourceIndex可见的格子， 开启缓存时优先使用缓存， 可以在多个线程中同时调用
+	 * @param OutVisibleTiles 按格子Index升序， 包含起点
+	 */
+	void ComputeVisibleTiles(const UGridMapModel& InMapModel, int32 SourceIndex, int32 Radius, TArray<int32>& OutVisibleTiles);
+
+	/**
+	 * 在工作线程上并行计算， 调用期间不能修改阻挡状态(Build/Reset/UpdateTile中会check)
+	 */
+	void ComputeVisibleTilesBatch(const UGridMapModel& InMapModel, TArrayView<FGridVisibilityRequest> Requests);
+
+	/**
+	 * 与ComputeVisibleTiles的结果一致， 只扫描目标所在的扇区
+	 */
+	bool HasLineOfSight(const UGridMapModel& InMapModel, int32 FromIndex, int32 ToIndex) const;
+
+	/**
+	 * 缓存(起点, 半径)对应的视野， 满了之后淘汰最早加入的一项， 阻挡状态变化后全部失效， 0表示关闭
+	 */
+	void SetMaxCacheEntries(int32 InMaxEntries);
+
+private:
+	void ComputeVisibleTilesUncached(const UGridMapModel& InMapModel, int32 SourceIndex, int32 Radius, TArray<int32>& OutVisibleTiles) const;
+
+	// [TileIndex]
+	TBitArray<> BlocksSight;
+
+	// 工作线程在CacheLock外读取， 使用原子变量
+	std::atomic<uint32> Version{0};
+
+	// 正在进行的ComputeVisibleTilesBatch数量， 用于检查批量查询期间没有修改阻挡状态
+	std::atomic<int32> NumBatchQueries{0};
+
+	// Key为 SourceIndex << 32 | Radius
+	TGridFifoCache<uint64, TArray<int32>> CachedResults;
+	// CachedResults对应的Version
+	uint32 CachedVersion = 0;
+	FCriticalSection CacheLock;
+};
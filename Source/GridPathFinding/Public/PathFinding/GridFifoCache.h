@@ -0,0 +1,89 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * 容量固定的缓存， 满了之后按插入顺序淘汰最早的一项(FIFO)
+ * 插入顺序保存在环形数组中， 查找、插入、淘汰都是O(1)
+ * 不加锁， 由持有者负责同步
+ */
+template <typename KeyType, typename ValueType>
+class TGridFifoCache
+{
+public:
+	/**
+	 * 改变容量会清空缓存， 0表示不缓存
+	 */
+	void SetCapacity(int32 InCapacity)
+	{
+		Capacity = FMath::Max(0, InCapacity);
+		Empty();
+	}
+
+	int32 GetCapacity() const { return Capacity; }
+
+	int32 Num() const { return Values.Num(); }
+
+	const ValueType* Find(const KeyType& Key) const
+	{
+		return Values.Find(Key);
+	}
+
+	/**
+	 * 已存在时覆盖原值， 不改变其淘汰顺序
+	 * @return 缓存中的值， 容量为0时返回nullptr
+	 */
+	ValueType* Add(const KeyType& Key, const ValueType& Value)
+	{
+		if (Capacity <= 0)
+		{
+			return nullptr;
+		}
+
+		if (ValueType* Existing = Values.Find(Key))
+		{
+			*Existing = Value;
+			return Existing;
+		}
+
+		if (InsertionOrder.Num() < Capacity)
+		{
+			InsertionOrder.Add(Key);
+		}
+		else
+		{
+			// 环形数组已满， OldestSlot处是最早插入的Key
+			Values.Remove(InsertionOrder[OldestSlot]);
+			InsertionOrder[OldestSlot] = Key;
+			OldestSlot = (OldestSlot + 1) % Capacity;
+		}
+
+		return &Values.Add(Key, Value);
+	}
+
+	/**
+	 * 保留已分配的内存
+	 */
+	void Reset()
+	{
+		Values.Reset();
+		InsertionOrder.Reset();
+		OldestSlot = 0;
+	}
+
+	void Empty()
+	{
+		Values.Empty();
+		InsertionOrder.Empty();
+		OldestSlot = 0;
+	}
+
+private:
+	TMap<KeyType, ValueType> Values;
+
+	// 按插入顺序排列的Key， 填满之后作为环形数组使用
+	TArray<KeyType> InsertionOrder;
+	int32 OldestSlot = 0;
+
+	int32 Capacity = 0;
+};
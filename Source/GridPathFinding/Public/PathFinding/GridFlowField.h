@@ -0,0 +1,129 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PathFinding/GridAStar.h"
+
+/**
+ * 以单个终点为中心的流场， 所有数组都使用格子Index寻址
+ * 大量单位前往同一目标时， 每个单位只需要O(1)读取所在格子的方向， 不再各自寻路
+ * 方向与 UGridMapModel::GetNeighborCoord 的0-5约定一致
+ */
+struct GRIDPATHFINDING_API FGridFlowField
+{
+	static constexpr uint8 InvalidDirection = 0xFF;
+
+	int32 GoalIndex = INDEX_NONE;
+
+	// IGridPathFindingIdentifier::GetGridPathFindingIdentifier
+	int32 Identifier = INDEX_NONE;
+
+	// 构建时地图的TopologyVersion， 与地图当前版本不同时需要重建
+	uint32 TopologyVersion = 0;
+
+	// [TileIndex] 到终点的最小Cost， 不可达为MAX_flt
+	TArray<float> Distances;
+
+	// [TileIndex] 朝终点走的下一步方向， 终点和不可达的格子为InvalidDirection
+	TArray<uint8> Directions;
+
+	bool IsValid() const
+	{
+		return GoalIndex != INDEX_NONE && Distances.Num() > 0;
+	}
+
+	FORCEINLINE bool IsReachable(int32 TileIndex) const
+	{
+		return Distances.IsValidIndex(TileIndex) && Distances[TileIndex] < MAX_flt;
+	}
+
+	FORCEINLINE float GetDistance(int32 TileIndex) const
+	{
+		return Distances.IsValidIndex(TileIndex) ? Distances[TileIndex] : MAX_flt;
+	}
+
+	/**
+	 * @return 0-5， 没有下一步时返回INDEX_NONE
+	 */
+	FORCEINLINE int32 GetDirection(int32 TileIndex) const
+	{
+		if (!Directions.IsValidIndex(TileIndex) || Directions[TileIndex] == InvalidDirection)
+		{
+			return INDEX_NONE;
+		}
+
+		return Directions[TileIndex];
+	}
+
+	void Reset()
+	{
+		GoalIndex = INDEX_NONE;
+		Distances.Reset();
+		Directions.Reset();
+	}
+
+	/**
+	 * 从终点出发的反向Dijkstra， 每条边的Cost仍按单位的行走方向(格子 -> 终点方向的邻居)计算
+	 * TQueryFilter 的要求与 FGridAStar 相同
+	 */
+	template <typename TQueryFilter>
+	void Build(const TQueryFilter& Filter, const int32 InGoalIndex)
+	{
+		const int32 NodeCount = Filter.GetNodeCount();
+		GoalIndex = InGoalIndex;
+		Distances.Init(MAX_flt, NodeCount);
+		Directions.Init(InvalidDirection, NodeCount);
+
+		if (GoalIndex < 0 || GoalIndex >= NodeCount)
+		{
+			GoalIndex = INDEX_NONE;
+			return;
+		}
+
+		const FGridSearchWorkspace::FOpenNodePredicate Predicate;
+		const int32 NeighbourCount = Filter.GetNeighbourCount();
+		TArray<FGridSearchWorkspace::FOpenNode> OpenHeap;
+
+		Distances[GoalIndex] = 0.f;
+		OpenHeap.HeapPush({0.f, GoalIndex}, Predicate);
+
+		while (OpenHeap.Num() > 0)
+		{
+			FGridSearchWorkspace::FOpenNode Current;
+			OpenHeap.HeapPop(Current, Predicate, EAllowShrinking::No);
+
+			const int32 CurrentIndex = Current.NodeIndex;
+			if (Current.TotalCost > Distances[CurrentIndex])
+			{
+				// 已经以更低的Cost展开过
+				continue;
+			}
+
+			for (int32 Direction = 0; Direction < NeighbourCount; ++Direction)
+			{
+				const int32 NeighbourIndex = Filter.GetNeighbour(CurrentIndex, Direction);
+				if (NeighbourIndex == INDEX_NONE)
+				{
+					continue;
+				}
+
+				// 单位从Neighbour走到Current， 方向与Direction相反
+				const int32 BackDirection = (Direction + NeighbourCount / 2) % NeighbourCount;
+				FVector::FReal EdgeCost;
+				if (!Filter.TryGetEdgeCost(NeighbourIndex, BackDirection, CurrentIndex, EdgeCost))
+				{
+					continue;
+				}
+
+				const float NewDistance = Current.TotalCost + static_cast<float>(EdgeCost);
+				if (NewDistance >= Distances[NeighbourIndex])
+				{
+					continue;
+				}
+
+				Distances[NeighbourIndex] = NewDistance;
+				Directions[NeighbourIndex] = static_cast<uint8>(BackDirection);
+				OpenHeap.HeapPush({NewDistance, NeighbourIndex}, Predicate);
+			}
+		}
+	}
+};
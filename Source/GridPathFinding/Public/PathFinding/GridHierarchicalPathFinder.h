@@ -0,0 +1,109 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/ThreadSafeBool.h"
+
+class UGridMapModel;
+struct FGridPathFilter;
+struct FGridSearchWorkspace;
+
+/**
+ * 基于Chunk分区(StableGetCoordChunkIndex)的分层寻路(HPA*)
+ *
+ * 抽象图的节点是Chunk边界上的入口格子， 边分为两种:
+ *  1. 同一Chunk内两个入口之间的最短路径Cost， 只在Chunk内部搜索得到
+ *  2. 相邻Chunk的一对入口格子之间的一步
+ * 长距离查询先在抽象图上搜索， 再用FGridAStar逐段细化成格子路径
+ *
+ * 格子变化时只把它所在的Chunk以及相邻格子所在的Chunk标记为脏， 下一次查询前重建
+ * 抽象图的Cost使用默认身份标识(INDEX_NONE)计算， 细化时使用查询自身的Filter， 因此结果接近最优但不保证最优
+ */
+class GRIDPATHFINDING_API FGridHierarchicalPathFinder
+{
+public:
+	/**
+	 * 地图数据构建完成后调用， 重新划分Chunk， 所有Chunk标记为待重建
+	 */
+	void Initialize(UGridMapModel& InMapModel);
+
+	void Reset();
+
+	/**
+	 * 格子的寻路数据发生变化
+	 */
+	void MarkTileDirty(int32 TileIndex);
+
+	/**
+	 * 起点终点不在同一个Chunk， 并且距离不小于MinDistance时才使用分层寻路
+	 */
+	bool ShouldUse(int32 StartIndex, int32 EndIndex, int32 MinDistance) const;
+
+	/**
+	 * 只返回到达终点的完整路径， 返回false时调用方应使用FGridAStar重新搜索(例如终点不可达， 需要部分路径)
+	 * 会在调用线程上重建脏Chunk， 可以在多个线程中同时调用
+	 * @param OutPath 不包含起点， 包含终点
+	 */
+	bool TryFindPath(const FGridPathFilter& Filter, int32 StartIndex, int32 EndIndex, TArray<int32>& OutPath, float& OutPathCost);
+
+private:
+	struct FInterEdge
+	{
+		// 相邻Chunk中的入口格子
+		int32 ToTileIndex;
+		float Cost;
+	};
+
+	struct FChunkGraph
+	{
+		// Chunk内的入口格子， 下标即为入口在Chunk内的Slot
+		TArray<int32> EntranceTiles;
+		// [FromSlot * EntranceTiles.Num() + ToSlot], 只在Chunk内部不可达时为MAX_flt
+		TArray<float> IntraCosts;
+		// [Slot], 从该入口一步走到相邻Chunk的边
+		TArray<TArray<FInterEdge>> InterEdges;
+		bool bDirty = true;
+	};
+
+	struct FTransition
+	{
+		// 较小的Chunk一侧的格子
+		int32 MinSideTile;
+		// 较大的Chunk一侧的格子
+		int32 MaxSideTile;
+		// MinSideTile到MaxSideTile的方向
+		int32 Direction;
+	};
+
+	// 调用前需要持有写锁， 持有锁后会再次检查bHasDirtyChunks
+	void RebuildDirtyChunks();
+
+	void RebuildChunk(const FGridPathFilter& Filter, FGridSearchWorkspace& Workspace, int32 ChunkIndex);
+
+	/**
+	 * 两个相邻Chunk之间的入口， 无论从哪一侧调用结果都相同
+	 * 边界上连续可通行的格子构成一段， 短的一段在中间放置一个入口， 长的一段在两端各放置一个
+	 */
+	void FindTransitions(const FGridPathFilter& Filter, int32 MinChunkIndex, int32 MaxChunkIndex, TArray<FTransition>& OutTransitions) const;
+
+	/**
+	 * 只在ChunkIndex内部的Dijkstra， 结束后Workspace中Closed的格子的GScores为最短Cost
+	 * @param bReverse 为true时计算的是各个格子到SourceIndex的Cost
+	 */
+	void SearchInsideChunk(const FGridPathFilter& Filter, FGridSearchWorkspace& Workspace, int32 ChunkIndex, int32 SourceIndex, bool bReverse) const;
+
+	UGridMapModel* MapModel = nullptr;
+
+	// [TileIndex] 格子所在的Chunk
+	TArray<int32> TileChunkIndices;
+	// [TileIndex] 格子在所在Chunk的EntranceTiles中的下标， 不是入口时为INDEX_NONE
+	TArray<int32> TileEntranceSlots;
+
+	TArray<TArray<int32>> ChunkTiles;
+	TArray<FChunkGraph> Chunks;
+
+	// 只在持有写锁时修改， 查询时不加锁读取， 没有脏Chunk时不需要获取写锁
+	FThreadSafeBool bHasDirtyChunks = false;
+
+	// 重建和标记脏Chunk时持有写锁， 查询时持有读锁
+	FRWLock Lock;
+};
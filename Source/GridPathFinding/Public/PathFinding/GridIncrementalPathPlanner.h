@@ -0,0 +1,165 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GraphAStar.h"
+
+class UGridMapModel;
+struct FGridPathFilter;
+
+/**
+ * 单个寻路者持有的增量寻路状态(D* Lite)
+ * 从终点向起点反向搜索， 格子数据变化后只修复受影响的部分， 寻路者沿路径移动时也不需要重新搜索
+ *
+ * 通过 UGridMapModel::OnTileNavDataDirty 自动收集变化的格子(阻挡、高度、环境、站立的Actor)，
+ * 这些变化在下一次Replan时统一处理
+ * 节点数据按需存放在TMap中， 只占用搜索实际访问过的格子
+ * 只能在游戏线程上使用
+ */
+class GRIDPATHFINDING_API FGridIncrementalPathPlanner
+{
+public:
+	FGridIncrementalPathPlanner() = default;
+	~FGridIncrementalPathPlanner();
+
+	UE_NONCOPYABLE(FGridIncrementalPathPlanner);
+
+	/**
+	 * @param InIdentifier IGridPathFindingIdentifier::GetGridPathFindingIdentifier
+	 */
+	void Initialize(UGridMapModel& InMapModel, int32 InIdentifier = INDEX_NONE);
+
+	/**
+	 * 解除与地图的绑定， 清空搜索状态
+	 */
+	void Release();
+
+	/**
+	 * 终点变化时之前的搜索结果全部作废
+	 */
+	void SetGoal(int32 InGoalIndex);
+
+	/**
+	 * 寻路者移动后更新起点， 不会使已有的搜索结果失效
+	 */
+	void SetStart(int32 InStartIndex);
+
+	/**
+	 * 处理积累的格子变化， 并修复到当前起点的最短路径
+	 * @return 成功时为SearchSuccess， 不可达为GoalUnreachable
+	 */
+	EGraphAStarResult Replan();
+
+	/**
+	 * 最近一次Replan得到的路径
+	 * @param OutPath 不包含起点， 包含终点
+	 */
+	bool GetPath(TArray<int32>& OutPath) const;
+
+	float GetPathCost() const;
+
+	bool HasPendingChanges() const
+	{
+		return PendingTiles.Num() > 0 || bNeedsReset;
+	}
+
+	int32 GetNumExpandedNodes() const { return NumExpandedNodes; }
+
+private:
+	struct FKey
+	{
+		float K1 = MAX_flt;
+		float K2 = MAX_flt;
+
+		friend bool operator<(const FKey& A, const FKey& B)
+		{
+			return A.K1 < B.K1 || (A.K1 == B.K1 && A.K2 < B.K2);
+		}
+
+		friend bool operator==(const FKey& A, const FKey& B)
+		{
+			return A.K1 == B.K1 && A.K2 == B.K2;
+		}
+	};
+
+	struct FNodeState
+	{
+		float G = MAX_flt;
+		float Rhs = MAX_flt;
+		// 在Open列表中时的Key， 堆中Key不同的旧元素出堆时跳过
+		FKey Key;
+		bool bInOpen = false;
+	};
+
+	struct FOpenNode
+	{
+		FKey Key;
+		int32 NodeIndex;
+	};
+
+	struct FOpenNodePredicate
+	{
+		FORCEINLINE bool operator()(const FOpenNode& A, const FOpenNode& B) const
+		{
+			return A.Key < B.Key;
+		}
+	};
+
+	void OnTileNavDataDirty(int32 TileIndex);
+
+	void OnTilesDataBuildComplete();
+
+	void ResetSearch();
+
+	FORCEINLINE float GetG(int32 NodeIndex) const
+	{
+		const FNodeState* State = States.Find(NodeIndex);
+		return State ? State->G : MAX_flt;
+	}
+
+	FORCEINLINE float GetRhs(int32 NodeIndex) const
+	{
+		const FNodeState* State = States.Find(NodeIndex);
+		return State ? State->Rhs : MAX_flt;
+	}
+
+	float GetHeuristic(int32 FromIndex, int32 ToIndex) const;
+
+	/**
+	 * 不可通行时返回MAX_flt
+	 */
+	float GetEdgeCost(int32 FromIndex, int32 Direction, int32 ToIndex) const;
+
+	FKey CalculateKey(int32 NodeIndex, const FNodeState& State) const;
+
+	void UpdateVertex(int32 NodeIndex);
+
+	void ComputeShortestPath();
+
+	// 丢弃堆顶已经失效的元素
+	void CleanOpenTop();
+
+	TWeakObjectPtr<UGridMapModel> WeakMapModel;
+	int32 Identifier = INDEX_NONE;
+
+	// 地图重新构建后需要重新创建
+	TUniquePtr<FGridPathFilter> PathFilter;
+
+	FDelegateHandle TileNavDataDirtyHandle;
+	FDelegateHandle BuildCompleteHandle;
+
+	int32 StartIndex = INDEX_NONE;
+	int32 LastStartIndex = INDEX_NONE;
+	int32 GoalIndex = INDEX_NONE;
+	// 起点移动后累计的Key修正值
+	float KeyModifier = 0.f;
+
+	TMap<int32, FNodeState> States;
+	TArray<FOpenNode> OpenHeap;
+
+	// 下一次Replan时需要处理的格子
+	TSet<int32> PendingTiles;
+	// 地图重新构建后需要完全重新搜索
+	bool bNeedsReset = false;
+
+	int32 NumExpandedNodes = 0;
+};
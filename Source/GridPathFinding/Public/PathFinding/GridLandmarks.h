@@ -0,0 +1,145 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UGridMapModel;
+struct FGridPathFilter;
+
+/**
+ * ALT(A*, Landmarks, Triangle inequality)启发式的预计算数据
+ * 选出K个路标格子， 记录每个格子从路标出发和走到路标的最小Cost， 用三角不等式得到比六边形距离更紧的下界:
+ *   h(V, T) = max(D(L, T) - D(L, V), D(V, L) - D(T, L))
+ * 格子Cost差异较大(沼泽、山地)时可以大幅减少A*展开的格子数量
+ *
+ * 只有Cost下降或格子变为可通行时下界才可能失效， 此时从变化的格子开始增量修复各路标的距离
+ * Cost上升或格子变为阻挡时保留旧距离， 下界变宽松但仍然可接受(不高估)
+ * 变化的格子先记录下来， 由FlushPendingRepairs一次修复， 同一帧内多次变化时每个路标只传播一次
+ * 存在未修复的格子时寻路不使用路标下界， 只使用六边形距离
+ */
+class GRIDPATHFINDING_API FGridLandmarks
+{
+public:
+	/**
+	 * 选择路标并计算距离
+	 * @param MemoryBudgetKB 距离数组可使用的内存， 每个路标占用 格子数量 * 8 字节
+	 * @param MaxLandmarkCount 路标数量上限
+	 * @param InIdentifier 计算距离使用的身份标识， 只有相同身份标识的查询会使用路标下界
+	 */
+	void Build(UGridMapModel& InMapModel, int32 MemoryBudgetKB, int32 MaxLandmarkCount, int32 InIdentifier = INDEX_NONE);
+
+	void Reset();
+
+	bool IsBuilt() const
+	{
+		return NumLandmarks > 0;
+	}
+
+	/**
+	 * 格子的寻路数据发生变化， 在修改格子数据之后调用， 只记录格子， 修复在FlushPendingRepairs中进行
+	 */
+	void UpdateTile(int32 TileIndex);
+
+	/**
+	 * 修复所有记录的格子影响到的距离， 调用期间不能有使用路标的寻路
+	 */
+	void FlushPendingRepairs(UGridMapModel& InMapModel);
+
+	bool HasPendingRepairs() const
+	{
+		return PendingTiles.Num() > 0;
+	}
+
+	/**
+	 * 距离使用该身份标识的Cost计算， 只对相同身份标识的查询有效
+	 */
+	int32 GetIdentifier() const
+	{
+		return Identifier;
+	}
+
+	int32 GetNumLandmarks() const
+	{
+		return NumLandmarks;
+	}
+
+	const TArray<int32>& GetLandmarkTiles() const
+	{
+		return LandmarkTiles;
+	}
+
+	/**
+	 * 从FromIndex到ToIndex的最小Cost的下界， 未构建时返回0
+	 */
+	FORCEINLINE float GetLowerBound(int32 FromIndex, int32 ToIndex) const
+	{
+		const float* FromForward = &ForwardDistances[FromIndex * NumLandmarks];
+		const float* ToForward = &ForwardDistances[ToIndex * NumLandmarks];
+		const float* FromBackward = &BackwardDistances[FromIndex * NumLandmarks];
+		const float* ToBackward = &BackwardDistances[ToIndex * NumLandmarks];
+
+		float Bound = 0.f;
+		for (int32 Slot = 0; Slot < NumLandmarks; ++Slot)
+		{
+			// 不可达的距离无法用于三角不等式
+			if (ToForward[Slot] < MAX_flt && FromForward[Slot] < MAX_flt)
+			{
+				Bound = FMath::Max(Bound, ToForward[Slot] - FromForward[Slot]);
+			}
+			if (FromBackward[Slot] < MAX_flt && ToBackward[Slot] < MAX_flt)
+			{
+				Bound = FMath::Max(Bound, FromBackward[Slot] - ToBackward[Slot]);
+			}
+		}
+		return Bound;
+	}
+
+private:
+	struct FOpenNode
+	{
+		float Distance;
+		int32 NodeIndex;
+	};
+
+	struct FOpenNodePredicate
+	{
+		FORCEINLINE bool operator()(const FOpenNode& A, const FOpenNode& B) const
+		{
+			return A.Distance < B.Distance;
+		}
+	};
+
+	/**
+	 * 从堆中的格子继续Dijkstra， 只会降低距离
+	 * @param bBackward 为false时更新从路标出发的距离， 为true时更新走到路标的距离
+	 */
+	template <bool bBackward>
+	void Propagate(const FGridPathFilter& Filter, int32 Slot, TArray<FOpenNode>& OpenHeap);
+
+	/**
+	 * 检查与TileIndex相连的边， 距离可以降低时入堆
+	 */
+	template <bool bBackward>
+	void SeedAroundTile(const FGridPathFilter& Filter, int32 Slot, int32 TileIndex, TArray<FOpenNode>& OpenHeap);
+
+	template <bool bBackward>
+	void BuildSlot(const FGridPathFilter& Filter, int32 Slot);
+
+	FORCEINLINE float& Distance(bool bBackward, int32 TileIndex, int32 Slot)
+	{
+		return (bBackward ? BackwardDistances : ForwardDistances)[TileIndex * NumLandmarks + Slot];
+	}
+
+	int32 Identifier = INDEX_NONE;
+	int32 NumLandmarks = 0;
+
+	TArray<int32> LandmarkTiles;
+
+	// 变化后还没有修复的格子
+	TSet<int32> PendingTiles;
+
+	// [TileIndex * NumLandmarks + Slot]， 同一格子的各路标距离连续存放， 计算下界时只读取两段连续内存
+	// 从路标出发的最小Cost
+	TArray<float> ForwardDistances;
+	// 走到路标的最小Cost
+	TArray<float> BackwardDistances;
+};
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GraphAStar.h"
+#include "PathFinding/GridTopology.h"
+
+/**
+ * 某一时刻地图寻路数据的只读副本， 由 UGridMapModel::PublishNavSnapshot 在游戏线程上发布
+ * 发布后不再修改， 工作线程持有TSharedPtr即可在不加锁的情况下寻路， 游戏线程同时修改地图也不会产生数据竞争
+ * 格子数据按Index划分为固定大小的页， 发布新快照时只复制包含变化格子的页(写时复制)， 其余的页和邻居表在快照之间共享
+ *
+ * 边Cost使用默认身份标识(INDEX_NONE)， 与 UGridMapModel::FillTileEdgeCosts 相同
+ * 邻居表和距离按行列排布的六边形计算， BaseOnRadius、BaseOnVolume等其他排布的地图不会发布快照
+ */
+struct GRIDPATHFINDING_API FGridNavSnapshot
+{
+	static constexpr int32 NumDirections = 6;
+
+	static constexpr int32 PageShift = 10;
+	static constexpr int32 PageSize = 1 << PageShift;
+	static constexpr int32 PageMask = PageSize - 1;
+
+	/**
+	 * Index连续的PageSize个格子的数据， 最后一页可能不满
+	 */
+	struct FPage
+	{
+		// [LocalIndex] 格子本身是否可通行(没有阻挡)
+		TBitArray<> PassableTiles;
+
+		// [LocalIndex] UGridMapModel::GetTileHeight
+		TArray<int32> TileHeights;
+
+		// [LocalIndex * NumDirections + Direction]， 1 + GetTraversalCost， 不可通行为MAX_flt
+		TArray<float> EdgeCosts;
+	};
+
+	// 快照对应的地图TopologyVersion
+	uint32 TopologyVersion = 0;
+
+	int32 NodeCount = 0;
+
+	FGridTopologyParams TopologyParams;
+	bool bFlatOrientation = true;
+
+	// [TileIndex * NumDirections + Direction]， 只在地图重新构建时变化
+	TSharedPtr<const TArray<int32>, ESPMode::ThreadSafe> NeighborTable;
+
+	// [TileIndex >> PageShift]， 发布后只读， 未变化的页与上一份快照共享
+	TArray<TSharedPtr<const FPage, ESPMode::ThreadSafe>> Pages;
+
+	FORCEINLINE bool IsPassable(int32 TileIndex) const
+	{
+		return static_cast<uint32>(TileIndex) < static_cast<uint32>(NodeCount) && Pages[TileIndex >> PageShift]->PassableTiles[TileIndex & PageMask];
+	}
+
+	FORCEINLINE int32 GetTileHeight(int32 TileIndex) const
+	{
+		return Pages[TileIndex >> PageShift]->TileHeights[TileIndex & PageMask];
+	}
+
+	FORCEINLINE int32 GetNeighbour(int32 TileIndex, int32 Direction) const
+	{
+		return (*NeighborTable)[TileIndex * NumDirections + Direction];
+	}
+
+	FORCEINLINE float GetEdgeCost(int32 TileIndex, int32 Direction) const
+	{
+		return Pages[TileIndex >> PageShift]->EdgeCosts[(TileIndex & PageMask) * NumDirections + Direction];
+	}
+
+	FORCEINLINE int32 GetDistance(int32 A, int32 B) const
+	{
+		return bFlatOrientation
+			       ? FGridHexFlatTopology::GetDistance(A, B, TopologyParams)
+			       : FGridHexPointyTopology::GetDistance(A, B, TopologyParams);
+	}
+
+	/**
+	 * 在快照上寻路， 可以在任意线程上调用， 使用当前线程的FGridSearchWorkspace
+	 * @param OutPath 不包含起点， 包含终点； 终点不可达时为部分路径
+	 */
+	EGraphAStarResult FindPath(int32 StartIndex, int32 EndIndex, TArray<int32>& OutPath, float& OutPathCost) const;
+};
+
+using FGridNavSnapshotPtr = TSharedPtr<const FGridNavSnapshot, ESPMode::ThreadSafe>;
@@ -0,0 +1,128 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * BaseOnVolume 地图的稀疏格子Index
+ * 轴向坐标(Q, R)按 PageSize * PageSize 划分为固定大小的页， 只为含有格子的页分配内存
+ * 页表覆盖所有页的外接范围， 每个页位置只占一个int32， 坐标到Index只需要查一次页表再统计页内的位， O(1)
+ *
+ * Index是连续的: 按页表顺序遍历页， 页内按Q、R递增， Tiles等按Index寻址的数组不会出现空洞
+ * 跨页的邻居同样通过坐标查找， 页的边界对寻路不可见
+ */
+class GRIDPATHFINDING_API FGridPagedTileIndex
+{
+public:
+	static constexpr int32 PageShift = 4;
+	static constexpr int32 PageSize = 1 << PageShift;
+	static constexpr int32 PageMask = PageSize - 1;
+	static constexpr int32 PageArea = PageSize * PageSize;
+	static constexpr int32 PageWords = PageArea / 64;
+
+	/**
+	 * @param InAxialCoords 地图中所有格子的(Q, R)， 允许重复
+	 */
+	void Build(const TArray<FIntPoint>& InAxialCoords);
+
+	void Reset();
+
+	FORCEINLINE int32 Num() const { return IndexToAxial.Num(); }
+
+	FORCEINLINE bool IsValidIndex(int32 TileIndex) const { return IndexToAxial.IsValidIndex(TileIndex); }
+
+	int32 GetPageCount() const { return Pages.Num(); }
+
+	/**
+	 * 不在地图中返回INDEX_NONE
+	 */
+	FORCEINLINE int32 GetIndex(const int32 Q, const int32 R) const
+	{
+		const int32 PageIndex = FindPage(Q, R);
+		if (PageIndex == INDEX_NONE)
+		{
+			return INDEX_NONE;
+		}
+
+		const FPage& Page = Pages[PageIndex];
+		const int32 Slot = GetSlot(Q, R);
+		const uint64 Word = Page.Bits[Slot >> 6];
+		const uint64 Bit = 1ull << (Slot & 63);
+		if ((Word & Bit) == 0)
+		{
+			return INDEX_NONE;
+		}
+
+		return Page.FirstIndex + Page.WordPrefix[Slot >> 6] + static_cast<int32>(FMath::CountBits(Word & (Bit - 1)));
+	}
+
+	FORCEINLINE const FIntPoint& GetAxial(const int32 TileIndex) const
+	{
+		return IndexToAxial[TileIndex];
+	}
+
+	/**
+	 * 格子所在的页， 页的编号与Index顺序相同， 不在地图中返回INDEX_NONE
+	 */
+	int32 GetTilePage(const int32 Q, const int32 R) const
+	{
+		const int32 PageIndex = FindPage(Q, R);
+		if (PageIndex == INDEX_NONE)
+		{
+			return INDEX_NONE;
+		}
+
+		const int32 Slot = GetSlot(Q, R);
+		return (Pages[PageIndex].Bits[Slot >> 6] & (1ull << (Slot & 63))) != 0 ? PageIndex : INDEX_NONE;
+	}
+
+	/**
+	 * 页内的所有格子， 按Index顺序追加到OutAxialCoords
+	 */
+	void GetPageTiles(int32 PageIndex, TArray<FIntPoint>& OutAxialCoords) const;
+
+	SIZE_T GetAllocatedSize() const;
+
+private:
+	struct FPage
+	{
+		// [LocalQ * PageSize + LocalR] 是否有格子
+		uint64 Bits[PageWords];
+		// 页内第一个格子的Index
+		int32 FirstIndex;
+		// 前面各个Word中的格子数量
+		uint16 WordPrefix[PageWords];
+		// 页内Slot 0 的(Q, R)
+		FIntPoint Origin;
+	};
+
+	FORCEINLINE int32 FindPage(const int32 Q, const int32 R) const
+	{
+		// 算术右移即向下取整， 负坐标同样适用
+		const int32 PageQ = (Q >> PageShift) - PageOrigin.X;
+		const int32 PageR = (R >> PageShift) - PageOrigin.Y;
+		if (static_cast<uint32>(PageQ) >= static_cast<uint32>(PageTableSize.X) ||
+			static_cast<uint32>(PageR) >= static_cast<uint32>(PageTableSize.Y))
+		{
+			return INDEX_NONE;
+		}
+
+		return PageTable[PageQ * PageTableSize.Y + PageR];
+	}
+
+	static FORCEINLINE int32 GetSlot(const int32 Q, const int32 R)
+	{
+		return ((Q & PageMask) << PageShift) | (R & PageMask);
+	}
+
+	// 页表中第一个页的页坐标
+	FIntPoint PageOrigin = FIntPoint::ZeroValue;
+	FIntPoint PageTableSize = FIntPoint::ZeroValue;
+
+	// [PageQ * PageTableSize.Y + PageR] 在Pages中的下标， 没有格子的页为INDEX_NONE
+	TArray<int32> PageTable;
+
+	TArray<FPage> Pages;
+
+	// [TileIndex] 格子的(Q, R)
+	TArray<FIntPoint> IndexToAxial;
+};
@@ -0,0 +1,93 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "GraphAStar.h"
+#include "PathFinding/GridFifoCache.h"
+#include "PathFinding/GridPathRequest.h"
+
+struct FGridPathCacheKey
+{
+	FGridPathCacheKey()
+	{
+	}
+
+	FGridPathCacheKey(int32 InStartIndex, int32 InEndIndex, int32 InIdentifier,
+	                  EGridPathSearchMode InSearchMode = EGridPathSearchMode::AStar)
+		: StartIndex(InStartIndex), EndIndex(InEndIndex), Identifier(InIdentifier), SearchMode(InSearchMode)
+	{
+	}
+
+	int32 StartIndex = INDEX_NONE;
+	int32 EndIndex = INDEX_NONE;
+	int32 Identifier = INDEX_NONE;
+	// 不同搜索方式得到的路径Cost相同， 但路径本身与部分路径可能不同
+	EGridPathSearchMode SearchMode = EGridPathSearchMode::AStar;
+
+	friend bool operator==(const FGridPathCacheKey& A, const FGridPathCacheKey& B)
+	{
+		return A.StartIndex == B.StartIndex && A.EndIndex == B.EndIndex && A.Identifier == B.Identifier && A.SearchMode == B.SearchMode;
+	}
+
+	friend uint32 GetTypeHash(const FGridPathCacheKey& Key)
+	{
+		return HashCombine(HashCombine(HashCombine(::GetTypeHash(Key.StartIndex), ::GetTypeHash(Key.EndIndex)), ::GetTypeHash(Key.Identifier)),
+		                   ::GetTypeHash(static_cast<uint8>(Key.SearchMode)));
+	}
+};
+
+/**
+ * 寻路结果缓存, Key为(StartIndex, EndIndex, Identifier, SearchMode)
+ * 缓存的结果只在地图的TopologyVersion不变时有效， 版本变化后第一次访问时丢弃全部旧结果
+ * 数量达到上限后按加入顺序淘汰最早的结果
+ * 可在多个线程中同时访问
+ */
+class GRIDPATHFINDING_API FGridPathCache
+{
+public:
+	/**
+	 * 查找缓存， 命中时返回true
+	 * @param CurrentVersion 地图当前的TopologyVersion
+	 */
+	bool Find(const FGridPathCacheKey& Key, uint32 CurrentVersion, EGraphAStarResult& OutResult, TArray<int32>& OutPathIndices, float& OutPathCost);
+
+	void Add(const FGridPathCacheKey& Key, uint32 CurrentVersion, EGraphAStarResult InResult, const TArray<int32>& InPathIndices, float InPathCost);
+
+	/**
+	 * 清空缓存和命中计数
+	 */
+	void Reset();
+
+	/**
+	 * 0表示关闭缓存， 改变上限会清空已缓存的结果
+	 */
+	void SetMaxEntries(int32 InMaxEntries);
+
+	bool IsEnabled() const { return MaxEntries > 0; }
+
+	int64 GetHitCount() const { return HitCount; }
+	int64 GetMissCount() const { return MissCount; }
+	int32 GetNumEntries() const;
+
+private:
+	struct FEntry
+	{
+		EGraphAStarResult Result = SearchFail;
+		TArray<int32> PathIndices;
+		float PathCost = 0.f;
+	};
+
+	// 调用前需要持有Lock
+	void DropStaleEntries(uint32 CurrentVersion);
+
+	TGridFifoCache<FGridPathCacheKey, FEntry> Entries;
+
+	// Entries中所有结果对应的TopologyVersion
+	uint32 EntriesVersion = 0;
+
+	int32 MaxEntries = 0;
+
+	int64 HitCount = 0;
+	int64 MissCount = 0;
+
+	mutable FCriticalSection Lock;
+};
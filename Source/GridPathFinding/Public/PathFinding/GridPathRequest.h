@@ -0,0 +1,56 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "GraphAStar.h"
+
+#include "GridPathRequest.generated.h"
+
+// 单次寻路使用的搜索方式
+UENUM(BlueprintType)
+enum class EGridPathSearchMode : uint8
+{
+	// 使用NavMesh上配置的默认方式
+	Default UMETA(DisplayName = "默认"),
+	AStar UMETA(DisplayName = "A*"),
+	// 从两端同时搜索， 终点不可达时更快结束
+	Bidirectional UMETA(DisplayName = "双向A*"),
+};
+
+/**
+ * 不经过NavMesh的寻路没有默认方式可用， Default按AStar处理
+ * Filter和FGridPathCacheKey都应使用转换后的值， 否则同一请求会占用两个缓存Key
+ */
+inline EGridPathSearchMode ResolveGridPathSearchMode(EGridPathSearchMode SearchMode)
+{
+	return SearchMode == EGridPathSearchMode::Default ? EGridPathSearchMode::AStar : SearchMode;
+}
+
+/**
+ * 不经过NavigationSystem的寻路请求， 输入输出都使用格子Index(StableGetFullMapGridIterIndex)
+ * 用于 UGridMapModel::FindPathsBatch 等批量接口
+ */
+struct FGridPathRequest
+{
+	FGridPathRequest()
+	{
+	}
+
+	FGridPathRequest(int32 InStartIndex, int32 InEndIndex, int32 InIdentifier = INDEX_NONE,
+	                 EGridPathSearchMode InSearchMode = EGridPathSearchMode::Default)
+		: StartIndex(InStartIndex), EndIndex(InEndIndex), Identifier(InIdentifier), SearchMode(InSearchMode)
+	{
+	}
+
+	// ---- 输入 ----
+	int32 StartIndex = INDEX_NONE;
+	int32 EndIndex = INDEX_NONE;
+	// IGridPathFindingIdentifier::GetGridPathFindingIdentifier
+	int32 Identifier = INDEX_NONE;
+	EGridPathSearchMode SearchMode = EGridPathSearchMode::Default;
+
+	// ---- 输出 ----
+	EGraphAStarResult Result = SearchFail;
+	// 不包含起点， 包含终点
+	TArray<int32> PathIndices;
+	float PathCost = 0.f;
+};
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GraphAStar.h"
+
+// 为0时不编译任何统计代码； 默认Shipping之外的配置编译， 运行时仍需通过 GridPathFinding.Telemetry 1 开启
+#ifndef GRID_PATH_TELEMETRY
+#define GRID_PATH_TELEMETRY !UE_BUILD_SHIPPING
+#endif
+
+/**
+ * 单次 UGridMapModel::SearchPathIndices 的统计数据
+ */
+struct FGridPathQueryStats
+{
+	int32 Identifier = INDEX_NONE;
+	EGraphAStarResult Result = SearchFail;
+	int32 NumExpandedNodes = 0;
+	// Open列表(双向搜索为两侧之和)的最大长度
+	int32 PeakOpenNodes = 0;
+	// 连通区域检查直接判定不可达
+	bool bRejectedByConnectivity = false;
+	// 由分层寻路给出结果
+	bool bHierarchical = false;
+	double Microseconds = 0.0;
+};
+
+/**
+ * 寻路统计， 按身份标识(IGridPathFindingIdentifier)汇总查询次数、结果、展开节点数和耗时分布
+ *
+ * 控制台命令(只在GRID_PATH_TELEMETRY为1时注册):
+ *  GridPathFinding.Telemetry 0/1		开关， 默认关闭， 关闭时每次查询只多一次bool判断
+ *  GridPathFinding.Telemetry.Dump		输出到控制台/日志
+ *  GridPathFinding.Telemetry.Reset		清空
+ *  GridPathFinding.Telemetry.ExportCsv [FilePath]	导出CSV， 默认写到Saved/Profiling/GridPathFinding/
+ *
+ * 可在多个线程中同时记录
+ */
+class GRIDPATHFINDING_API FGridPathTelemetry
+{
+public:
+	// 耗时分布: 第0个桶为1微秒以内， 第i个桶为[2^(i-1), 2^i)微秒， 最后一个桶不设上限
+	static constexpr int32 NumLatencyBuckets = 16;
+
+	static bool IsEnabled();
+
+	static void RecordQuery(const FGridPathQueryStats& Stats);
+
+	static void Reset();
+
+	static void Dump(FOutputDevice& Ar);
+
+	/**
+	 * @return 写入失败时返回false
+	 */
+	static bool ExportCsv(const FString& FilePath);
+
+	static int32 GetLatencyBucket(double Microseconds);
+};
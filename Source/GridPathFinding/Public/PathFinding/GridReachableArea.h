@@ -0,0 +1,72 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * 移动范围查询的结果： 从起点出发， 总Cost不超过MaxCost能到达的所有格子
+ * 用于战棋的移动范围显示与AI的落点选择， 一次搜索代替逐个格子的FindPath
+ */
+struct GRIDPATHFINDING_API FGridReachableArea
+{
+	int32 StartIndex = INDEX_NONE;
+
+	// IGridPathFindingIdentifier::GetGridPathFindingIdentifier
+	int32 Identifier = INDEX_NONE;
+
+	float MaxCost = 0.f;
+
+	// 按Cost从小到大排列， 第一个是起点
+	TArray<int32> TileIndices;
+
+	// 与TileIndices一一对应
+	TArray<float> Costs;
+
+	// 与TileIndices一一对应， 最短路径上的前一个格子， 起点为INDEX_NONE
+	TArray<int32> PredecessorIndices;
+
+	// TileIndex -> TileIndices中的下标
+	TMap<int32, int32> EntryIndices;
+
+	int32 Num() const
+	{
+		return TileIndices.Num();
+	}
+
+	bool Contains(int32 TileIndex) const
+	{
+		return EntryIndices.Contains(TileIndex);
+	}
+
+	/**
+	 * 不可达时返回MAX_flt
+	 */
+	float GetCost(int32 TileIndex) const
+	{
+		const int32* EntryIndex = EntryIndices.Find(TileIndex);
+		return EntryIndex ? Costs[*EntryIndex] : MAX_flt;
+	}
+
+	/**
+	 * 通过PredecessorIndices还原路径
+	 * @param OutPath 不包含起点， 包含终点
+	 * @return 不可达时返回false
+	 */
+	bool GetPathTo(int32 TileIndex, TArray<int32>& OutPath) const;
+
+	void Reset()
+	{
+		StartIndex = INDEX_NONE;
+		TileIndices.Reset();
+		Costs.Reset();
+		PredecessorIndices.Reset();
+		EntryIndices.Reset();
+	}
+
+	void Add(int32 TileIndex, float Cost, int32 PredecessorIndex)
+	{
+		EntryIndices.Add(TileIndex, TileIndices.Num());
+		TileIndices.Add(TileIndex);
+		Costs.Add(Cost);
+		PredecessorIndices.Add(PredecessorIndex);
+	}
+};
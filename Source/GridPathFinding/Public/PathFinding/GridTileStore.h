@@ -0,0 +1,80 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Types/TileInfo.h"
+
+/**
+ * 按格子Index排列的列式格子数据， 寻路只读取其中的阻挡位、Cost与高度， 不再访问完整的FTileInfo
+ *  - BlockCounts / BlockedBits: 阻挡计数与打包的阻挡位， 计数大于0时阻挡位为1
+ *  - Costs / Heights: 与FTileInfo::Cost、FTileInfo::Height相同
+ *  - 自定义数据很少使用， 只为设置过的格子保存一份
+ *
+ * UGridMapModel::Tiles 仍作为FTileInfo的兼容视图保留， 两者由UGridMapModel的修改接口同步更新
+ */
+class GRIDPATHFINDING_API FGridTileStore
+{
+public:
+	/**
+	 * 从构建完成的格子数据初始化， FTileInfo::CustomDataMap会被移动到CustomData中
+	 */
+	void Initialize(TArray<FTileInfo>& InOutTiles);
+
+	void Reset();
+
+	FORCEINLINE int32 Num() const { return Costs.Num(); }
+
+	FORCEINLINE bool IsValidIndex(int32 TileIndex) const { return Costs.IsValidIndex(TileIndex); }
+
+	/**
+	 * 无效的Index视为不阻挡， 与 UGridMapModel::CanTravelTo 一致
+	 */
+	FORCEINLINE bool IsBlocked(int32 TileIndex) const
+	{
+		return BlockedBits.IsValidIndex(TileIndex) && BlockedBits[TileIndex];
+	}
+
+	FORCEINLINE int32 GetBlockCount(int32 TileIndex) const { return BlockCounts[TileIndex]; }
+
+	FORCEINLINE float GetCost(int32 TileIndex) const { return Costs[TileIndex]; }
+
+	FORCEINLINE float GetHeight(int32 TileIndex) const { return Heights[TileIndex]; }
+
+	const TBitArray<>& GetBlockedBits() const { return BlockedBits; }
+
+	void AddBlock(int32 TileIndex)
+	{
+		BlockedBits[TileIndex] = ++BlockCounts[TileIndex] > 0;
+	}
+
+	void RemoveBlock(int32 TileIndex)
+	{
+		if (BlockCounts[TileIndex] > 0)
+		{
+			--BlockCounts[TileIndex];
+		}
+		BlockedBits[TileIndex] = BlockCounts[TileIndex] > 0;
+	}
+
+	void SetHeight(int32 TileIndex, float InHeight) { Heights[TileIndex] = InHeight; }
+
+	/**
+	 * 没有自定义数据时返回nullptr
+	 */
+	const TMap<FName, FString>* FindCustomData(int32 TileIndex) const { return CustomData.Find(TileIndex); }
+
+	TMap<FName, FString>& FindOrAddCustomData(int32 TileIndex) { return CustomData.FindOrAdd(TileIndex); }
+
+	/**
+	 * 用列数据填充一份完整的FTileInfo， 供兼容接口使用
+	 */
+	void FillTileInfo(int32 TileIndex, FTileInfo& InOutTileInfo) const;
+
+private:
+	TArray<int32> BlockCounts;
+	TBitArray<> BlockedBits;
+	TArray<float> Costs;
+	TArray<float> Heights;
+
+	// Key为格子Index
+	TMap<int32, TMap<FName, FString>> CustomData;
+};
@@ -0,0 +1,258 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PathFinding/GridPagedTileIndex.h"
+#include "Types/MapConfig.h"
+
+/**
+ * 寻路内核使用的地图拓扑， 由 UGridMapModel::GetPathTopology 根据MapType、TileOrientation、DrawMode得到
+ * 每次查询只判断一次， 之后进入对应拓扑策略的模板实例(TGridPathFilter)， 展开格子时不再有分支
+ */
+enum class EGridPathTopology : uint8
+{
+	// 运行时判断的通用实现(FGridPathFilter)
+	Generic,
+	// HEX_STANDARD 与 RECTANGLE_SIX_DIRECTION 的格子Index与邻居规则相同， 只区分朝向
+	HexFlat,
+	HexPointy,
+	// BaseOnRadius 的六边形地图， 与朝向无关
+	HexRadius,
+	// BaseOnVolume 的六边形地图， Index由 FGridPagedTileIndex 分配
+	HexVolume,
+};
+
+/**
+ * 拓扑策略共用的地图尺寸， 与 FGridMapConfig::MapSize 相同: X为行数， Y为列数
+ * MapRadius 与 FGridMapConfig::MapRadius 相同， 只有HexRadius拓扑使用
+ * PagedTileIndex 由 UGridMapModel 设置， 只有HexVolume拓扑使用
+ * RadiusIndexToAxial 由 UGridMapModel 设置， 只有HexRadius拓扑使用
+ */
+struct FGridTopologyParams
+{
+	int32 MapRows = 0;
+	int32 MapColumns = 0;
+	int32 MapRowsHalf = 0;
+	int32 MapColumnsHalf = 0;
+	int32 MapRadius = 0;
+	const FGridPagedTileIndex* PagedTileIndex = nullptr;
+	const TArray<FIntPoint>* RadiusIndexToAxial = nullptr;
+
+	void Initialize(const FGridMapConfig& InMapConfig)
+	{
+		MapRows = InMapConfig.MapSize.X;
+		MapColumns = InMapConfig.MapSize.Y;
+		MapRowsHalf = MapRows / 2;
+		MapColumnsHalf = MapColumns / 2;
+		MapRadius = InMapConfig.MapRadius;
+	}
+};
+
+/**
+ * 六边形邻居的Q、R偏移， 与 FSixDirections 的顺序相同
+ */
+struct FGridHexDirections
+{
+	static constexpr int32 DeltaQ[] = {0, 1, 1, 0, -1, -1};
+	static constexpr int32 DeltaR[] = {-1, -1, 0, 1, 1, 0};
+
+	// 偏移坐标中 (Value - (Value & 1)) / 2， 与 UGridMapModel::StableGetFullMapGridIterIndex 相同
+	static FORCEINLINE int32 FloorHalf(const int32 Value)
+	{
+		return (Value - (Value & 1)) / 2;
+	}
+};
+
+/**
+ * 平顶六边形， 列优先遍历
+ * bUseNeighborCache 为true时邻居优先从 UGridMapModel::GetNeighborTable 读取， 地图没有邻居表时由GetNeighbour计算
+ */
+struct FGridHexFlatTopology
+{
+	static constexpr int32 NeighbourCount = 6;
+	static constexpr bool bUseNeighborCache = true;
+
+	/**
+	 * 由行列奇偶性计算邻居， 结果与邻居表相同
+	 */
+	static FORCEINLINE int32 GetNeighbour(const int32 NodeIndex, const int32 Direction, const FGridTopologyParams& Params)
+	{
+		const int32 Column = NodeIndex / Params.MapRows - Params.MapColumnsHalf;
+		const int32 Row = NodeIndex % Params.MapRows - Params.MapRowsHalf;
+
+		const int32 NewColumn = Column + FGridHexDirections::DeltaQ[Direction];
+		const int32 NewRow = Row + FGridHexDirections::DeltaR[Direction] + FGridHexDirections::FloorHalf(NewColumn) - FGridHexDirections::FloorHalf(Column);
+
+		const int32 DeltaColumn = NewColumn + Params.MapColumnsHalf;
+		const int32 DeltaRow = NewRow + Params.MapRowsHalf;
+		if (DeltaColumn < 0 || DeltaColumn >= Params.MapColumns || DeltaRow < 0 || DeltaRow >= Params.MapRows)
+		{
+			return INDEX_NONE;
+		}
+
+		return DeltaColumn * Params.MapRows + DeltaRow;
+	}
+
+	static FORCEINLINE int32 GetDistance(const int32 A, const int32 B, const FGridTopologyParams& Params)
+	{
+		if (A == B) return 0;
+
+		// 先减去一半的行列数再按列的奇偶换算， 与 StableGetFullMapGridIterIndex 相同， 一半的列数为奇数时奇偶会不同
+		const int32 QA = A / Params.MapRows - Params.MapColumnsHalf;
+		const int32 RA = A % Params.MapRows - Params.MapRowsHalf - FGridHexDirections::FloorHalf(QA);
+
+		const int32 QB = B / Params.MapRows - Params.MapColumnsHalf;
+		const int32 RB = B % Params.MapRows - Params.MapRowsHalf - FGridHexDirections::FloorHalf(QB);
+
+		return (FMath::Abs(QA - QB) + FMath::Abs(QA + RA - QB - RB) + FMath::Abs(RA - RB)) / 2;
+	}
+};
+
+/**
+ * 尖顶六边形， 行优先遍历
+ */
+struct FGridHexPointyTopology
+{
+	static constexpr int32 NeighbourCount = 6;
+	static constexpr bool bUseNeighborCache = true;
+
+	static FORCEINLINE int32 GetNeighbour(const int32 NodeIndex, const int32 Direction, const FGridTopologyParams& Params)
+	{
+		const int32 Row = NodeIndex / Params.MapColumns - Params.MapRowsHalf;
+		const int32 Column = NodeIndex % Params.MapColumns - Params.MapColumnsHalf;
+
+		const int32 NewRow = Row + FGridHexDirections::DeltaR[Direction];
+		const int32 NewColumn = Column + FGridHexDirections::DeltaQ[Direction] + FGridHexDirections::FloorHalf(NewRow) - FGridHexDirections::FloorHalf(Row);
+
+		const int32 DeltaRow = NewRow + Params.MapRowsHalf;
+		const int32 DeltaColumn = NewColumn + Params.MapColumnsHalf;
+		if (DeltaRow < 0 || DeltaRow >= Params.MapRows || DeltaColumn < 0 || DeltaColumn >= Params.MapColumns)
+		{
+			return INDEX_NONE;
+		}
+
+		return DeltaRow * Params.MapColumns + DeltaColumn;
+	}
+
+	static FORCEINLINE int32 GetDistance(const int32 A, const int32 B, const FGridTopologyParams& Params)
+	{
+		if (A == B) return 0;
+
+		// 与平顶相同， 按减去一半行数之后的行号取奇偶
+		const int32 RA = A / Params.MapColumns - Params.MapRowsHalf;
+		const int32 QA = A % Params.MapColumns - Params.MapColumnsHalf - FGridHexDirections::FloorHalf(RA);
+
+		const int32 RB = B / Params.MapColumns - Params.MapRowsHalf;
+		const int32 QB = B % Params.MapColumns - Params.MapColumnsHalf - FGridHexDirections::FloorHalf(RB);
+
+		return (FMath::Abs(QA - QB) + FMath::Abs(QA + RA - QB - RB) + FMath::Abs(RA - RB)) / 2;
+	}
+};
+
+/**
+ * 半径地图， 与 AHexGrid::GetHexTileIndex 的顺序相同: 按Q从-Radius到Radius逐列遍历， 列内按R递增
+ * 只占用 3 * Radius * (Radius + 1) + 1 个Index， 不浪费外接矩形的角落
+ */
+struct FGridHexRadiusTopology
+{
+	static constexpr int32 NeighbourCount = 6;
+	static constexpr bool bUseNeighborCache = true;
+
+	static FORCEINLINE int32 GetTileCount(const int32 Radius)
+	{
+		return 3 * Radius * (Radius + 1) + 1;
+	}
+
+	/**
+	 * 前DeltaQ列(DeltaQ = Q + Radius)的格子数量， 各列格子数是先增后减的等差数列
+	 */
+	static FORCEINLINE int32 GetPassedCount(const int32 DeltaQ, const int32 Radius)
+	{
+		if (DeltaQ <= Radius + 1)
+		{
+			return (2 * Radius + 1 + DeltaQ) * DeltaQ / 2;
+		}
+
+		return (3 * Radius + 2) * (Radius + 1) / 2 + (5 * Radius - DeltaQ + 2) * (DeltaQ - Radius - 1) / 2;
+	}
+
+	static FORCEINLINE int32 GetIndex(const int32 Q, const int32 R, const int32 Radius)
+	{
+		if (FMath::Abs(Q) > Radius || FMath::Abs(R) > Radius || FMath::Abs(Q + R) > Radius)
+		{
+			return INDEX_NONE;
+		}
+
+		return GetPassedCount(Q + Radius, Radius) + R - FMath::Max(-Radius, -Q - Radius);
+	}
+
+	/**
+	 * 需要开平方， 寻路时通过 FGridTopologyParams::RadiusIndexToAxial 查表
+	 */
+	static FORCEINLINE void GetCoord(const int32 Index, const int32 Radius, int32& OutQ, int32& OutR)
+	{
+		// 地图关于中心对称， Index(-Q, -R) = TileCount - 1 - Index(Q, R)， 只需要在前Radius + 1列中求解
+		const int32 MirrorIndex = GetTileCount(Radius) - 1 - Index;
+		const bool bMirror = MirrorIndex < Index;
+		const int32 HalfIndex = bMirror ? MirrorIndex : Index;
+
+		// 解 (2 * Radius + 1 + DeltaQ) * DeltaQ / 2 <= HalfIndex， 再修正浮点误差
+		const int32 B = 2 * Radius + 1;
+		int32 DeltaQ = FMath::FloorToInt32((FMath::Sqrt(static_cast<double>(B) * B + 8.0 * HalfIndex) - B) * 0.5);
+		while (DeltaQ > 0 && GetPassedCount(DeltaQ, Radius) > HalfIndex)
+		{
+			--DeltaQ;
+		}
+		while (GetPassedCount(DeltaQ + 1, Radius) <= HalfIndex)
+		{
+			++DeltaQ;
+		}
+
+		const int32 Q = DeltaQ - Radius;
+		const int32 R = HalfIndex - GetPassedCount(DeltaQ, Radius) + FMath::Max(-Radius, -Q - Radius);
+		OutQ = bMirror ? -Q : Q;
+		OutR = bMirror ? -R : R;
+	}
+
+	static FORCEINLINE int32 GetDistance(const int32 A, const int32 B, const FGridTopologyParams& Params)
+	{
+		if (A == B) return 0;
+
+		const FIntPoint& AxialA = (*Params.RadiusIndexToAxial)[A];
+		const FIntPoint& AxialB = (*Params.RadiusIndexToAxial)[B];
+		const int32 DeltaQ = AxialA.X - AxialB.X;
+		const int32 DeltaR = AxialA.Y - AxialB.Y;
+		return (FMath::Abs(DeltaQ) + FMath::Abs(DeltaQ + DeltaR) + FMath::Abs(DeltaR)) / 2;
+	}
+
+	static FORCEINLINE int32 GetNeighbour(const int32 NodeIndex, const int32 Direction, const FGridTopologyParams& Params)
+	{
+		const FIntPoint& Axial = (*Params.RadiusIndexToAxial)[NodeIndex];
+		return GetIndex(Axial.X + FGridHexDirections::DeltaQ[Direction], Axial.Y + FGridHexDirections::DeltaR[Direction], Params.MapRadius);
+	}
+};
+
+/**
+ * 框选地图， 格子只存在于PlaceVolumes覆盖的页中， 邻居可能落在相邻的页里或不存在
+ */
+struct FGridHexVolumeTopology
+{
+	static constexpr int32 NeighbourCount = 6;
+	static constexpr bool bUseNeighborCache = true;
+
+	static FORCEINLINE int32 GetDistance(const int32 A, const int32 B, const FGridTopologyParams& Params)
+	{
+		if (A == B) return 0;
+
+		const FIntPoint& AxialA = Params.PagedTileIndex->GetAxial(A);
+		const FIntPoint& AxialB = Params.PagedTileIndex->GetAxial(B);
+		const int32 DeltaQ = AxialA.X - AxialB.X;
+		const int32 DeltaR = AxialA.Y - AxialB.Y;
+		return (FMath::Abs(DeltaQ) + FMath::Abs(DeltaQ + DeltaR) + FMath::Abs(DeltaR)) / 2;
+	}
+
+	static FORCEINLINE int32 GetNeighbour(const int32 NodeIndex, const int32 Direction, const FGridTopologyParams& Params)
+	{
+		const FIntPoint& Axial = Params.PagedTileIndex->GetAxial(NodeIndex);
+		return Params.PagedTileIndex->GetIndex(Axial.X + FGridHexDirections::DeltaQ[Direction], Axial.Y + FGridHexDirections::DeltaR[Direction]);
+	}
+};
@@ -69,6 +69,10 @@ public:
 		return FString();
 	}
 
+	// 是否阻挡所在格子的视线， 运行时修改后需要调用 UGridMapModel::MarkTileSightDirty
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Gameplay")
+	bool bBlocksSight = false;
+
 	// ====== 交互 功能 插件中并未调用， 由项目自行决定调用时机 =======
 	UFUNCTION(BlueprintImplementableEvent)
 	void OnFocus();
@@ -0,0 +1,184 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Types/HCubeCoord.h"
+
+/**
+ * 以格子Index为下标的稠密容器， 用于替代以FHCubeCoord为Key的TMap
+ * Index由 UGridMapModel::GetDenseTileIndex 得到， 为INDEX_NONE的坐标(地图外， 或当前绘制模式不支持Index)
+ * 退化为以坐标为Key的TMap
+ *
+ * 所有接口同时接收Index和Coord， 调用方负责保证两者对应同一个格子
+ * 地图配置变化导致Index映射改变时， 需要调用Rebuild重新分配
+ */
+template <typename ValueType>
+class TGridTileMap
+{
+public:
+	FORCEINLINE int32 Num() const
+	{
+		return DenseNum + SparseValues.Num();
+	}
+
+	void Reset()
+	{
+		DenseValues.Reset();
+		DenseCoords.Reset();
+		DenseOccupied.Reset();
+		DenseNum = 0;
+		SparseValues.Reset();
+	}
+
+	/**
+	 * 预先分配Index在[0, InDenseCount)之间的空间
+	 */
+	void Reserve(int32 InDenseCount)
+	{
+		if (InDenseCount > DenseValues.Num())
+		{
+			DenseOccupied.Add(false, InDenseCount - DenseValues.Num());
+			DenseValues.SetNum(InDenseCount);
+			DenseCoords.SetNum(InDenseCount);
+		}
+	}
+
+	FORCEINLINE bool Contains(int32 Index, const FHCubeCoord& Coord) const
+	{
+		return Index == INDEX_NONE ? SparseValues.Contains(Coord) : IsDenseOccupied(Index);
+	}
+
+	FORCEINLINE ValueType* Find(int32 Index, const FHCubeCoord& Coord)
+	{
+		if (Index == INDEX_NONE)
+		{
+			return SparseValues.Find(Coord);
+		}
+
+		return IsDenseOccupied(Index) ? &DenseValues[Index] : nullptr;
+	}
+
+	FORCEINLINE const ValueType* Find(int32 Index, const FHCubeCoord& Coord) const
+	{
+		return const_cast<TGridTileMap*>(this)->Find(Index, Coord);
+	}
+
+	/**
+	 * 已存在时覆盖， 与TMap::Add一致
+	 */
+	ValueType& Add(int32 Index, const FHCubeCoord& Coord, ValueType InValue)
+	{
+		ValueType& Value = FindOrAdd(Index, Coord);
+		Value = MoveTemp(InValue);
+		return Value;
+	}
+
+	ValueType& FindOrAdd(int32 Index, const FHCubeCoord& Coord)
+	{
+		if (Index == INDEX_NONE)
+		{
+			return SparseValues.FindOrAdd(Coord);
+		}
+
+		check(Index >= 0);
+		Reserve(Index + 1);
+		if (!DenseOccupied[Index])
+		{
+			DenseOccupied[Index] = true;
+			DenseCoords[Index] = Coord;
+			DenseValues[Index] = ValueType();
+			++DenseNum;
+		}
+
+		return DenseValues[Index];
+	}
+
+	bool Remove(int32 Index, const FHCubeCoord& Coord)
+	{
+		if (Index == INDEX_NONE)
+		{
+			return SparseValues.Remove(Coord) > 0;
+		}
+
+		if (!IsDenseOccupied(Index))
+		{
+			return false;
+		}
+
+		DenseOccupied[Index] = false;
+		// 释放Value持有的内存
+		DenseValues[Index] = ValueType();
+		--DenseNum;
+		return true;
+	}
+
+	/**
+	 * 依次对每个元素调用 Func(const FHCubeCoord& Coord, ValueType& Value)， 稠密部分按Index顺序
+	 */
+	template <typename FuncType>
+	void ForEach(FuncType Func)
+	{
+		for (TConstSetBitIterator<> It(DenseOccupied); It; ++It)
+		{
+			Func(DenseCoords[It.GetIndex()], DenseValues[It.GetIndex()]);
+		}
+
+		for (auto& Pair : SparseValues)
+		{
+			Func(Pair.Key, Pair.Value);
+		}
+	}
+
+	template <typename FuncType>
+	void ForEach(FuncType Func) const
+	{
+		for (TConstSetBitIterator<> It(DenseOccupied); It; ++It)
+		{
+			Func(DenseCoords[It.GetIndex()], static_cast<const ValueType&>(DenseValues[It.GetIndex()]));
+		}
+
+		for (const auto& Pair : SparseValues)
+		{
+			Func(Pair.Key, Pair.Value);
+		}
+	}
+
+	/**
+	 * Index映射改变后(地图配置变化)， 按新的映射重新放置所有元素
+	 */
+	void Rebuild(TFunctionRef<int32(const FHCubeCoord&)> GetIndex)
+	{
+		if (Num() == 0)
+		{
+			Reset();
+			return;
+		}
+
+		TArray<TPair<FHCubeCoord, ValueType>> Entries;
+		Entries.Reserve(Num());
+		ForEach([&Entries](const FHCubeCoord& Coord, ValueType& Value)
+		{
+			Entries.Emplace(Coord, MoveTemp(Value));
+		});
+
+		Reset();
+		for (auto& Entry : Entries)
+		{
+			Add(GetIndex(Entry.Key), Entry.Key, MoveTemp(Entry.Value));
+		}
+	}
+
+private:
+	FORCEINLINE bool IsDenseOccupied(int32 Index) const
+	{
+		return Index >= 0 && Index < DenseOccupied.Num() && DenseOccupied[Index];
+	}
+
+	// [Index], 只有DenseOccupied为true的位置有效
+	TArray<ValueType> DenseValues;
+	TArray<FHCubeCoord> DenseCoords;
+	TBitArray<> DenseOccupied;
+	int32 DenseNum = 0;
+
+	// Index为INDEX_NONE的坐标
+	TMap<FHCubeCoord, ValueType> SparseValues;
+};
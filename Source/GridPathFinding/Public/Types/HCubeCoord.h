@@ -58,10 +58,10 @@ struct GRIDPATHFINDING_API FHCubeCoord
 		return lhs.QRS != rhs.QRS;
 	}
 
+	// 立方坐标满足q + r + s == 0， 只需要对q, r求Hash
 	friend uint32 GetTypeHash(const FHCubeCoord &Other)
 	{
-		FString TypeHash{ Other.QRS.ToString() };
-		return GetTypeHash(TypeHash);
+		return HashCombine(::GetTypeHash(Other.QRS.X), ::GetTypeHash(Other.QRS.Y));
 	}
 
 	FString ToString() const
@@ -35,6 +35,7 @@ public:
 	float Cost = 1.f;
 	
 	// ---- 项目自定义数据 ----
+	// 地图构建完成后移动到 FGridTileStore 中保存， 只在 UGridMapModel::TryGetTileInfo 返回的副本中填充
 	UPROPERTY()
 	TMap<FName, FString> CustomDataMap;
 	
@@ -67,4 +68,9 @@ public:
 	{
 		return BlockCount > 0;
 	}
+
+	int32 GetBlockCount() const
+	{
+		return BlockCount;
+	}
 };
@@ -21,6 +21,7 @@ public class GridPathFindingTest : ModuleRules
                 "Slate",
                 "SlateCore",
                 "GridPathFinding",
+                "Json",
             }
         );
     }
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GridMapModel.h"
+
+#include "GridBenchmarkMapModel.generated.h"
+
+/**
+ * 寻路测试与基准使用的地图， 阻挡和Cost由测试直接写入， 不依赖环境类型资源与World
+ */
+UCLASS()
+class UGridBenchmarkMapModel : public UGridMapModel
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	 * 在BuildBlankTilesData之前调用， 按格子Index随机生成阻挡与额外Cost
+	 * @param ObstacleDensity 0-1， 被阻挡格子的比例
+	 * @param CostVariance 每个格子额外Cost的上限， 0表示所有边Cost都为1
+	 */
+	void GenerateTerrain(int32 NodeCount, float ObstacleDensity, float CostVariance, int32 Seed)
+	{
+		FRandomStream RandomStream(Seed);
+		BlockedTiles.Init(false, NodeCount);
+		ExtraCosts.SetNumZeroed(NodeCount);
+		for (int32 TileIndex = 0; TileIndex < NodeCount; ++TileIndex)
+		{
+			BlockedTiles[TileIndex] = RandomStream.GetFraction() < ObstacleDensity;
+			ExtraCosts[TileIndex] = CostVariance > 0.f ? RandomStream.FRandRange(0.f, CostVariance) : 0.f;
+		}
+	}
+
+	bool IsTileBlocked(int32 TileIndex) const
+	{
+		return BlockedTiles.IsValidIndex(TileIndex) && BlockedTiles[TileIndex];
+	}
+
+	virtual bool CanTravelTo(int32 FromIndex, int32 ToIndex) override
+	{
+		return !IsTileBlocked(ToIndex) && Super::CanTravelTo(FromIndex, ToIndex);
+	}
+
+	virtual double GetTraversalCost(int Identifier, int32 FromIndex, int32 ToIndex) override
+	{
+		return ExtraCosts.IsValidIndex(ToIndex) ? 1.0 + ExtraCosts[ToIndex] : 1.0;
+	}
+
+	// 路径点高度直接使用格子高度
+	virtual float GetTileHeightOffset(const FHCubeCoord& InCoord) override
+	{
+		return GetTileHeight(InCoord);
+	}
+
+	// 阻挡的格子同时阻挡视线
+	virtual bool IsTileBlockingSight(int32 TileIndex) override
+	{
+		return IsTileBlocked(TileIndex) || Super::IsTileBlockingSight(TileIndex);
+	}
+
+	// 阻挡与Cost在BuildBlankTilesData之前生成， 之后只读
+	virtual bool SupportsParallelPathQueries() const override
+	{
+		return true;
+	}
+
+private:
+	TBitArray<> BlockedTiles;
+	TArray<float> ExtraCosts;
+};
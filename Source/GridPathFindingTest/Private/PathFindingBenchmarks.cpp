@@ -0,0 +1,390 @@
+#include "GridBenchmarkMapModel.h"
+#include "GridPathFindingNavMesh.h"
+#include "GridPathFindingSettings.h"
+#include "Dom/JsonObject.h"
+#include "HAL/PlatformMemory.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "PathFinding/GridPathTelemetry.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+/**
+ * 寻路基准: 无World构建合成地图， 使用固定种子生成阻挡、Cost和查询集合
+ * 每个用例的结果写入 Saved/Automation/GridPathFinding/Benchmarks/<用例名>.json， 用于升级插件前后对比
+ * 命令行: -ExecCmds="Automation RunTests GridPathFinding.Benchmark"
+ */
+namespace GridPathBenchmark
+{
+	constexpr int32 Seed = 20240601;
+	constexpr int32 NumQueries = 512;
+	constexpr int32 NumWarmupQueries = 16;
+	// 抽取起点终点时的最大尝试次数， 阻挡比例很高时避免死循环
+	constexpr int32 MaxSampleAttempts = 64;
+
+	const int32 MapSizes[] = {100, 500, 1000, 2000};
+	const float ObstacleDensities[] = {0.f, 0.25f};
+	const float CostVariances[] = {0.f, 4.f};
+
+	struct FCase
+	{
+		int32 MapSize = 100;
+		ETileOrientationFlag Orientation = ETileOrientationFlag::FLAT;
+		float ObstacleDensity = 0.f;
+		float CostVariance = 0.f;
+
+		FString GetName() const
+		{
+			return FString::Printf(TEXT("Hex%dx%d_%s_Obstacle%d_Variance%d"), MapSize, MapSize,
+			                       Orientation == ETileOrientationFlag::FLAT ? TEXT("Flat") : TEXT("Pointy"),
+			                       FMath::RoundToInt(ObstacleDensity * 100.f), FMath::RoundToInt(CostVariance));
+		}
+
+		FString ToCommand() const
+		{
+			return FString::Printf(TEXT("%d %s %.2f %.2f"), MapSize,
+			                       Orientation == ETileOrientationFlag::FLAT ? TEXT("FLAT") : TEXT("POINTY"), ObstacleDensity, CostVariance);
+		}
+
+		bool ParseCommand(const FString& Command)
+		{
+			TArray<FString> Tokens;
+			Command.ParseIntoArrayWS(Tokens);
+			if (Tokens.Num() != 4)
+			{
+				return false;
+			}
+
+			MapSize = FCString::Atoi(*Tokens[0]);
+			Orientation = Tokens[1] == TEXT("POINTY") ? ETileOrientationFlag::POINTY : ETileOrientationFlag::FLAT;
+			ObstacleDensity = FCString::Atof(*Tokens[2]);
+			CostVariance = FCString::Atof(*Tokens[3]);
+			return MapSize > 0;
+		}
+	};
+
+	double GetPercentile(const TArray<double>& SortedValues, double Percentile)
+	{
+		if (SortedValues.Num() == 0)
+		{
+			return 0.0;
+		}
+
+		const int32 Index = FMath::Clamp(FMath::CeilToInt(Percentile * SortedValues.Num()) - 1, 0, SortedValues.Num() - 1);
+		return SortedValues[Index];
+	}
+
+	int32 SamplePassableTile(const UGridBenchmarkMapModel& MapModel, int32 NodeCount, FRandomStream& RandomStream)
+	{
+		int32 TileIndex = RandomStream.RandRange(0, NodeCount - 1);
+		for (int32 Attempt = 0; Attempt < MaxSampleAttempts && MapModel.IsTileBlocked(TileIndex); ++Attempt)
+		{
+			TileIndex = RandomStream.RandRange(0, NodeCount - 1);
+		}
+		return TileIndex;
+	}
+
+	double GetUsedPhysicalMB()
+	{
+		return FPlatformMemory::GetStats().UsedPhysical / (1024.0 * 1024.0);
+	}
+
+	bool SaveResult(const FString& CaseName, const TSharedRef<FJsonObject>& JsonObject, FString& OutFilePath)
+	{
+		FString JsonString;
+		const TSharedRef<TJsonWriter<>> JsonWriter = TJsonWriterFactory<>::Create(&JsonString);
+		FJsonSerializer::Serialize(JsonObject, JsonWriter);
+
+		OutFilePath = FPaths::AutomationDir() / TEXT("GridPathFinding") / TEXT("Benchmarks") / (CaseName + TEXT(".json"));
+		return FFileHelper::SaveStringToFile(JsonString, *OutFilePath);
+	}
+
+	// 邻居表与实时计算的对比只使用中等阻挡、无Cost波动的平顶地图
+	const int32 NeighborModeMapSizes[] = {500, 1000, 2000};
+	constexpr float NeighborModeObstacleDensity = 0.25f;
+}
+
+#if ENGINE_MAJOR_VERSION >= 5 && ENGINE_MINOR_VERSION >= 5
+IMPLEMENT_COMPLEX_AUTOMATION_TEST(
+	FGridPathBenchmark,
+	"GridPathFinding.Benchmark",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::PerfFilter
+);
+#else
+IMPLEMENT_COMPLEX_AUTOMATION_TEST(
+	FGridPathBenchmark,
+	"GridPathFinding.Benchmark",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter
+);
+#endif
+
+void FGridPathBenchmark::GetTests(TArray<FString>& OutBeautifiedNames, TArray<FString>& OutTestCommands) const
+{
+	using namespace GridPathBenchmark;
+
+	for (const int32 MapSize : MapSizes)
+	{
+		for (const ETileOrientationFlag Orientation : {ETileOrientationFlag::FLAT, ETileOrientationFlag::POINTY})
+		{
+			for (const float ObstacleDensity : ObstacleDensities)
+			{
+				for (const float CostVariance : CostVariances)
+				{
+					FCase Case;
+					Case.MapSize = MapSize;
+					Case.Orientation = Orientation;
+					Case.ObstacleDensity = ObstacleDensity;
+					Case.CostVariance = CostVariance;
+					OutBeautifiedNames.Add(Case.GetName());
+					OutTestCommands.Add(Case.ToCommand());
+				}
+			}
+		}
+	}
+}
+
+bool FGridPathBenchmark::RunTest(const FString& Parameters)
+{
+	using namespace GridPathBenchmark;
+
+	FCase Case;
+	if (!Case.ParseCommand(Parameters))
+	{
+		AddError(FString::Printf(TEXT("无法解析基准参数: %s"), *Parameters));
+		return false;
+	}
+
+	// 构建地图
+	const double MemoryBeforeMB = GetUsedPhysicalMB();
+	const double BuildStartSeconds = FPlatformTime::Seconds();
+
+	FGridMapConfig MapConfig;
+	MapConfig.MapType = EGridMapType::HEX_STANDARD;
+	MapConfig.TileOrientation = Case.Orientation;
+	MapConfig.DrawMode = EGridMapDrawMode::BaseOnRowColumn;
+	MapConfig.MapSize = FIntPoint(Case.MapSize, Case.MapSize);
+
+	UGridBenchmarkMapModel* MapModel = NewObject<UGridBenchmarkMapModel>(GetTransientPackage());
+	MapModel->AddToRoot();
+	MapModel->SetMapConfig(MapConfig);
+	// MaxValidIndex在BuildBlankTilesData中才会计算， 这里按行列数生成地形
+	const int32 ExpectedNodeCount = Case.MapSize * Case.MapSize;
+	MapModel->GenerateTerrain(ExpectedNodeCount, Case.ObstacleDensity, Case.CostVariance, Seed);
+	MapModel->BuildBlankTilesData(MapConfig);
+
+	const double BuildMilliseconds = (FPlatformTime::Seconds() - BuildStartSeconds) * 1000.0;
+	const double MapMemoryMB = GetUsedPhysicalMB() - MemoryBeforeMB;
+	const int32 NodeCount = MapModel->GetMaxValidIndex() + 1;
+
+	// 固定种子的查询集合
+	FRandomStream RandomStream(Seed);
+	TArray<TPair<int32, int32>> Queries;
+	Queries.Reserve(NumWarmupQueries + NumQueries);
+	for (int32 QueryIndex = 0; QueryIndex < NumWarmupQueries + NumQueries; ++QueryIndex)
+	{
+		const int32 StartIndex = SamplePassableTile(*MapModel, NodeCount, RandomStream);
+		const int32 EndIndex = SamplePassableTile(*MapModel, NodeCount, RandomStream);
+		Queries.Emplace(StartIndex, EndIndex);
+	}
+
+	FGridPathFilter Filter(*MapModel);
+	Filter.SearchMode = EGridPathSearchMode::AStar;
+
+	TArray<int32> PathIndices;
+	float PathCost = 0.f;
+	for (int32 QueryIndex = 0; QueryIndex < NumWarmupQueries; ++QueryIndex)
+	{
+		MapModel->SearchPathIndices(Filter, Queries[QueryIndex].Key, Queries[QueryIndex].Value, PathIndices, PathCost);
+	}
+
+	TArray<double> LatenciesMicroseconds;
+	LatenciesMicroseconds.Reserve(NumQueries);
+	int64 TotalExpandedNodes = 0;
+	int32 MaxExpandedNodes = 0;
+	int32 PeakOpenNodes = 0;
+	int32 NumSuccess = 0;
+	for (int32 QueryIndex = NumWarmupQueries; QueryIndex < Queries.Num(); ++QueryIndex)
+	{
+		FGridPathQueryStats Stats;
+		const uint64 StartCycles = FPlatformTime::Cycles64();
+		const EGraphAStarResult Result = MapModel->SearchPathIndices(Filter, Queries[QueryIndex].Key, Queries[QueryIndex].Value,
+		                                                             PathIndices, PathCost, &Stats);
+		LatenciesMicroseconds.Add(FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles) * 1000.0);
+
+		TotalExpandedNodes += Stats.NumExpandedNodes;
+		MaxExpandedNodes = FMath::Max(MaxExpandedNodes, Stats.NumExpandedNodes);
+		PeakOpenNodes = FMath::Max(PeakOpenNodes, Stats.PeakOpenNodes);
+		NumSuccess += Result == SearchSuccess ? 1 : 0;
+	}
+
+	const double PeakMemoryMB = GetUsedPhysicalMB() - MemoryBeforeMB;
+
+	MapModel->RemoveFromRoot();
+	MapModel->MarkAsGarbage();
+
+	LatenciesMicroseconds.Sort();
+	double TotalMicroseconds = 0.0;
+	for (const double Latency : LatenciesMicroseconds)
+	{
+		TotalMicroseconds += Latency;
+	}
+
+	// 输出
+	const TSharedRef<FJsonObject> JsonObject = MakeShared<FJsonObject>();
+	JsonObject->SetStringField(TEXT("Case"), Case.GetName());
+	JsonObject->SetNumberField(TEXT("MapSize"), Case.MapSize);
+	JsonObject->SetStringField(TEXT("Orientation"), Case.Orientation == ETileOrientationFlag::FLAT ? TEXT("FLAT") : TEXT("POINTY"));
+	JsonObject->SetNumberField(TEXT("ObstacleDensity"), Case.ObstacleDensity);
+	JsonObject->SetNumberField(TEXT("CostVariance"), Case.CostVariance);
+	JsonObject->SetNumberField(TEXT("Seed"), Seed);
+	JsonObject->SetNumberField(TEXT("NodeCount"), NodeCount);
+	JsonObject->SetNumberField(TEXT("NumQueries"), NumQueries);
+	JsonObject->SetNumberField(TEXT("NumSuccess"), NumSuccess);
+	JsonObject->SetNumberField(TEXT("BuildMilliseconds"), BuildMilliseconds);
+	JsonObject->SetNumberField(TEXT("LatencyP50Microseconds"), GetPercentile(LatenciesMicroseconds, 0.5));
+	JsonObject->SetNumberField(TEXT("LatencyP99Microseconds"), GetPercentile(LatenciesMicroseconds, 0.99));
+	JsonObject->SetNumberField(TEXT("LatencyMeanMicroseconds"), TotalMicroseconds / FMath::Max(LatenciesMicroseconds.Num(), 1));
+	JsonObject->SetNumberField(TEXT("AvgExpandedNodes"), static_cast<double>(TotalExpandedNodes) / NumQueries);
+	JsonObject->SetNumberField(TEXT("MaxExpandedNodes"), MaxExpandedNodes);
+	JsonObject->SetNumberField(TEXT("PeakOpenNodes"), PeakOpenNodes);
+	JsonObject->SetNumberField(TEXT("MapMemoryMB"), MapMemoryMB);
+	JsonObject->SetNumberField(TEXT("PeakMemoryMB"), PeakMemoryMB);
+
+	FString FilePath;
+	if (!SaveResult(Case.GetName(), JsonObject, FilePath))
+	{
+		AddError(FString::Printf(TEXT("写入基准结果失败: %s"), *FilePath));
+		return false;
+	}
+
+	AddInfo(FString::Printf(TEXT("%s: p50 %.2fus, p99 %.2fus, 平均展开%.1f, 构建%.1fms, 内存%.1fMB -> %s"), *Case.GetName(),
+	                        GetPercentile(LatenciesMicroseconds, 0.5), GetPercentile(LatenciesMicroseconds, 0.99),
+	                        static_cast<double>(TotalExpandedNodes) / NumQueries, BuildMilliseconds, MapMemoryMB, *FilePath));
+	return true;
+}
+
+#if ENGINE_MAJOR_VERSION >= 5 && ENGINE_MINOR_VERSION >= 5
+IMPLEMENT_COMPLEX_AUTOMATION_TEST(
+	FGridNeighborModeBenchmark,
+	"GridPathFinding.Benchmark.NeighborMode",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::PerfFilter
+);
+#else
+IMPLEMENT_COMPLEX_AUTOMATION_TEST(
+	FGridNeighborModeBenchmark,
+	"GridPathFinding.Benchmark.NeighborMode",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter
+);
+#endif
+
+void FGridNeighborModeBenchmark::GetTests(TArray<FString>& OutBeautifiedNames, TArray<FString>& OutTestCommands) const
+{
+	using namespace GridPathBenchmark;
+
+	for (const int32 MapSize : NeighborModeMapSizes)
+	{
+		for (const EGridNeighborIndexMode Mode : {EGridNeighborIndexMode::Table, EGridNeighborIndexMode::Computed})
+		{
+			const TCHAR* ModeName = Mode == EGridNeighborIndexMode::Table ? TEXT("Table") : TEXT("Computed");
+			OutBeautifiedNames.Add(FString::Printf(TEXT("Hex%dx%d_%s"), MapSize, MapSize, ModeName));
+			OutTestCommands.Add(FString::Printf(TEXT("%d %s"), MapSize, ModeName));
+		}
+	}
+}
+
+bool FGridNeighborModeBenchmark::RunTest(const FString& Parameters)
+{
+	using namespace GridPathBenchmark;
+
+	TArray<FString> Tokens;
+	Parameters.ParseIntoArrayWS(Tokens);
+	if (Tokens.Num() != 2)
+	{
+		AddError(FString::Printf(TEXT("无法解析基准参数: %s"), *Parameters));
+		return false;
+	}
+
+	const int32 MapSize = FCString::Atoi(*Tokens[0]);
+	const EGridNeighborIndexMode Mode = Tokens[1] == TEXT("Computed") ? EGridNeighborIndexMode::Computed : EGridNeighborIndexMode::Table;
+	const FString CaseName = FString::Printf(TEXT("NeighborMode_Hex%dx%d_%s"), MapSize, MapSize, *Tokens[1]);
+
+	FGridMapConfig MapConfig;
+	MapConfig.MapType = EGridMapType::HEX_STANDARD;
+	MapConfig.TileOrientation = ETileOrientationFlag::FLAT;
+	MapConfig.DrawMode = EGridMapDrawMode::BaseOnRowColumn;
+	MapConfig.MapSize = FIntPoint(MapSize, MapSize);
+
+	UGridBenchmarkMapModel* MapModel = NewObject<UGridBenchmarkMapModel>(GetTransientPackage());
+	MapModel->AddToRoot();
+	MapModel->SetMapConfig(MapConfig);
+	MapModel->GenerateTerrain(MapSize * MapSize, NeighborModeObstacleDensity, 0.f, Seed);
+
+	// 邻居获取方式在构建时从设置中读取， 构建完成后恢复
+	UGridPathFindingSettings* Settings = GetMutableDefault<UGridPathFindingSettings>();
+	const EGridNeighborIndexMode OldMode = Settings->NeighborIndexMode;
+	Settings->NeighborIndexMode = Mode;
+	const double BuildStartSeconds = FPlatformTime::Seconds();
+	MapModel->BuildBlankTilesData(MapConfig);
+	const double BuildMilliseconds = (FPlatformTime::Seconds() - BuildStartSeconds) * 1000.0;
+	Settings->NeighborIndexMode = OldMode;
+
+	const double NeighborTableMB = MapModel->GetNeighborTableAllocatedSize() / (1024.0 * 1024.0);
+	const int32 NodeCount = MapModel->GetMaxValidIndex() + 1;
+
+	FRandomStream RandomStream(Seed);
+	TArray<TPair<int32, int32>> Queries;
+	Queries.Reserve(NumWarmupQueries + NumQueries);
+	for (int32 QueryIndex = 0; QueryIndex < NumWarmupQueries + NumQueries; ++QueryIndex)
+	{
+		const int32 StartIndex = SamplePassableTile(*MapModel, NodeCount, RandomStream);
+		const int32 EndIndex = SamplePassableTile(*MapModel, NodeCount, RandomStream);
+		Queries.Emplace(StartIndex, EndIndex);
+	}
+
+	FGridPathFilter Filter(*MapModel);
+	Filter.SearchMode = EGridPathSearchMode::AStar;
+
+	TArray<int32> PathIndices;
+	float PathCost = 0.f;
+	for (int32 QueryIndex = 0; QueryIndex < NumWarmupQueries; ++QueryIndex)
+	{
+		MapModel->SearchPathIndices(Filter, Queries[QueryIndex].Key, Queries[QueryIndex].Value, PathIndices, PathCost);
+	}
+
+	int64 TotalExpandedNodes = 0;
+	const double QueryStartSeconds = FPlatformTime::Seconds();
+	for (int32 QueryIndex = NumWarmupQueries; QueryIndex < Queries.Num(); ++QueryIndex)
+	{
+		FGridPathQueryStats Stats;
+		MapModel->SearchPathIndices(Filter, Queries[QueryIndex].Key, Queries[QueryIndex].Value, PathIndices, PathCost, &Stats);
+		TotalExpandedNodes += Stats.NumExpandedNodes;
+	}
+	const double QuerySeconds = FMath::Max(FPlatformTime::Seconds() - QueryStartSeconds, UE_DOUBLE_SMALL_NUMBER);
+
+	MapModel->RemoveFromRoot();
+	MapModel->MarkAsGarbage();
+
+	const TSharedRef<FJsonObject> JsonObject = MakeShared<FJsonObject>();
+	JsonObject->SetStringField(TEXT("Case"), CaseName);
+	JsonObject->SetNumberField(TEXT("MapSize"), MapSize);
+	JsonObject->SetStringField(TEXT("NeighborIndexMode"), Tokens[1]);
+	JsonObject->SetNumberField(TEXT("Seed"), Seed);
+	JsonObject->SetNumberField(TEXT("NodeCount"), NodeCount);
+	JsonObject->SetNumberField(TEXT("NumQueries"), NumQueries);
+	JsonObject->SetNumberField(TEXT("BuildMilliseconds"), BuildMilliseconds);
+	JsonObject->SetNumberField(TEXT("NeighborTableMB"), NeighborTableMB);
+	JsonObject->SetNumberField(TEXT("QueriesPerSecond"), NumQueries / QuerySeconds);
+	JsonObject->SetNumberField(TEXT("ExpandedNodesPerSecond"), TotalExpandedNodes / QuerySeconds);
+
+	FString FilePath;
+	if (!SaveResult(CaseName, JsonObject, FilePath))
+	{
+		AddError(FString::Printf(TEXT("写入基准结果失败: %s"), *FilePath));
+		return false;
+	}
+
+	AddInfo(FString::Printf(TEXT("%s: 构建%.1fms, 邻居表%.1fMB, %.0f次查询/秒, %.0f节点/秒 -> %s"), *CaseName, BuildMilliseconds,
+	                        NeighborTableMB, NumQueries / QuerySeconds, TotalExpandedNodes / QuerySeconds, *FilePath));
+	return true;
+}
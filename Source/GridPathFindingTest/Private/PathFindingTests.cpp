@@ -0,0 +1,1828 @@
+#include "GridBenchmarkMapModel.h"
+#include "GridPathFindingNavMesh.h"
+#include "GridPathFindingSettings.h"
+#include "GraphAStar.h"
+#include "Misc/AutomationTest.h"
+#include "PathFinding/GridAStar.h"
+#include "PathFinding/GridConnectivity.h"
+#include "PathFinding/GridCooperativePathFinder.h"
+#include "PathFinding/GridCostLayers.h"
+#include "PathFinding/GridFieldOfView.h"
+#include "PathFinding/GridFlowField.h"
+#include "PathFinding/GridIncrementalPathPlanner.h"
+#include "PathFinding/GridLandmarks.h"
+#include "PathFinding/GridPathTelemetry.h"
+#include "PathFinding/GridReachableArea.h"
+#include "PathFinding/GridTileStore.h"
+
+/**
+ * 寻路正确性测试: 在固定种子的合成地图上， 以引擎的FGraphAStar作为参照比较各种搜索方式的路径Cost
+ * 命令行: -ExecCmds="Automation RunTests GridPathFinding.PathFinding"
+ */
+namespace GridPathFindingTests
+{
+	constexpr int32 Seed = 20240601;
+	constexpr int32 NumQueries = 96;
+	constexpr float CostTolerance = 1e-2f;
+	constexpr int32 MaxSampleAttempts = 64;
+
+	// 一半的行列数为奇数(5、15)与偶数(32)的地图
+	const int32 MapSizes[] = {10, 30, 64};
+	const float ObstacleDensities[] = {0.f, 0.25f};
+	const float CostVariances[] = {0.f, 4.f};
+
+	struct FMapCase
+	{
+		ETileOrientationFlag Orientation = ETileOrientationFlag::FLAT;
+		int32 MapSize = 0;
+		float ObstacleDensity = 0.f;
+		float CostVariance = 0.f;
+
+		FString GetName() const
+		{
+			return FString::Printf(TEXT("%s_%d_Obstacle%d_Variance%d"), Orientation == ETileOrientationFlag::FLAT ? TEXT("Flat") : TEXT("Pointy"), MapSize,
+			                       FMath::RoundToInt(ObstacleDensity * 100.f), FMath::RoundToInt(CostVariance));
+		}
+	};
+
+	/**
+	 * 朝向、地图大小、阻挡比例、Cost变化的所有组合
+	 */
+	TArray<FMapCase> GetMapCases()
+	{
+		TArray<FMapCase> MapCases;
+		for (const ETileOrientationFlag Orientation : {ETileOrientationFlag::FLAT, ETileOrientationFlag::POINTY})
+		{
+			for (const int32 MapSize : MapSizes)
+			{
+				for (const float ObstacleDensity : ObstacleDensities)
+				{
+					for (const float CostVariance : CostVariances)
+					{
+						MapCases.Add({Orientation, MapSize, ObstacleDensity, CostVariance});
+					}
+				}
+			}
+		}
+		return MapCases;
+	}
+
+	/**
+	 * 重构前FindPath交给FGraphAStar的图接口， 与AGridPathFindingNavMesh原来的实现相同
+	 */
+	struct FModelGraph
+	{
+		typedef int32 FNodeRef;
+
+		explicit FModelGraph(const UGridMapModel& InMapModel)
+			: MapModel(InMapModel)
+		{
+		}
+
+		int32 GetNeighbourCount(FNodeRef NodeRef) const
+		{
+			return 6;
+		}
+
+		bool IsValidRef(FNodeRef NodeRef) const
+		{
+			return NodeRef >= 0 && NodeRef <= MapModel.GetMaxValidIndex();
+		}
+
+		FNodeRef GetNeighbour(const FNodeRef NodeRef, const int32 NeiIndex) const
+		{
+			return MapModel.GetNeighborIndex(NodeRef, NeiIndex);
+		}
+
+		const UGridMapModel& MapModel;
+	};
+
+	struct FQuery
+	{
+		int32 StartIndex = INDEX_NONE;
+		int32 EndIndex = INDEX_NONE;
+	};
+
+	UGridBenchmarkMapModel* CreateMap(const FMapCase& MapCase)
+	{
+		FGridMapConfig MapConfig;
+		MapConfig.MapType = EGridMapType::HEX_STANDARD;
+		MapConfig.TileOrientation = MapCase.Orientation;
+		MapConfig.DrawMode = EGridMapDrawMode::BaseOnRowColumn;
+		MapConfig.MapSize = FIntPoint(MapCase.MapSize, MapCase.MapSize);
+
+		UGridBenchmarkMapModel* MapModel = NewObject<UGridBenchmarkMapModel>(GetTransientPackage());
+		MapModel->AddToRoot();
+		MapModel->SetMapConfig(MapConfig);
+		MapModel->GenerateTerrain(MapCase.MapSize * MapCase.MapSize, MapCase.ObstacleDensity, MapCase.CostVariance, Seed);
+		MapModel->BuildBlankTilesData(MapConfig);
+		return MapModel;
+	}
+
+	void DestroyMap(UGridBenchmarkMapModel* MapModel)
+	{
+		MapModel->RemoveFromRoot();
+		MapModel->MarkAsGarbage();
+	}
+
+	/**
+	 * 起点终点都不阻挡且不相同
+	 */
+	TArray<FQuery> MakeQueries(const UGridBenchmarkMapModel& MapModel)
+	{
+		const int32 NodeCount = MapModel.GetMaxValidIndex() + 1;
+		FRandomStream RandomStream(Seed);
+		auto SampleTile = [&MapModel, &RandomStream, NodeCount]()
+		{
+			int32 TileIndex = RandomStream.RandRange(0, NodeCount - 1);
+			for (int32 Attempt = 0; Attempt < MaxSampleAttempts && MapModel.IsTileBlocked(TileIndex); ++Attempt)
+			{
+				TileIndex = RandomStream.RandRange(0, NodeCount - 1);
+			}
+			return TileIndex;
+		};
+
+		TArray<FQuery> Queries;
+		while (Queries.Num() < NumQueries)
+		{
+			FQuery Query;
+			Query.StartIndex = SampleTile();
+			Query.EndIndex = SampleTile();
+			if (Query.StartIndex != Query.EndIndex && !MapModel.IsTileBlocked(Query.StartIndex) && !MapModel.IsTileBlocked(Query.EndIndex))
+			{
+				Queries.Add(Query);
+			}
+		}
+		return Queries;
+	}
+
+	/**
+	 * 路径必须从起点出发逐格相邻、每条边都可通行、以终点结束， 返回路径上边Cost的和
+	 */
+	bool ValidatePath(const FGridPathFilter& Filter, const FQuery& Query, const TArray<int32>& Path, float& OutCost)
+	{
+		OutCost = 0.f;
+		if (Path.Num() == 0 || Path.Last() != Query.EndIndex)
+		{
+			return false;
+		}
+
+		int32 FromIndex = Query.StartIndex;
+		for (const int32 ToIndex : Path)
+		{
+			int32 Direction = 0;
+			while (Direction < Filter.GetNeighbourCount() && Filter.GetNeighbour(FromIndex, Direction) != ToIndex)
+			{
+				++Direction;
+			}
+
+			FVector::FReal EdgeCost = 0.0;
+			if (Direction == Filter.GetNeighbourCount() || !Filter.TryGetEdgeCost(FromIndex, Direction, ToIndex, EdgeCost))
+			{
+				return false;
+			}
+
+			OutCost += EdgeCost;
+			FromIndex = ToIndex;
+		}
+		return true;
+	}
+
+	/**
+	 * FGraphAStar的最优Cost， 不可达返回false
+	 */
+	bool FindReferenceCost(const UGridMapModel& MapModel, const FGridPathFilter& Filter, const FQuery& Query, float& OutCost)
+	{
+		const FModelGraph Graph(MapModel);
+		FGraphAStar<FModelGraph> Pathfinder(Graph);
+		TArray<int32> Path;
+		if (Pathfinder.FindPath(Query.StartIndex, Query.EndIndex, Filter, Path) != SearchSuccess)
+		{
+			return false;
+		}
+		return ValidatePath(Filter, Query, Path, OutCost);
+	}
+
+	/**
+	 * 各个查询上FGridAStar的结果， 作为其他搜索方式的参照， FGridAStar本身已与FGraphAStar比较过
+	 */
+	struct FAStarReference
+	{
+		bool bSuccess = false;
+		float Cost = 0.f;
+	};
+
+	TArray<FAStarReference> FindAStarReferences(const FGridPathFilter& Filter, const TArray<FQuery>& Queries)
+	{
+		TArray<FAStarReference> References;
+		for (const FQuery& Query : Queries)
+		{
+			FGridAStar Pathfinder;
+			TArray<int32> Path;
+			FAStarReference& Reference = References.AddDefaulted_GetRef();
+			Reference.bSuccess = Pathfinder.FindPath(Query.StartIndex, Query.EndIndex, Filter, Path) == SearchSuccess;
+			Reference.Cost = Reference.bSuccess ? Pathfinder.GetPathCost() : 0.f;
+		}
+		return References;
+	}
+}
+
+#if ENGINE_MAJOR_VERSION >= 5 && ENGINE_MINOR_VERSION >= 5
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FGridAStarParityTest,
+	"GridPathFinding.PathFinding.AStarParity",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter
+);
+#else
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FGridAStarParityTest,
+	"GridPathFinding.PathFinding.AStarParity",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter
+);
+#endif
+
+bool FGridAStarParityTest::RunTest(const FString& Parameters)
+{
+	using namespace GridPathFindingTests;
+
+	for (const FMapCase& MapCase : GetMapCases())
+	{
+		const FString CaseName = MapCase.GetName();
+		UGridBenchmarkMapModel* MapModel = CreateMap(MapCase);
+
+		FGridPathFilter Filter(*MapModel);
+		Filter.SearchMode = EGridPathSearchMode::AStar;
+
+		int32 NumReachable = 0;
+		for (const FQuery& Query : MakeQueries(*MapModel))
+		{
+			float ReferenceCost = 0.f;
+			const bool bReferenceSuccess = FindReferenceCost(*MapModel, Filter, Query, ReferenceCost);
+
+			// 通用过滤器上的FGridAStar
+			FGridAStar Pathfinder;
+			TArray<int32> Path;
+			const bool bSuccess = Pathfinder.FindPath(Query.StartIndex, Query.EndIndex, Filter, Path) == SearchSuccess;
+			TestEqual(FString::Printf(TEXT("%s %d->%d 可达性"), *CaseName, Query.StartIndex, Query.EndIndex), bSuccess, bReferenceSuccess);
+
+			// SearchPathIndices按拓扑选择的模板过滤器
+			TArray<int32> TopologyPath;
+			float TopologyCost = 0.f;
+			const bool bTopologySuccess = MapModel->SearchPathIndices(Filter, Query.StartIndex, Query.EndIndex, TopologyPath, TopologyCost) == SearchSuccess;
+			TestEqual(FString::Printf(TEXT("%s %d->%d 拓扑过滤器可达性"), *CaseName, Query.StartIndex, Query.EndIndex), bTopologySuccess, bReferenceSuccess);
+
+			if (!bSuccess || !bReferenceSuccess || !bTopologySuccess)
+			{
+				continue;
+			}
+
+			++NumReachable;
+			float PathCost = 0.f;
+			TestTrue(FString::Printf(TEXT("%s %d->%d 路径有效"), *CaseName, Query.StartIndex, Query.EndIndex), ValidatePath(Filter, Query, Path, PathCost));
+			TestEqual(FString::Printf(TEXT("%s %d->%d 路径Cost"), *CaseName, Query.StartIndex, Query.EndIndex), PathCost, ReferenceCost, CostTolerance);
+			TestEqual(FString::Printf(TEXT("%s %d->%d GetPathCost"), *CaseName, Query.StartIndex, Query.EndIndex), Pathfinder.GetPathCost(), ReferenceCost, CostTolerance);
+			TestEqual(FString::Printf(TEXT("%s %d->%d 拓扑过滤器Cost"), *CaseName, Query.StartIndex, Query.EndIndex), TopologyCost, ReferenceCost, CostTolerance);
+		}
+
+		TestTrue(FString::Printf(TEXT("%s 存在可达的查询"), *CaseName), NumReachable > 0);
+		DestroyMap(MapModel);
+	}
+
+	return !HasAnyErrors();
+}
+
+#if ENGINE_MAJOR_VERSION >= 5 && ENGINE_MINOR_VERSION >= 5
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FGridHexRadiusIndexTest,
+	"GridPathFinding.PathFinding.HexRadiusIndex",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter
+);
+#else
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FGridHexRadiusIndexTest,
+	"GridPathFinding.PathFinding.HexRadiusIndex",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter
+);
+#endif
+
+bool FGridHexRadiusIndexTest::RunTest(const FString& Parameters)
+{
+	constexpr int32 MaxRadius = 39;
+
+	for (int32 Radius = 0; Radius <= MaxRadius; ++Radius)
+	{
+		FGridMapConfig MapConfig;
+		MapConfig.MapType = EGridMapType::HEX_STANDARD;
+		MapConfig.DrawMode = EGridMapDrawMode::BaseOnRadius;
+		MapConfig.MapRadius = Radius;
+
+		UGridMapModel* MapModel = NewObject<UGridMapModel>(GetTransientPackage());
+		MapModel->SetMapConfig(MapConfig);
+		const TArray<FIntPoint>& IndexToAxial = MapModel->GetRadiusIndexToAxial();
+
+		// 按Q、R递增遍历， Index应当从0开始连续
+		int32 ExpectedIndex = 0;
+		int32 NumMismatches = 0;
+		for (int32 Q = -Radius; Q <= Radius; ++Q)
+		{
+			for (int32 R = FMath::Max(-Radius, -Q - Radius); R <= FMath::Min(Radius, -Q + Radius); ++R)
+			{
+				int32 CoordQ = 0, CoordR = 0;
+				FGridHexRadiusTopology::GetCoord(ExpectedIndex, Radius, CoordQ, CoordR);
+				const bool bMatches = FGridHexRadiusTopology::GetIndex(Q, R, Radius) == ExpectedIndex &&
+					CoordQ == Q && CoordR == R &&
+					IndexToAxial.IsValidIndex(ExpectedIndex) && IndexToAxial[ExpectedIndex] == FIntPoint(Q, R);
+				NumMismatches += bMatches ? 0 : 1;
+				++ExpectedIndex;
+			}
+		}
+
+		TestEqual(FString::Printf(TEXT("Radius %d GetIndex/GetCoord往返不一致的格子数"), Radius), NumMismatches, 0);
+		TestEqual(FString::Printf(TEXT("Radius %d 格子数"), Radius), ExpectedIndex, FGridHexRadiusTopology::GetTileCount(Radius));
+		TestEqual(FString::Printf(TEXT("Radius %d 坐标表大小"), Radius), IndexToAxial.Num(), ExpectedIndex);
+		TestEqual(FString::Printf(TEXT("Radius %d 地图外的坐标"), Radius), FGridHexRadiusTopology::GetIndex(Radius + 1, 0, Radius), static_cast<int32>(INDEX_NONE));
+
+		MapModel->MarkAsGarbage();
+	}
+
+	return !HasAnyErrors();
+}
+
+#if ENGINE_MAJOR_VERSION >= 5 && ENGINE_MINOR_VERSION >= 5
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FGridVolumeTileIndexTest,
+	"GridPathFinding.PathFinding.VolumeTileIndex",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter
+);
+#else
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FGridVolumeTileIndexTest,
+	"GridPathFinding.PathFinding.VolumeTileIndex",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter
+);
+#endif
+
+bool FGridVolumeTileIndexTest::RunTest(const FString& Parameters)
+{
+	using namespace GridPathFindingTests;
+
+	// 覆盖所有Volume的轴向坐标范围
+	constexpr int32 MaxAxial = 128;
+
+	auto MakeVolume = [](EGridMapVolumeShapeType ShapeType, const FVector& Center, const FVector& BoxExtent, float SphereRadius)
+	{
+		FGripMapVolume Volume;
+		Volume.ShapeType = ShapeType;
+		Volume.Center = Center;
+		Volume.BoxExtent = BoxExtent;
+		Volume.SphereRadius = SphereRadius;
+		return Volume;
+	};
+
+	// 与BuildVolumeTileIndex相同， 只比较XY
+	auto IsInVolume = [](const FGripMapVolume& Volume, const FVector& Location)
+	{
+		const double DeltaX = Location.X - Volume.Center.X;
+		const double DeltaY = Location.Y - Volume.Center.Y;
+		return Volume.ShapeType == EGridMapVolumeShapeType::BOX
+			       ? FMath::Abs(DeltaX) <= Volume.BoxExtent.X && FMath::Abs(DeltaY) <= Volume.BoxExtent.Y
+			       : DeltaX * DeltaX + DeltaY * DeltaY <= FMath::Square(static_cast<double>(Volume.SphereRadius));
+	};
+
+	FGridMapConfig MapConfig;
+	MapConfig.MapType = EGridMapType::HEX_STANDARD;
+	MapConfig.TileOrientation = ETileOrientationFlag::FLAT;
+	MapConfig.DrawMode = EGridMapDrawMode::BaseOnVolume;
+	// 主区域跨越多个16格的页， 第二个Volume与其重叠， 另外两个互不相连
+	MapConfig.PlaceVolumes.Add(MakeVolume(EGridMapVolumeShapeType::BOX, FVector::ZeroVector, FVector(2000.f, 2000.f, 100.f), 0.f));
+	MapConfig.PlaceVolumes.Add(MakeVolume(EGridMapVolumeShapeType::BOX, FVector(1500.f, 0.f, 0.f), FVector(1000.f, 1000.f, 100.f), 0.f));
+	MapConfig.PlaceVolumes.Add(MakeVolume(EGridMapVolumeShapeType::BOX, FVector(10000.f, 10000.f, 0.f), FVector(600.f, 600.f, 100.f), 0.f));
+	MapConfig.PlaceVolumes.Add(MakeVolume(EGridMapVolumeShapeType::SPHERE, FVector(-10000.f, 5000.f, 0.f), FVector::ZeroVector, 800.f));
+	// 在主区域中间挖一个洞
+	MapConfig.SubtractVolumes.Add(MakeVolume(EGridMapVolumeShapeType::BOX, FVector::ZeroVector, FVector(300.f, 300.f, 100.f), 0.f));
+
+	UGridMapModel* MapModel = NewObject<UGridMapModel>(GetTransientPackage());
+	MapModel->AddToRoot();
+	MapModel->BuildBlankTilesData(MapConfig);
+	const FGridPagedTileIndex& PagedTileIndex = MapModel->GetPagedTileIndex();
+
+	// Index与坐标互相对应， 并且Index连续、不重复
+	TSet<FIntPoint> UniqueAxials;
+	int32 NumRoundTripMismatches = 0;
+	for (int32 TileIndex = 0; TileIndex < PagedTileIndex.Num(); ++TileIndex)
+	{
+		const FIntPoint& Axial = PagedTileIndex.GetAxial(TileIndex);
+		UniqueAxials.Add(Axial);
+		NumRoundTripMismatches += PagedTileIndex.GetIndex(Axial.X, Axial.Y) == TileIndex ? 0 : 1;
+	}
+	TestEqual(TEXT("GetIndex(GetAxial(i)) != i 的格子数"), NumRoundTripMismatches, 0);
+	TestEqual(TEXT("格子坐标不重复"), UniqueAxials.Num(), PagedTileIndex.Num());
+	TestEqual(TEXT("MaxValidIndex"), MapModel->GetMaxValidIndex(), PagedTileIndex.Num() - 1);
+
+	// 逐个坐标判断是否在Volume中， 重叠区域只计一次， 剔除区域不计
+	int32 NumExpected = 0;
+	int32 NumMembershipMismatches = 0;
+	for (int32 Q = -MaxAxial; Q <= MaxAxial; ++Q)
+	{
+		for (int32 R = -MaxAxial; R <= MaxAxial; ++R)
+		{
+			const FVector Location = MapModel->StableCoordToWorld(FHCubeCoord{FIntVector(Q, R, -Q - R)});
+			const bool bExpected = MapConfig.PlaceVolumes.ContainsByPredicate([&](const FGripMapVolume& Volume) { return IsInVolume(Volume, Location); }) &&
+				!MapConfig.SubtractVolumes.ContainsByPredicate([&](const FGripMapVolume& Volume) { return IsInVolume(Volume, Location); });
+			NumExpected += bExpected ? 1 : 0;
+			NumMembershipMismatches += bExpected == (PagedTileIndex.GetIndex(Q, R) != INDEX_NONE) ? 0 : 1;
+		}
+	}
+	TestEqual(TEXT("Volume覆盖的格子与Index不一致的坐标数"), NumMembershipMismatches, 0);
+	TestEqual(TEXT("格子数等于Volume覆盖的不重复格子数"), PagedTileIndex.Num(), NumExpected);
+	TestTrue(TEXT("格子分布在多个页中"), PagedTileIndex.GetPageCount() > 1);
+
+	// 主区域两侧的格子位于不同的页， 路径必须跨越页的边界并绕过中间的洞
+	FGridPathFilter Filter(*MapModel);
+	Filter.SearchMode = EGridPathSearchMode::AStar;
+	FQuery Query;
+	Query.StartIndex = MapModel->StableGetFullMapGridIterIndex(MapModel->StableWorldToCoord(FVector(-1500.f, 0.f, 0.f)));
+	Query.EndIndex = MapModel->StableGetFullMapGridIterIndex(MapModel->StableWorldToCoord(FVector(1500.f, 0.f, 0.f)));
+	TestTrue(TEXT("起点与终点在地图中"), PagedTileIndex.IsValidIndex(Query.StartIndex) && PagedTileIndex.IsValidIndex(Query.EndIndex));
+	if (PagedTileIndex.IsValidIndex(Query.StartIndex) && PagedTileIndex.IsValidIndex(Query.EndIndex))
+	{
+		FGridAStar Pathfinder;
+		TArray<int32> Path;
+		const bool bSuccess = Pathfinder.FindPath(Query.StartIndex, Query.EndIndex, Filter, Path) == SearchSuccess;
+		float ReferenceCost = 0.f;
+		const bool bReferenceSuccess = FindReferenceCost(*MapModel, Filter, Query, ReferenceCost);
+		TestTrue(TEXT("跨页寻路成功"), bSuccess && bReferenceSuccess);
+		if (bSuccess && bReferenceSuccess)
+		{
+			float PathCost = 0.f;
+			TestTrue(TEXT("跨页路径有效"), ValidatePath(Filter, Query, Path, PathCost));
+			TestEqual(TEXT("跨页路径Cost"), PathCost, ReferenceCost, CostTolerance);
+
+			int32 NumPageCrossings = 0;
+			int32 FromIndex = Query.StartIndex;
+			for (const int32 ToIndex : Path)
+			{
+				const FIntPoint& FromAxial = PagedTileIndex.GetAxial(FromIndex);
+				const FIntPoint& ToAxial = PagedTileIndex.GetAxial(ToIndex);
+				NumPageCrossings += PagedTileIndex.GetTilePage(FromAxial.X, FromAxial.Y) != PagedTileIndex.GetTilePage(ToAxial.X, ToAxial.Y) ? 1 : 0;
+				FromIndex = ToIndex;
+			}
+			TestTrue(TEXT("路径跨越页的边界"), NumPageCrossings > 0);
+		}
+
+		// 互不相连的Volume之间不可达
+		const int32 IsolatedIndex = MapModel->StableGetFullMapGridIterIndex(MapModel->StableWorldToCoord(FVector(10000.f, 10000.f, 0.f)));
+		TestTrue(TEXT("独立区域的格子在地图中"), PagedTileIndex.IsValidIndex(IsolatedIndex));
+		if (PagedTileIndex.IsValidIndex(IsolatedIndex))
+		{
+			FGridAStar IsolatedPathfinder;
+			TArray<int32> IsolatedPath;
+			TestTrue(TEXT("独立区域不可达"), IsolatedPathfinder.FindPath(Query.StartIndex, IsolatedIndex, Filter, IsolatedPath) != SearchSuccess);
+		}
+	}
+
+	MapModel->RemoveFromRoot();
+	MapModel->MarkAsGarbage();
+	return !HasAnyErrors();
+}
+
+#if ENGINE_MAJOR_VERSION >= 5 && ENGINE_MINOR_VERSION >= 5
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FGridHexDistanceTest,
+	"GridPathFinding.PathFinding.HexDistance",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter
+);
+#else
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FGridHexDistanceTest,
+	"GridPathFinding.PathFinding.HexDistance",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter
+);
+#endif
+
+bool FGridHexDistanceTest::RunTest(const FString& Parameters)
+{
+	// 一半的行列数为奇数的地图， 以及行列数不同的地图
+	const FIntPoint MapSizes[] = {FIntPoint(6, 6), FIntPoint(10, 10), FIntPoint(7, 9), FIntPoint(30, 30)};
+
+	for (const ETileOrientationFlag Orientation : {ETileOrientationFlag::FLAT, ETileOrientationFlag::POINTY})
+	{
+		for (const FIntPoint& MapSize : MapSizes)
+		{
+			FGridMapConfig MapConfig;
+			MapConfig.MapType = EGridMapType::HEX_STANDARD;
+			MapConfig.TileOrientation = Orientation;
+			MapConfig.DrawMode = EGridMapDrawMode::BaseOnRowColumn;
+			MapConfig.MapSize = MapSize;
+
+			UGridMapModel* MapModel = NewObject<UGridMapModel>(GetTransientPackage());
+			MapModel->AddToRoot();
+			MapModel->BuildBlankTilesData(MapConfig);
+
+			FGridTopologyParams Params;
+			Params.Initialize(MapConfig);
+
+			// 没有阻挡的矩形地图上， 六边形距离等于BFS的步数
+			const int32 NodeCount = MapModel->GetMaxValidIndex() + 1;
+			TArray<int32> HopCounts;
+			TArray<int32> Frontier;
+			int32 NumMismatches = 0;
+			for (int32 SourceIndex = 0; SourceIndex < NodeCount; ++SourceIndex)
+			{
+				HopCounts.Init(INDEX_NONE, NodeCount);
+				HopCounts[SourceIndex] = 0;
+				Frontier.Reset();
+				Frontier.Add(SourceIndex);
+				for (int32 FrontierIndex = 0; FrontierIndex < Frontier.Num(); ++FrontierIndex)
+				{
+					const int32 NodeIndex = Frontier[FrontierIndex];
+					for (int32 Direction = 0; Direction < 6; ++Direction)
+					{
+						const int32 NeighbourIndex = MapModel->GetNeighborIndex(NodeIndex, Direction);
+						if (NeighbourIndex != INDEX_NONE && HopCounts[NeighbourIndex] == INDEX_NONE)
+						{
+							HopCounts[NeighbourIndex] = HopCounts[NodeIndex] + 1;
+							Frontier.Add(NeighbourIndex);
+						}
+					}
+				}
+
+				for (int32 TargetIndex = 0; TargetIndex < NodeCount; ++TargetIndex)
+				{
+					const int32 Distance = Orientation == ETileOrientationFlag::FLAT
+						                       ? FGridHexFlatTopology::GetDistance(SourceIndex, TargetIndex, Params)
+						                       : FGridHexPointyTopology::GetDistance(SourceIndex, TargetIndex, Params);
+					const bool bMatches = Distance == HopCounts[TargetIndex] && MapModel->GetDistanceByIndex(SourceIndex, TargetIndex) == HopCounts[TargetIndex];
+					NumMismatches += bMatches ? 0 : 1;
+				}
+			}
+
+			TestEqual(FString::Printf(TEXT("%s %dx%d 距离与BFS步数不一致的格子对"), Orientation == ETileOrientationFlag::FLAT ? TEXT("Flat") : TEXT("Pointy"),
+			                          MapSize.X, MapSize.Y), NumMismatches, 0);
+
+			MapModel->RemoveFromRoot();
+			MapModel->MarkAsGarbage();
+		}
+	}
+
+	return !HasAnyErrors();
+}
+
+#if ENGINE_MAJOR_VERSION >= 5 && ENGINE_MINOR_VERSION >= 5
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FGridBidirectionalParityTest,
+	"GridPathFinding.PathFinding.BidirectionalParity",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter
+);
+#else
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FGridBidirectionalParityTest,
+	"GridPathFinding.PathFinding.BidirectionalParity",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter
+);
+#endif
+
+bool FGridBidirectionalParityTest::RunTest(const FString& Parameters)
+{
+	using namespace GridPathFindingTests;
+
+	for (const FMapCase& MapCase : GetMapCases())
+	{
+		const FString CaseName = MapCase.GetName();
+		UGridBenchmarkMapModel* MapModel = CreateMap(MapCase);
+		const TArray<FQuery> Queries = MakeQueries(*MapModel);
+
+		FGridPathFilter Filter(*MapModel);
+		Filter.SearchMode = EGridPathSearchMode::AStar;
+		const TArray<FAStarReference> References = FindAStarReferences(Filter, Queries);
+
+		// 双向A*与A*同样是最优的
+		FGridPathFilter BidirectionalFilter(*MapModel);
+		BidirectionalFilter.SearchMode = EGridPathSearchMode::Bidirectional;
+		for (int32 QueryIndex = 0; QueryIndex < Queries.Num(); ++QueryIndex)
+		{
+			const FQuery& Query = Queries[QueryIndex];
+			const FAStarReference& Reference = References[QueryIndex];
+			const FString QueryName = FString::Printf(TEXT("%s %d->%d 双向A*"), *CaseName, Query.StartIndex, Query.EndIndex);
+
+			TArray<int32> Path;
+			float PathCost = 0.f;
+			const bool bSuccess = MapModel->SearchPathIndices(BidirectionalFilter, Query.StartIndex, Query.EndIndex, Path, PathCost) == SearchSuccess;
+			TestEqual(QueryName + TEXT(" 可达性"), bSuccess, Reference.bSuccess);
+			if (bSuccess && Reference.bSuccess)
+			{
+				float PathEdgeCost = 0.f;
+				TestTrue(QueryName + TEXT(" 路径有效"), ValidatePath(Filter, Query, Path, PathEdgeCost));
+				TestEqual(QueryName + TEXT(" 路径Cost"), PathEdgeCost, Reference.Cost, CostTolerance);
+				TestEqual(QueryName + TEXT(" 返回Cost"), PathCost, Reference.Cost, CostTolerance);
+			}
+		}
+
+		DestroyMap(MapModel);
+	}
+
+	return !HasAnyErrors();
+}
+
+#if ENGINE_MAJOR_VERSION >= 5 && ENGINE_MINOR_VERSION >= 5
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FGridIncrementalReplanTest,
+	"GridPathFinding.PathFinding.IncrementalReplan",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter
+);
+#else
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FGridIncrementalReplanTest,
+	"GridPathFinding.PathFinding.IncrementalReplan",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter
+);
+#endif
+
+bool FGridIncrementalReplanTest::RunTest(const FString& Parameters)
+{
+	using namespace GridPathFindingTests;
+
+	for (const FMapCase& MapCase : GetMapCases())
+	{
+		const FString CaseName = MapCase.GetName();
+		UGridBenchmarkMapModel* MapModel = CreateMap(MapCase);
+		const TArray<FQuery> Queries = MakeQueries(*MapModel);
+
+		FGridPathFilter Filter(*MapModel);
+		Filter.SearchMode = EGridPathSearchMode::AStar;
+		const TArray<FAStarReference> References = FindAStarReferences(Filter, Queries);
+
+		// 首次规划与阻挡变化后的重规划都必须是最优的
+		FGridIncrementalPathPlanner Planner;
+		Planner.Initialize(*MapModel);
+		for (int32 QueryIndex = 0; QueryIndex < Queries.Num(); ++QueryIndex)
+		{
+			const FQuery& Query = Queries[QueryIndex];
+			const FAStarReference& Reference = References[QueryIndex];
+			const FString QueryName = FString::Printf(TEXT("%s %d->%d D* Lite"), *CaseName, Query.StartIndex, Query.EndIndex);
+
+			Planner.SetGoal(Query.EndIndex);
+			Planner.SetStart(Query.StartIndex);
+			const bool bSuccess = Planner.Replan() == SearchSuccess;
+			TestEqual(QueryName + TEXT(" 可达性"), bSuccess, Reference.bSuccess);
+			if (!bSuccess || !Reference.bSuccess)
+			{
+				continue;
+			}
+
+			TArray<int32> Path;
+			float PathEdgeCost = 0.f;
+			TestTrue(QueryName + TEXT(" 路径有效"), Planner.GetPath(Path) && ValidatePath(Filter, Query, Path, PathEdgeCost));
+			TestEqual(QueryName + TEXT(" 路径Cost"), PathEdgeCost, Reference.Cost, CostTolerance);
+			TestEqual(QueryName + TEXT(" 返回Cost"), Planner.GetPathCost(), Reference.Cost, CostTolerance);
+			if (Path.Num() < 3)
+			{
+				continue;
+			}
+
+			// 阻挡路径中间的格子后重规划， 与重新搜索的A*比较
+			const FHCubeCoord BlockedCoord = MapModel->StableGetCoordByIndex(Path[Path.Num() / 2]);
+			MapModel->BlockTileOnce(BlockedCoord);
+
+			FGridAStar Pathfinder;
+			TArray<int32> AStarPath;
+			const bool bAStarSuccess = Pathfinder.FindPath(Query.StartIndex, Query.EndIndex, Filter, AStarPath) == SearchSuccess;
+			const bool bReplanSuccess = Planner.Replan() == SearchSuccess;
+			TestEqual(QueryName + TEXT(" 重规划可达性"), bReplanSuccess, bAStarSuccess);
+			if (bReplanSuccess && bAStarSuccess)
+			{
+				TestTrue(QueryName + TEXT(" 重规划路径有效"), Planner.GetPath(Path) && ValidatePath(Filter, Query, Path, PathEdgeCost));
+				TestEqual(QueryName + TEXT(" 重规划路径Cost"), PathEdgeCost, Pathfinder.GetPathCost(), CostTolerance);
+				TestEqual(QueryName + TEXT(" 重规划返回Cost"), Planner.GetPathCost(), Pathfinder.GetPathCost(), CostTolerance);
+			}
+
+			MapModel->UnBlockTileOnce(BlockedCoord);
+		}
+		Planner.Release();
+
+		DestroyMap(MapModel);
+	}
+
+	return !HasAnyErrors();
+}
+
+#if ENGINE_MAJOR_VERSION >= 5 && ENGINE_MINOR_VERSION >= 5
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FGridHierarchicalParityTest,
+	"GridPathFinding.PathFinding.HierarchicalParity",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter
+);
+#else
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FGridHierarchicalParityTest,
+	"GridPathFinding.PathFinding.HierarchicalParity",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter
+);
+#endif
+
+bool FGridHierarchicalParityTest::RunTest(const FString& Parameters)
+{
+	using namespace GridPathFindingTests;
+
+	UGridPathFindingSettings* Settings = GetMutableDefault<UGridPathFindingSettings>();
+	const bool bOldEnableHierarchicalPathFinding = Settings->bEnableHierarchicalPathFinding;
+	const int32 OldHierarchicalPathFindingMinDistance = Settings->HierarchicalPathFindingMinDistance;
+
+	for (const FMapCase& MapCase : GetMapCases())
+	{
+		const FString CaseName = MapCase.GetName();
+		UGridBenchmarkMapModel* MapModel = CreateMap(MapCase);
+		const TArray<FQuery> Queries = MakeQueries(*MapModel);
+
+		FGridPathFilter Filter(*MapModel);
+		Filter.SearchMode = EGridPathSearchMode::AStar;
+		const TArray<FAStarReference> References = FindAStarReferences(Filter, Queries);
+
+		// 分层寻路只保证接近最优: 可达性与A*一致， 路径有效， Cost不低于最优Cost
+		Settings->bEnableHierarchicalPathFinding = true;
+		Settings->HierarchicalPathFindingMinDistance = 8;
+		int32 NumHierarchical = 0;
+		for (int32 QueryIndex = 0; QueryIndex < Queries.Num(); ++QueryIndex)
+		{
+			const FQuery& Query = Queries[QueryIndex];
+			const FAStarReference& Reference = References[QueryIndex];
+			const FString QueryName = FString::Printf(TEXT("%s %d->%d 分层寻路"), *CaseName, Query.StartIndex, Query.EndIndex);
+
+			TArray<int32> Path;
+			float PathCost = 0.f;
+			FGridPathQueryStats Stats;
+			const bool bSuccess = MapModel->SearchPathIndices(Filter, Query.StartIndex, Query.EndIndex, Path, PathCost, &Stats) == SearchSuccess;
+			TestEqual(QueryName + TEXT(" 可达性"), bSuccess, Reference.bSuccess);
+			if (!bSuccess || !Reference.bSuccess)
+			{
+				continue;
+			}
+
+			NumHierarchical += Stats.bHierarchical ? 1 : 0;
+			float PathEdgeCost = 0.f;
+			TestTrue(QueryName + TEXT(" 路径有效"), ValidatePath(Filter, Query, Path, PathEdgeCost));
+			TestEqual(QueryName + TEXT(" 返回Cost与路径一致"), PathCost, PathEdgeCost, CostTolerance);
+			TestTrue(QueryName + TEXT(" Cost不低于最优"), PathEdgeCost >= Reference.Cost - CostTolerance);
+		}
+		Settings->bEnableHierarchicalPathFinding = bOldEnableHierarchicalPathFinding;
+		Settings->HierarchicalPathFindingMinDistance = OldHierarchicalPathFindingMinDistance;
+
+		// 小地图只有一个Chunk， 不会走分层寻路
+		if (MapCase.MapSize >= 64)
+		{
+			TestTrue(FString::Printf(TEXT("%s 分层寻路被使用"), *CaseName), NumHierarchical > 0);
+		}
+
+		DestroyMap(MapModel);
+	}
+
+	return !HasAnyErrors();
+}
+
+#if ENGINE_MAJOR_VERSION >= 5 && ENGINE_MINOR_VERSION >= 5
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FGridFieldOfViewTest,
+	"GridPathFinding.PathFinding.FieldOfView",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter
+);
+#else
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FGridFieldOfViewTest,
+	"GridPathFinding.PathFinding.FieldOfView",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter
+);
+#endif
+
+bool FGridFieldOfViewTest::RunTest(const FString& Parameters)
+{
+	using namespace GridPathFindingTests;
+
+	// 视野缓存按插入顺序淘汰， 覆盖已有的Key不改变淘汰顺序
+	{
+		TGridFifoCache<int32, int32> FifoCache;
+		FifoCache.SetCapacity(3);
+		FifoCache.Add(1, 10);
+		FifoCache.Add(2, 20);
+		FifoCache.Add(3, 30);
+		FifoCache.Add(1, 11);
+		FifoCache.Add(4, 40);
+		TestNull(TEXT("FIFO 最早插入的Key被淘汰"), FifoCache.Find(1));
+		TestTrue(TEXT("FIFO 其余Key保留"), FifoCache.Find(2) && FifoCache.Find(3) && FifoCache.Find(4));
+		FifoCache.Add(5, 50);
+		TestNull(TEXT("FIFO 继续按插入顺序淘汰"), FifoCache.Find(2));
+		TestEqual(TEXT("FIFO 数量不超过容量"), FifoCache.Num(), 3);
+	}
+
+	constexpr int32 Radius = 6;
+	// 小于查询数量， 第二轮查询会经过淘汰后重新计算的路径
+	constexpr int32 CacheEntries = 8;
+
+	for (const FMapCase& MapCase : GetMapCases())
+	{
+		const FString CaseName = MapCase.GetName();
+		UGridBenchmarkMapModel* MapModel = CreateMap(MapCase);
+		const TArray<FQuery> Queries = MakeQueries(*MapModel);
+		const int32 NodeCount = MapModel->GetMaxValidIndex() + 1;
+
+		FGridFieldOfView UncachedFieldOfView;
+		UncachedFieldOfView.Build(*MapModel);
+		FGridFieldOfView CachedFieldOfView;
+		CachedFieldOfView.SetMaxCacheEntries(CacheEntries);
+		CachedFieldOfView.Build(*MapModel);
+
+		TArray<TArray<int32>> UncachedResults;
+		for (const FQuery& Query : Queries)
+		{
+			const int32 SourceIndex = Query.StartIndex;
+			const FString QueryName = FString::Printf(TEXT("%s %d 视野"), *CaseName, SourceIndex);
+
+			TArray<int32>& VisibleTiles = UncachedResults.AddDefaulted_GetRef();
+			UncachedFieldOfView.ComputeVisibleTiles(*MapModel, SourceIndex, Radius, VisibleTiles);
+			TestTrue(QueryName + TEXT(" 包含起点"), VisibleTiles.Contains(SourceIndex));
+
+			// 半径内HasLineOfSight与视野结果一致， 两端都不阻挡视线时结果对称
+			for (int32 TileIndex = 0; TileIndex < NodeCount; ++TileIndex)
+			{
+				if (MapModel->GetDistanceByIndex(SourceIndex, TileIndex) > Radius)
+				{
+					continue;
+				}
+
+				const bool bVisible = VisibleTiles.Contains(TileIndex);
+				if (UncachedFieldOfView.HasLineOfSight(*MapModel, SourceIndex, TileIndex) != bVisible)
+				{
+					AddError(FString::Printf(TEXT("%s HasLineOfSight与视野结果不一致: %d"), *QueryName, TileIndex));
+				}
+				if (bVisible && !UncachedFieldOfView.IsBlockingSight(TileIndex) &&
+					!UncachedFieldOfView.HasLineOfSight(*MapModel, TileIndex, SourceIndex))
+				{
+					AddError(FString::Printf(TEXT("%s 视线不对称: %d"), *QueryName, TileIndex));
+				}
+			}
+
+			TArray<int32> CachedTiles;
+			CachedFieldOfView.ComputeVisibleTiles(*MapModel, SourceIndex, Radius, CachedTiles);
+			TestTrue(QueryName + TEXT(" 首次缓存查询"), CachedTiles == VisibleTiles);
+			CachedFieldOfView.ComputeVisibleTiles(*MapModel, SourceIndex, Radius, CachedTiles);
+			TestTrue(QueryName + TEXT(" 命中缓存"), CachedTiles == VisibleTiles);
+		}
+
+		// 前面的结果大多已被淘汰， 重新计算后仍然一致
+		for (int32 QueryIndex = 0; QueryIndex < Queries.Num(); ++QueryIndex)
+		{
+			TArray<int32> CachedTiles;
+			CachedFieldOfView.ComputeVisibleTiles(*MapModel, Queries[QueryIndex].StartIndex, Radius, CachedTiles);
+			TestTrue(FString::Printf(TEXT("%s %d 淘汰后重新计算"), *CaseName, Queries[QueryIndex].StartIndex), CachedTiles == UncachedResults[QueryIndex]);
+		}
+
+		DestroyMap(MapModel);
+	}
+
+	return !HasAnyErrors();
+}
+
+#if ENGINE_MAJOR_VERSION >= 5 && ENGINE_MINOR_VERSION >= 5
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FGridTileStoreTest,
+	"GridPathFinding.PathFinding.TileStore",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter
+);
+#else
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FGridTileStoreTest,
+	"GridPathFinding.PathFinding.TileStore",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter
+);
+#endif
+
+bool FGridTileStoreTest::RunTest(const FString& Parameters)
+{
+	using namespace GridPathFindingTests;
+
+	// 列数据与原FTileInfo一致， 自定义数据被移动到TileStore中
+	constexpr int32 NodeCount = 64;
+	TArray<FTileInfo> Tiles;
+	for (int32 TileIndex = 0; TileIndex < NodeCount; ++TileIndex)
+	{
+		FTileInfo& TileInfo = Tiles.AddDefaulted_GetRef();
+		TileInfo.Cost = 1.f + TileIndex % 5;
+		TileInfo.Height = TileIndex % 7 * 10.f;
+		for (int32 Block = 0; Block < TileIndex % 3; ++Block)
+		{
+			TileInfo.AddBlockOnce();
+		}
+		if (TileIndex % 9 == 0)
+		{
+			TileInfo.CustomDataMap.Add(TEXT("Index"), FString::FromInt(TileIndex));
+		}
+	}
+	const TArray<FTileInfo> SourceTiles = Tiles;
+
+	FGridTileStore TileStore;
+	TileStore.Initialize(Tiles);
+	TestEqual(TEXT("格子数量"), TileStore.Num(), NodeCount);
+	for (int32 TileIndex = 0; TileIndex < NodeCount; ++TileIndex)
+	{
+		const FTileInfo& SourceTile = SourceTiles[TileIndex];
+		const FString TileName = FString::Printf(TEXT("格子%d"), TileIndex);
+		TestEqual(TileName + TEXT(" 阻挡计数"), TileStore.GetBlockCount(TileIndex), SourceTile.GetBlockCount());
+		TestEqual(TileName + TEXT(" 阻挡位"), TileStore.IsBlocked(TileIndex), SourceTile.IsBlocking());
+		TestEqual(TileName + TEXT(" Cost"), TileStore.GetCost(TileIndex), SourceTile.Cost);
+		TestEqual(TileName + TEXT(" 高度"), TileStore.GetHeight(TileIndex), SourceTile.Height);
+		TestEqual(TileName + TEXT(" 自定义数据已移出"), Tiles[TileIndex].CustomDataMap.Num(), 0);
+
+		FTileInfo FilledTile = Tiles[TileIndex];
+		TileStore.FillTileInfo(TileIndex, FilledTile);
+		TestEqual(TileName + TEXT(" 填充Cost"), FilledTile.Cost, SourceTile.Cost);
+		TestEqual(TileName + TEXT(" 填充高度"), FilledTile.Height, SourceTile.Height);
+		TestTrue(TileName + TEXT(" 填充自定义数据"), FilledTile.CustomDataMap.OrderIndependentCompareEqual(SourceTile.CustomDataMap));
+	}
+
+	// 阻挡计数不会小于0， 计数为0时阻挡位清除
+	TileStore.AddBlock(0);
+	TileStore.AddBlock(0);
+	TileStore.RemoveBlock(0);
+	TestTrue(TEXT("两次阻挡一次解除后仍阻挡"), TileStore.IsBlocked(0));
+	TileStore.RemoveBlock(0);
+	TileStore.RemoveBlock(0);
+	TestEqual(TEXT("阻挡计数不小于0"), TileStore.GetBlockCount(0), 0);
+	TestFalse(TEXT("计数为0时不阻挡"), TileStore.IsBlocked(0));
+	TestFalse(TEXT("无效Index不阻挡"), TileStore.IsBlocked(NodeCount));
+
+	// 通过地图接口修改时， 兼容视图与列数据同步更新
+	UGridBenchmarkMapModel* MapModel = CreateMap({ETileOrientationFlag::FLAT, 10, 0.f, 0.f});
+	const int32 TileIndex = 12;
+	const FHCubeCoord Coord = MapModel->StableGetCoordByIndex(TileIndex);
+	const FGridTileStore& MapTileStore = MapModel->GetTileStore();
+	FTileInfo TileInfo;
+
+	MapModel->BlockTileOnce(Coord);
+	MapModel->BlockTileOnce(Coord);
+	MapModel->UnBlockTileOnce(Coord);
+	TestTrue(TEXT("地图 TryGetTileInfo"), MapModel->TryGetTileInfo(Coord, TileInfo));
+	TestEqual(TEXT("地图 阻挡计数"), MapTileStore.GetBlockCount(TileIndex), TileInfo.GetBlockCount());
+	TestTrue(TEXT("地图 阻挡位"), MapTileStore.IsBlocked(TileIndex) && TileInfo.IsBlocking());
+	MapModel->UnBlockTileOnce(Coord);
+	TestFalse(TEXT("地图 解除阻挡"), MapTileStore.IsBlocked(TileIndex));
+
+	MapModel->UpdateTileHeight(Coord, 30.f, false);
+	TestTrue(TEXT("地图 TryGetTileInfo"), MapModel->TryGetTileInfo(Coord, TileInfo));
+	TestEqual(TEXT("地图 列数据高度"), MapTileStore.GetHeight(TileIndex), 30.f);
+	TestEqual(TEXT("地图 兼容视图高度"), TileInfo.Height, 30.f);
+
+	MapModel->SetTileCustomData(Coord, TEXT("Key"), TEXT("Value"));
+	TestEqual(TEXT("地图 自定义数据"), MapModel->GetTileCustomData(Coord, TEXT("Key")), FString(TEXT("Value")));
+	TestTrue(TEXT("地图 TryGetTileInfo"), MapModel->TryGetTileInfo(Coord, TileInfo));
+	TestTrue(TEXT("地图 TryGetTileInfo填充自定义数据"), TileInfo.CustomDataMap.Contains(TEXT("Key")));
+
+	DestroyMap(MapModel);
+
+	return !HasAnyErrors();
+}
+
+#if ENGINE_MAJOR_VERSION >= 5 && ENGINE_MINOR_VERSION >= 5
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FGridFlowFieldTest,
+	"GridPathFinding.PathFinding.FlowField",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter
+);
+#else
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FGridFlowFieldTest,
+	"GridPathFinding.PathFinding.FlowField",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter
+);
+#endif
+
+bool FGridFlowFieldTest::RunTest(const FString& Parameters)
+{
+	using namespace GridPathFindingTests;
+
+	for (const FMapCase& MapCase : GetMapCases())
+	{
+		const FString CaseName = MapCase.GetName();
+		UGridBenchmarkMapModel* MapModel = CreateMap(MapCase);
+		const TArray<FQuery> Queries = MakeQueries(*MapModel);
+
+		FGridPathFilter Filter(*MapModel);
+		Filter.SearchMode = EGridPathSearchMode::AStar;
+		const TArray<FAStarReference> References = FindAStarReferences(Filter, Queries);
+
+		// 流场中起点的距离与A*的最优Cost一致， 沿方向走到终点的路径有效且Cost相同
+		for (int32 QueryIndex = 0; QueryIndex < Queries.Num(); ++QueryIndex)
+		{
+			const FQuery& Query = Queries[QueryIndex];
+			const FAStarReference& Reference = References[QueryIndex];
+			const FString QueryName = FString::Printf(TEXT("%s %d->%d 流场"), *CaseName, Query.StartIndex, Query.EndIndex);
+
+			FGridFlowField FlowField;
+			MapModel->BuildFlowField(Query.EndIndex, Filter.Identifier, FlowField);
+			TestEqual(QueryName + TEXT(" 可达性"), FlowField.IsReachable(Query.StartIndex), Reference.bSuccess);
+			if (!Reference.bSuccess || !FlowField.IsReachable(Query.StartIndex))
+			{
+				continue;
+			}
+
+			TestEqual(QueryName + TEXT(" 距离"), FlowField.GetDistance(Query.StartIndex), Reference.Cost, CostTolerance);
+
+			TArray<int32> Path;
+			int32 CurrentIndex = Query.StartIndex;
+			while (CurrentIndex != Query.EndIndex && FlowField.GetDirection(CurrentIndex) != INDEX_NONE && Path.Num() <= Filter.GetNodeCount())
+			{
+				CurrentIndex = Filter.GetNeighbour(CurrentIndex, FlowField.GetDirection(CurrentIndex));
+				Path.Add(CurrentIndex);
+			}
+
+			float PathEdgeCost = 0.f;
+			TestTrue(QueryName + TEXT(" 沿方向到达终点"), ValidatePath(Filter, Query, Path, PathEdgeCost));
+			TestEqual(QueryName + TEXT(" 路径Cost"), PathEdgeCost, Reference.Cost, CostTolerance);
+		}
+
+		// 地图变化后只重建过期的流场， 重建结果与新的A*一致
+		const FQuery& Query = Queries[0];
+		TArray<FGridFlowField> FlowFields;
+		FlowFields.SetNum(2);
+		MapModel->BuildFlowField(Query.EndIndex, Filter.Identifier, FlowFields[0]);
+		TestEqual(CaseName + TEXT(" 未变化时不重建"), MapModel->RebuildStaleFlowFields(FlowFields), 0);
+
+		const FHCubeCoord BlockedCoord = MapModel->StableGetCoordByIndex(Query.StartIndex);
+		MapModel->BlockTileOnce(BlockedCoord);
+		MapModel->BuildFlowField(Query.StartIndex, Filter.Identifier, FlowFields[1]);
+		TestFalse(CaseName + TEXT(" 终点被阻挡时不可达"), FlowFields[1].IsReachable(Query.EndIndex));
+		MapModel->UnBlockTileOnce(BlockedCoord);
+		TestEqual(CaseName + TEXT(" 重建过期的流场"), MapModel->RebuildStaleFlowFields(FlowFields), 2);
+
+		FGridAStar Pathfinder;
+		TArray<int32> Path;
+		const bool bSuccess = Pathfinder.FindPath(Query.EndIndex, Query.StartIndex, Filter, Path) == SearchSuccess;
+		TestEqual(CaseName + TEXT(" 重建后可达性"), FlowFields[1].IsReachable(Query.EndIndex), bSuccess);
+		if (bSuccess)
+		{
+			TestEqual(CaseName + TEXT(" 重建后距离"), FlowFields[1].GetDistance(Query.EndIndex), Pathfinder.GetPathCost(), CostTolerance);
+		}
+
+		DestroyMap(MapModel);
+	}
+
+	return !HasAnyErrors();
+}
+
+#if ENGINE_MAJOR_VERSION >= 5 && ENGINE_MINOR_VERSION >= 5
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FGridReachableAreaTest,
+	"GridPathFinding.PathFinding.ReachableArea",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter
+);
+#else
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FGridReachableAreaTest,
+	"GridPathFinding.PathFinding.ReachableArea",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter
+);
+#endif
+
+bool FGridReachableAreaTest::RunTest(const FString& Parameters)
+{
+	using namespace GridPathFindingTests;
+
+	constexpr int32 NumAreaQueries = 8;
+
+	for (const FMapCase& MapCase : GetMapCases())
+	{
+		const FString CaseName = MapCase.GetName();
+		UGridBenchmarkMapModel* MapModel = CreateMap(MapCase);
+		const TArray<FQuery> Queries = MakeQueries(*MapModel);
+		const int32 NodeCount = MapModel->GetMaxValidIndex() + 1;
+
+		FGridPathFilter Filter(*MapModel);
+		Filter.SearchMode = EGridPathSearchMode::AStar;
+		// 每一步的Cost在[1, 1 + CostVariance)之间， 范围内大约有6步
+		const float MaxCost = 6.f * (1.f + MapCase.CostVariance * 0.5f);
+
+		for (int32 QueryIndex = 0; QueryIndex < NumAreaQueries; ++QueryIndex)
+		{
+			const int32 StartIndex = Queries[QueryIndex].StartIndex;
+			const FString QueryName = FString::Printf(TEXT("%s %d 移动范围"), *CaseName, StartIndex);
+
+			FGridReachableArea Area;
+			MapModel->FindReachableArea(StartIndex, Filter.Identifier, MaxCost, Area);
+			TestTrue(QueryName + TEXT(" 第一个是起点"), Area.Num() > 0 && Area.TileIndices[0] == StartIndex && Area.Costs[0] == 0.f);
+			for (int32 EntryIndex = 1; EntryIndex < Area.Num(); ++EntryIndex)
+			{
+				if (Area.Costs[EntryIndex] < Area.Costs[EntryIndex - 1])
+				{
+					AddError(FString::Printf(TEXT("%s Cost没有按升序排列: %d"), *QueryName, Area.TileIndices[EntryIndex]));
+				}
+			}
+
+			// 步数超过MaxCost的格子一定不可达， 其余格子与A*比较
+			for (int32 TileIndex = 0; TileIndex < NodeCount; ++TileIndex)
+			{
+				if (TileIndex == StartIndex)
+				{
+					continue;
+				}
+
+				if (MapModel->GetDistanceByIndex(StartIndex, TileIndex) > MaxCost)
+				{
+					if (Area.Contains(TileIndex))
+					{
+						AddError(FString::Printf(TEXT("%s 超出步数的格子在范围内: %d"), *QueryName, TileIndex));
+					}
+					continue;
+				}
+
+				const FQuery Query{StartIndex, TileIndex};
+				FGridAStar Pathfinder;
+				TArray<int32> Path;
+				const bool bSuccess = Pathfinder.FindPath(StartIndex, TileIndex, Filter, Path) == SearchSuccess;
+				const float ReferenceCost = bSuccess ? Pathfinder.GetPathCost() : MAX_flt;
+				if (FMath::IsNearlyEqual(ReferenceCost, MaxCost, CostTolerance))
+				{
+					// 正好在边界上的格子受浮点误差影响， 不做判断
+					continue;
+				}
+
+				const FString TileName = FString::Printf(TEXT("%s ->%d"), *QueryName, TileIndex);
+				TestEqual(TileName + TEXT(" 是否在范围内"), Area.Contains(TileIndex), ReferenceCost <= MaxCost);
+				if (!Area.Contains(TileIndex) || ReferenceCost > MaxCost)
+				{
+					continue;
+				}
+
+				TestEqual(TileName + TEXT(" Cost"), Area.GetCost(TileIndex), ReferenceCost, CostTolerance);
+				float PathEdgeCost = 0.f;
+				TestTrue(TileName + TEXT(" 路径有效"), Area.GetPathTo(TileIndex, Path) && ValidatePath(Filter, Query, Path, PathEdgeCost));
+				TestEqual(TileName + TEXT(" 路径Cost"), PathEdgeCost, ReferenceCost, CostTolerance);
+			}
+		}
+
+		DestroyMap(MapModel);
+	}
+
+	return !HasAnyErrors();
+}
+
+#if ENGINE_MAJOR_VERSION >= 5 && ENGINE_MINOR_VERSION >= 5
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FGridConnectivityTest,
+	"GridPathFinding.PathFinding.Connectivity",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter
+);
+#else
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FGridConnectivityTest,
+	"GridPathFinding.PathFinding.Connectivity",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter
+);
+#endif
+
+bool FGridConnectivityTest::RunTest(const FString& Parameters)
+{
+	using namespace GridPathFindingTests;
+
+	constexpr float BlockDensity = 0.3f;
+	constexpr int32 NumToggles = 128;
+
+	for (const FMapCase& MapCase : GetMapCases())
+	{
+		// 连通区域只看FTileInfo的阻挡计数， 阻挡由BlockTileOnce写入， 不使用随机生成的阻挡
+		if (MapCase.ObstacleDensity > 0.f || MapCase.CostVariance > 0.f)
+		{
+			continue;
+		}
+
+		const FString CaseName = MapCase.GetName();
+		UGridBenchmarkMapModel* MapModel = CreateMap(MapCase);
+		const int32 NodeCount = MapModel->GetMaxValidIndex() + 1;
+		const FGridTileStore& TileStore = MapModel->GetTileStore();
+		const FGridPathFilter Filter(*MapModel);
+
+		FRandomStream RandomStream(Seed);
+		for (int32 TileIndex = 0; TileIndex < NodeCount; ++TileIndex)
+		{
+			if (RandomStream.GetFraction() < BlockDensity)
+			{
+				MapModel->BlockTileOnce(MapModel->StableGetCoordByIndex(TileIndex));
+			}
+		}
+
+		// 与逐格BFS得到的划分比较: 同一BFS区域的格子ID相同， 不同区域的ID不同
+		auto TestComponents = [this, &CaseName, MapModel, NodeCount, &TileStore, &Filter](const FGridConnectivity& Connectivity, const FString& Step)
+		{
+			TArray<int32> ReferenceIds;
+			ReferenceIds.Init(INDEX_NONE, NodeCount);
+			int32 NumReferenceComponents = 0;
+			TArray<int32> Stack;
+			for (int32 SeedIndex = 0; SeedIndex < NodeCount; ++SeedIndex)
+			{
+				if (TileStore.IsBlocked(SeedIndex) || ReferenceIds[SeedIndex] != INDEX_NONE)
+				{
+					continue;
+				}
+
+				ReferenceIds[SeedIndex] = NumReferenceComponents;
+				Stack.Add(SeedIndex);
+				while (Stack.Num() > 0)
+				{
+					const int32 CurrentIndex = Stack.Pop(EAllowShrinking::No);
+					for (int32 Direction = 0; Direction < Filter.GetNeighbourCount(); ++Direction)
+					{
+						const int32 NeighbourIndex = Filter.GetNeighbour(CurrentIndex, Direction);
+						if (NeighbourIndex != INDEX_NONE && !TileStore.IsBlocked(NeighbourIndex) && ReferenceIds[NeighbourIndex] == INDEX_NONE)
+						{
+							ReferenceIds[NeighbourIndex] = NumReferenceComponents;
+							Stack.Add(NeighbourIndex);
+						}
+					}
+				}
+				++NumReferenceComponents;
+			}
+
+			TestEqual(FString::Printf(TEXT("%s %s 连通区域数量"), *CaseName, *Step), Connectivity.GetNumComponents(), NumReferenceComponents);
+
+			TMap<int32, int32> ReferenceToId;
+			TMap<int32, int32> IdToReference;
+			for (int32 TileIndex = 0; TileIndex < NodeCount; ++TileIndex)
+			{
+				const int32 ReferenceId = ReferenceIds[TileIndex];
+				const int32 ComponentId = Connectivity.GetComponentId(TileIndex);
+				bool bMatches = ComponentId == INDEX_NONE;
+				if (ReferenceId != INDEX_NONE && ComponentId != INDEX_NONE)
+				{
+					bMatches = ReferenceToId.FindOrAdd(ReferenceId, ComponentId) == ComponentId &&
+						IdToReference.FindOrAdd(ComponentId, ReferenceId) == ReferenceId;
+				}
+				else if (ReferenceId != INDEX_NONE)
+				{
+					bMatches = false;
+				}
+				if (!bMatches)
+				{
+					AddError(FString::Printf(TEXT("%s %s 格子%d的连通区域与BFS不一致"), *CaseName, *Step, TileIndex));
+					return;
+				}
+			}
+		};
+
+		FGridConnectivity Connectivity;
+		Connectivity.Build(*MapModel);
+		TestComponents(Connectivity, TEXT("Build"));
+
+		// 逐个切换格子的阻挡状态， 增量更新后的划分与重新BFS一致
+		for (int32 Toggle = 0; Toggle < NumToggles; ++Toggle)
+		{
+			const int32 TileIndex = RandomStream.RandRange(0, NodeCount - 1);
+			const FHCubeCoord Coord = MapModel->StableGetCoordByIndex(TileIndex);
+			const bool bBlock = !TileStore.IsBlocked(TileIndex);
+			if (bBlock)
+			{
+				MapModel->BlockTileOnce(Coord);
+			}
+			else
+			{
+				MapModel->UnBlockTileOnce(Coord);
+			}
+			Connectivity.UpdateTile(*MapModel, TileIndex);
+			TestComponents(Connectivity, FString::Printf(TEXT("%s %d"), bBlock ? TEXT("阻挡") : TEXT("解除阻挡"), TileIndex));
+		}
+
+		// AreConnected与A*的可达性一致
+		for (const FQuery& Query : MakeQueries(*MapModel))
+		{
+			if (TileStore.IsBlocked(Query.StartIndex))
+			{
+				continue;
+			}
+
+			FGridAStar Pathfinder;
+			TArray<int32> Path;
+			const bool bSuccess = Pathfinder.FindPath(Query.StartIndex, Query.EndIndex, Filter, Path) == SearchSuccess;
+			TestEqual(FString::Printf(TEXT("%s %d->%d AreConnected"), *CaseName, Query.StartIndex, Query.EndIndex),
+			          Connectivity.AreConnected(*MapModel, Query.StartIndex, Query.EndIndex), bSuccess);
+		}
+
+		DestroyMap(MapModel);
+	}
+
+	return !HasAnyErrors();
+}
+
+#if ENGINE_MAJOR_VERSION >= 5 && ENGINE_MINOR_VERSION >= 5
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FGridLandmarksTest,
+	"GridPathFinding.PathFinding.Landmarks",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter
+);
+#else
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FGridLandmarksTest,
+	"GridPathFinding.PathFinding.Landmarks",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter
+);
+#endif
+
+bool FGridLandmarksTest::RunTest(const FString& Parameters)
+{
+	using namespace GridPathFindingTests;
+
+	constexpr int32 MemoryBudgetKB = 1024;
+	constexpr int32 MaxLandmarkCount = 8;
+	constexpr int32 NumChangedTiles = 16;
+
+	for (const FMapCase& MapCase : GetMapCases())
+	{
+		const FString CaseName = MapCase.GetName();
+		UGridBenchmarkMapModel* MapModel = CreateMap(MapCase);
+		const TArray<FQuery> Queries = MakeQueries(*MapModel);
+
+		FGridPathFilter Filter(*MapModel);
+		Filter.SearchMode = EGridPathSearchMode::AStar;
+		// 参照结果只使用六边形距离， 不使用地图自身的路标
+		Filter.Landmarks = nullptr;
+
+		// 先阻挡一部分格子再构建路标， 解除阻挡后Cost下降， 需要增量修复
+		TArray<FHCubeCoord> ChangedCoords;
+		FRandomStream RandomStream(Seed);
+		for (int32 Change = 0; Change < NumChangedTiles; ++Change)
+		{
+			const FHCubeCoord Coord = MapModel->StableGetCoordByIndex(RandomStream.RandRange(0, MapModel->GetMaxValidIndex()));
+			MapModel->BlockTileOnce(Coord);
+			ChangedCoords.Add(Coord);
+		}
+
+		FGridLandmarks Landmarks;
+		Landmarks.Build(*MapModel, MemoryBudgetKB, MaxLandmarkCount, Filter.Identifier);
+		TestTrue(CaseName + TEXT(" 路标已构建"), Landmarks.IsBuilt());
+
+		// 下界不高估， 使用路标下界的A*仍然是最优的
+		auto TestLandmarks = [this, &CaseName, &Queries, &Filter, &Landmarks](const FString& Step)
+		{
+			const TArray<FAStarReference> References = FindAStarReferences(Filter, Queries);
+			FGridPathFilter LandmarkFilter = Filter;
+			LandmarkFilter.Landmarks = &Landmarks;
+			for (int32 QueryIndex = 0; QueryIndex < Queries.Num(); ++QueryIndex)
+			{
+				const FQuery& Query = Queries[QueryIndex];
+				const FAStarReference& Reference = References[QueryIndex];
+				const FString QueryName = FString::Printf(TEXT("%s %s %d->%d ALT"), *CaseName, *Step, Query.StartIndex, Query.EndIndex);
+
+				FGridAStar Pathfinder;
+				TArray<int32> Path;
+				const bool bSuccess = Pathfinder.FindPath(Query.StartIndex, Query.EndIndex, LandmarkFilter, Path) == SearchSuccess;
+				TestEqual(QueryName + TEXT(" 可达性"), bSuccess, Reference.bSuccess);
+				if (!bSuccess || !Reference.bSuccess)
+				{
+					continue;
+				}
+
+				TestTrue(QueryName + TEXT(" 下界不高估"), Landmarks.GetLowerBound(Query.StartIndex, Query.EndIndex) <= Reference.Cost + CostTolerance);
+				float PathEdgeCost = 0.f;
+				TestTrue(QueryName + TEXT(" 路径有效"), ValidatePath(Filter, Query, Path, PathEdgeCost));
+				TestEqual(QueryName + TEXT(" 路径Cost"), PathEdgeCost, Reference.Cost, CostTolerance);
+			}
+		};
+
+		TestLandmarks(TEXT("Build"));
+
+		for (const FHCubeCoord& Coord : ChangedCoords)
+		{
+			MapModel->UnBlockTileOnce(Coord);
+			Landmarks.UpdateTile(MapModel->StableGetFullMapGridIterIndex(Coord));
+		}
+		TestTrue(CaseName + TEXT(" 记录了待修复的格子"), Landmarks.HasPendingRepairs());
+		Landmarks.FlushPendingRepairs(*MapModel);
+		TestFalse(CaseName + TEXT(" 修复完成"), Landmarks.HasPendingRepairs());
+		TestLandmarks(TEXT("Repair"));
+
+		DestroyMap(MapModel);
+	}
+
+	return !HasAnyErrors();
+}
+
+#if ENGINE_MAJOR_VERSION >= 5 && ENGINE_MINOR_VERSION >= 5
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FGridCostLayersTest,
+	"GridPathFinding.PathFinding.CostLayers",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter
+);
+#else
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FGridCostLayersTest,
+	"GridPathFinding.PathFinding.CostLayers",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter
+);
+#endif
+
+bool FGridCostLayersTest::RunTest(const FString& Parameters)
+{
+	using namespace GridPathFindingTests;
+
+	// 设置中的CostLayerIdentifiers不会包含这个身份标识
+	constexpr int32 Identifier = 7301;
+
+	for (const FMapCase& MapCase : GetMapCases())
+	{
+		const FString CaseName = MapCase.GetName();
+		UGridBenchmarkMapModel* MapModel = CreateMap(MapCase);
+		const TArray<FQuery> Queries = MakeQueries(*MapModel);
+		const int32 NodeCount = MapModel->GetMaxValidIndex() + 1;
+
+		FGridPathFilter Filter(*MapModel);
+		Filter.Identifier = Identifier;
+		Filter.SearchMode = EGridPathSearchMode::AStar;
+		TestNull(CaseName + TEXT(" 构建前没有Cost表"), MapModel->GetCostLayers().FindLayer(Identifier));
+		const TArray<FAStarReference> References = FindAStarReferences(Filter, Queries);
+
+		// Cost表的每一项与逐条边调用CanTravelTo、GetTraversalCost的结果相同
+		auto TestLayer = [this, &CaseName, MapModel, NodeCount](const FString& Step)
+		{
+			const float* CostLayer = MapModel->GetCostLayers().FindLayer(Identifier);
+			if (CostLayer == nullptr)
+			{
+				AddError(FString::Printf(TEXT("%s %s 没有Cost表"), *CaseName, *Step));
+				return;
+			}
+
+			for (int32 TileIndex = 0; TileIndex < NodeCount; ++TileIndex)
+			{
+				for (int32 Direction = 0; Direction < FGridCostLayers::NumDirections; ++Direction)
+				{
+					const int32 NeighbourIndex = MapModel->GetNeighborIndex(TileIndex, Direction);
+					float ExpectedCost = MAX_flt;
+					if (NeighbourIndex != INDEX_NONE && MapModel->CanTravelTo(TileIndex, NeighbourIndex))
+					{
+						ExpectedCost = static_cast<float>(1.0 + MapModel->GetTraversalCost(Identifier, TileIndex, NeighbourIndex));
+					}
+					if (CostLayer[TileIndex * FGridCostLayers::NumDirections + Direction] != ExpectedCost)
+					{
+						AddError(FString::Printf(TEXT("%s %s 格子%d方向%d的Cost与回调不一致"), *CaseName, *Step, TileIndex, Direction));
+						return;
+					}
+				}
+			}
+		};
+
+		MapModel->BuildCostLayer(Identifier);
+		TestLayer(TEXT("Build"));
+
+		// 读取Cost表的A*与逐条边回调的结果相同， 构建前创建的Filter已经缓存了空的Cost表， 需要重新创建
+		FGridPathFilter LayerFilter(*MapModel);
+		LayerFilter.Identifier = Identifier;
+		LayerFilter.SearchMode = EGridPathSearchMode::AStar;
+		for (int32 QueryIndex = 0; QueryIndex < Queries.Num(); ++QueryIndex)
+		{
+			const FQuery& Query = Queries[QueryIndex];
+			const FAStarReference& Reference = References[QueryIndex];
+			const FString QueryName = FString::Printf(TEXT("%s %d->%d Cost表"), *CaseName, Query.StartIndex, Query.EndIndex);
+
+			FGridAStar Pathfinder;
+			TArray<int32> Path;
+			const bool bSuccess = Pathfinder.FindPath(Query.StartIndex, Query.EndIndex, LayerFilter, Path) == SearchSuccess;
+			TestEqual(QueryName + TEXT(" 可达性"), bSuccess, Reference.bSuccess);
+			if (bSuccess && Reference.bSuccess)
+			{
+				float PathEdgeCost = 0.f;
+				TestTrue(QueryName + TEXT(" 路径有效"), ValidatePath(LayerFilter, Query, Path, PathEdgeCost));
+				TestEqual(QueryName + TEXT(" 路径Cost"), PathEdgeCost, Reference.Cost, CostTolerance);
+			}
+		}
+
+		// 格子变化后只更新该格子与相邻格子， 更新后的表仍与回调一致
+		const FHCubeCoord ChangedCoord = MapModel->StableGetCoordByIndex(Queries[0].StartIndex);
+		MapModel->BlockTileOnce(ChangedCoord);
+		TestLayer(TEXT("阻挡后"));
+		MapModel->UnBlockTileOnce(ChangedCoord);
+		TestLayer(TEXT("解除阻挡后"));
+
+		DestroyMap(MapModel);
+	}
+
+	return !HasAnyErrors();
+}
+
+#if ENGINE_MAJOR_VERSION >= 5 && ENGINE_MINOR_VERSION >= 5
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FGridCooperativePathFindingTest,
+	"GridPathFinding.PathFinding.CooperativePathFinding",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter
+);
+#else
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FGridCooperativePathFindingTest,
+	"GridPathFinding.PathFinding.CooperativePathFinding",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter
+);
+#endif
+
+bool FGridCooperativePathFindingTest::RunTest(const FString& Parameters)
+{
+	using namespace GridPathFindingTests;
+
+	constexpr int32 NumAgents = 12;
+	constexpr int32 WindowSize = 16;
+	constexpr int32 NumRounds = 4;
+
+	for (const FMapCase& MapCase : GetMapCases())
+	{
+		const FString CaseName = MapCase.GetName();
+		UGridBenchmarkMapModel* MapModel = CreateMap(MapCase);
+		const FGridPathFilter Filter(*MapModel);
+
+		// 起点互不相同、终点互不相同
+		TArray<FGridCooperativeAgent> Agents;
+		TSet<int32> UsedStarts;
+		TSet<int32> UsedGoals;
+		for (const FQuery& Query : MakeQueries(*MapModel))
+		{
+			if (Agents.Num() < NumAgents && !UsedStarts.Contains(Query.StartIndex) && !UsedGoals.Contains(Query.EndIndex))
+			{
+				FGridCooperativeAgent& Agent = Agents.AddDefaulted_GetRef();
+				Agent.AgentId = Agents.Num() - 1;
+				Agent.StartIndex = Query.StartIndex;
+				Agent.GoalIndex = Query.EndIndex;
+				UsedStarts.Add(Query.StartIndex);
+				UsedGoals.Add(Query.EndIndex);
+			}
+		}
+
+		FGridCooperativePathFinder PathFinder;
+		PathFinder.Initialize(*MapModel, WindowSize);
+
+		int32 CurrentTimeStep = 0;
+		for (int32 Round = 0; Round < NumRounds; ++Round)
+		{
+			const FString RoundName = FString::Printf(TEXT("%s 第%d轮"), *CaseName, Round);
+			PathFinder.PlanPaths(Agents, CurrentTimeStep);
+
+			// [AgentIndex][Step] 窗口内每个时间步所在的格子
+			// 没有规划出路径的单位原地等待， 可能与其他单位冲突， 不参与检查； 已经停在终点的单位路径为空
+			TArray<TArray<int32>> Positions;
+			bool bAllPlanned = true;
+			for (const FGridCooperativeAgent& Agent : Agents)
+			{
+				const FString AgentName = FString::Printf(TEXT("%s 单位%d"), *RoundName, Agent.AgentId);
+				TArray<int32>& AgentPositions = Positions.AddDefaulted_GetRef();
+				if (Agent.PlannedTiles.Num() == 0 && !Agent.bReachesGoal)
+				{
+					bAllPlanned = false;
+					continue;
+				}
+
+				AgentPositions.Add(Agent.StartIndex);
+				for (int32 Step = 1; Step <= WindowSize; ++Step)
+				{
+					AgentPositions.Add(Agent.PlannedTiles.IsValidIndex(Step - 1) ? Agent.PlannedTiles[Step - 1] : AgentPositions.Last());
+				}
+
+				for (int32 Step = 1; Step <= WindowSize; ++Step)
+				{
+					const int32 FromIndex = AgentPositions[Step - 1];
+					const int32 ToIndex = AgentPositions[Step];
+					int32 Direction = 0;
+					while (Direction < Filter.GetNeighbourCount() && Filter.GetNeighbour(FromIndex, Direction) != ToIndex)
+					{
+						++Direction;
+					}
+
+					FVector::FReal EdgeCost = 0.0;
+					if (FromIndex != ToIndex && (Direction == Filter.GetNeighbourCount() || !Filter.TryGetEdgeCost(FromIndex, Direction, ToIndex, EdgeCost)))
+					{
+						AddError(FString::Printf(TEXT("%s 第%d步不是可通行的相邻格子: %d->%d"), *AgentName, Step, FromIndex, ToIndex));
+					}
+					if (PathFinder.GetReservationTable().GetReservedAgent(ToIndex, CurrentTimeStep + Step) != Agent.AgentId)
+					{
+						AddError(FString::Printf(TEXT("%s 第%d步没有预约格子%d"), *AgentName, Step, ToIndex));
+					}
+				}
+
+				if (Agent.bReachesGoal)
+				{
+					TestEqual(AgentName + TEXT(" 到达终点后停在终点"), AgentPositions.Last(), Agent.GoalIndex);
+				}
+			}
+
+			// 同一时间步不在同一格子， 相邻两步不互换位置
+			for (int32 AgentA = 0; AgentA < Agents.Num(); ++AgentA)
+			{
+				for (int32 AgentB = AgentA + 1; AgentB < Agents.Num(); ++AgentB)
+				{
+					const TArray<int32>& PositionsA = Positions[AgentA];
+					const TArray<int32>& PositionsB = Positions[AgentB];
+					if (PositionsA.Num() == 0 || PositionsB.Num() == 0)
+					{
+						continue;
+					}
+
+					for (int32 Step = 0; Step <= WindowSize; ++Step)
+					{
+						if (PositionsA[Step] == PositionsB[Step])
+						{
+							AddError(FString::Printf(TEXT("%s 单位%d与单位%d在第%d步位于同一格子%d"), *RoundName, AgentA, AgentB, Step, PositionsA[Step]));
+						}
+						if (Step < WindowSize && PositionsA[Step] != PositionsA[Step + 1] &&
+							PositionsA[Step] == PositionsB[Step + 1] && PositionsA[Step + 1] == PositionsB[Step])
+						{
+							AddError(FString::Printf(TEXT("%s 单位%d与单位%d在第%d步互换位置"), *RoundName, AgentA, AgentB, Step));
+						}
+					}
+				}
+			}
+
+			if (!bAllPlanned)
+			{
+				// 原地等待的单位之后可能与其他单位重叠， 不再继续模拟
+				break;
+			}
+
+			// 走完半个窗口后重新规划
+			CurrentTimeStep += WindowSize / 2;
+			for (int32 AgentIndex = 0; AgentIndex < Agents.Num(); ++AgentIndex)
+			{
+				Agents[AgentIndex].StartIndex = Positions[AgentIndex][WindowSize / 2];
+			}
+		}
+
+		DestroyMap(MapModel);
+	}
+
+	return !HasAnyErrors();
+}
+
+#if ENGINE_MAJOR_VERSION >= 5 && ENGINE_MINOR_VERSION >= 5
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FGridNearestGoalTest,
+	"GridPathFinding.PathFinding.NearestGoal",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter
+);
+#else
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FGridNearestGoalTest,
+	"GridPathFinding.PathFinding.NearestGoal",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter
+);
+#endif
+
+bool FGridNearestGoalTest::RunTest(const FString& Parameters)
+{
+	using namespace GridPathFindingTests;
+
+	constexpr int32 NumNearestGoalQueries = 16;
+	// 超过MaxGoalsForHeuristic时退化为Dijkstra， 两种情况都要覆盖
+	const int32 GoalCounts[] = {1, 4, UGridMapModel::MaxGoalsForHeuristic + 8};
+
+	for (const FMapCase& MapCase : GetMapCases())
+	{
+		const FString CaseName = MapCase.GetName();
+		UGridBenchmarkMapModel* MapModel = CreateMap(MapCase);
+		const TArray<FQuery> Queries = MakeQueries(*MapModel);
+		const int32 NodeCount = MapModel->GetMaxValidIndex() + 1;
+
+		FGridPathFilter Filter(*MapModel);
+		Filter.SearchMode = EGridPathSearchMode::AStar;
+
+		FRandomStream RandomStream(Seed);
+		for (int32 QueryIndex = 0; QueryIndex < NumNearestGoalQueries; ++QueryIndex)
+		{
+			const int32 StartIndex = Queries[QueryIndex].StartIndex;
+			for (const int32 GoalCount : GoalCounts)
+			{
+				const FString QueryName = FString::Printf(TEXT("%s %d 最近的%d个终点之一"), *CaseName, StartIndex, GoalCount);
+
+				// 终点可能被阻挡或重复， 参照结果为逐个终点A*的最小Cost
+				TArray<int32> Goals;
+				TMap<int32, float> GoalCosts;
+				float ReferenceCost = MAX_flt;
+				while (Goals.Num() < GoalCount)
+				{
+					const int32 TileIndex = RandomStream.RandRange(0, NodeCount - 1);
+					if (TileIndex == StartIndex)
+					{
+						continue;
+					}
+					Goals.Add(TileIndex);
+
+					FGridAStar Pathfinder;
+					TArray<int32> Path;
+					if (Pathfinder.FindPath(StartIndex, TileIndex, Filter, Path) == SearchSuccess)
+					{
+						GoalCosts.Add(TileIndex, Pathfinder.GetPathCost());
+						ReferenceCost = FMath::Min(ReferenceCost, Pathfinder.GetPathCost());
+					}
+				}
+
+				int32 ReachedGoal = INDEX_NONE;
+				TArray<int32> Path;
+				float PathCost = 0.f;
+				const bool bSuccess = MapModel->FindPathToNearestGoal(StartIndex, Goals, Filter.Identifier, ReachedGoal, Path, PathCost) == SearchSuccess;
+				TestEqual(QueryName + TEXT(" 可达性"), bSuccess, GoalCosts.Num() > 0);
+				if (!bSuccess || GoalCosts.Num() == 0)
+				{
+					continue;
+				}
+
+				TestEqual(QueryName + TEXT(" Cost为最小值"), PathCost, ReferenceCost, CostTolerance);
+				const float* ReachedGoalCost = GoalCosts.Find(ReachedGoal);
+				TestTrue(QueryName + TEXT(" 到达的终点在终点列表中且Cost最小"),
+				         ReachedGoalCost && FMath::IsNearlyEqual(*ReachedGoalCost, ReferenceCost, CostTolerance));
+
+				const FQuery Query{StartIndex, ReachedGoal};
+				float PathEdgeCost = 0.f;
+				TestTrue(QueryName + TEXT(" 路径有效"), ValidatePath(Filter, Query, Path, PathEdgeCost));
+				TestEqual(QueryName + TEXT(" 路径Cost"), PathEdgeCost, ReferenceCost, CostTolerance);
+			}
+		}
+
+		DestroyMap(MapModel);
+	}
+
+	return !HasAnyErrors();
+}
+
+#if ENGINE_MAJOR_VERSION >= 5 && ENGINE_MINOR_VERSION >= 5
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FGridPathPointsTest,
+	"GridPathFinding.PathFinding.PathPoints",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter
+);
+#else
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FGridPathPointsTest,
+	"GridPathFinding.PathFinding.PathPoints",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter
+);
+#endif
+
+bool FGridPathPointsTest::RunTest(const FString& Parameters)
+{
+	using namespace GridPathFindingTests;
+
+	constexpr float ZOffset = 10.f;
+	constexpr float RaisedHeight = 50.f;
+
+	for (const ETileOrientationFlag Orientation : {ETileOrientationFlag::FLAT, ETileOrientationFlag::POINTY})
+	{
+		UGridBenchmarkMapModel* MapModel = CreateMap({Orientation, 10, 0.f, 0.f});
+		const FString CaseName = Orientation == ETileOrientationFlag::FLAT ? TEXT("Flat") : TEXT("Pointy");
+		const int32 StartIndex = MapModel->StableGetFullMapGridIterIndex(FHCubeCoord(0, 0, 0));
+		if (!TestTrue(CaseName + TEXT(" 地图中心"), StartIndex != INDEX_NONE))
+		{
+			DestroyMap(MapModel);
+			continue;
+		}
+
+		// 从起点依次沿Directions走一步得到的格子路径
+		auto MakePath = [this, MapModel, StartIndex](std::initializer_list<int32> Directions)
+		{
+			TArray<int32> PathIndices;
+			int32 TileIndex = StartIndex;
+			for (const int32 Direction : Directions)
+			{
+				TileIndex = MapModel->GetNeighborIndex(TileIndex, Direction);
+				TestTrue(TEXT("路径格子在地图内"), TileIndex != INDEX_NONE);
+				PathIndices.Add(TileIndex);
+			}
+			return PathIndices;
+		};
+
+		// 路径点依次位于Expected中的格子上
+		auto TestPathPoints = [this, MapModel, StartIndex](const FString& What, const TArray<int32>& PathIndices, bool bMerge, const TArray<int32>& Expected)
+		{
+			TArray<FNavPathPoint> PathPoints;
+			AGridPathFindingNavMesh::AppendPathPoints(*MapModel, StartIndex, PathIndices, bMerge, ZOffset, PathPoints);
+			if (!TestEqual(What + TEXT(" 路径点数量"), PathPoints.Num(), Expected.Num()))
+			{
+				return;
+			}
+
+			for (int32 PointIndex = 0; PointIndex < Expected.Num(); ++PointIndex)
+			{
+				const FVector ExpectedLocation = MapModel->StableCoordToWorld(MapModel->StableGetCoordByIndex(Expected[PointIndex]), false) + FVector(0.f, 0.f, ZOffset);
+				TestEqual(FString::Printf(TEXT("%s 第%d个路径点"), *What, PointIndex), PathPoints[PointIndex].Location, ExpectedLocation);
+			}
+		};
+
+		// 直线: 不合并时每个格子一个路径点， 合并后只保留终点
+		const TArray<int32> StraightPath = MakePath({0, 0, 0, 0});
+		TestPathPoints(CaseName + TEXT(" 直线不合并"), StraightPath, false, StraightPath);
+		TestPathPoints(CaseName + TEXT(" 直线合并"), StraightPath, true, {StraightPath.Last()});
+
+		// 转弯: 保留拐点与终点
+		const TArray<int32> TurnPath = MakePath({0, 0, 1, 1});
+		TestPathPoints(CaseName + TEXT(" 转弯合并"), TurnPath, true, {TurnPath[1], TurnPath.Last()});
+
+		// 高度变化: 与抬高的格子相邻的格子都不能合并， 路径点带有格子高度
+		const FHCubeCoord RaisedCoord = MapModel->StableGetCoordByIndex(StraightPath[1]);
+		MapModel->UpdateTileHeight(RaisedCoord, RaisedHeight, false);
+		TestPathPoints(CaseName + TEXT(" 高度变化合并"), StraightPath, true, StraightPath);
+		MapModel->UpdateTileHeight(RaisedCoord, 0.f, false);
+
+		// 空路径不生成路径点
+		TestPathPoints(CaseName + TEXT(" 空路径"), {}, true, {});
+
+		DestroyMap(MapModel);
+	}
+
+	return !HasAnyErrors();
+}